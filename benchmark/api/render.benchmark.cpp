@@ -7,12 +7,15 @@
 #include <mbgl/renderer/renderer.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/image.hpp>
+#include <mbgl/style/layer.hpp>
 #include <mbgl/storage/resource_options.hpp>
 #include <mbgl/storage/network_status.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <algorithm>
+
 using namespace mbgl;
 
 namespace {
@@ -66,6 +69,40 @@ static void API_renderStill_reuse_map_formatted_labels(::benchmark::State& state
     }
 }
 
+static void API_renderStill_reuse_map_pitched_line_labels(::benchmark::State& state) {
+    RenderBenchmark bench;
+    HeadlessFrontend frontend { size, pixelRatio };
+    Map map { frontend, MapObserver::nullObserver(),
+              MapOptions().withMapMode(MapMode::Static).withSize(size).withPixelRatio(pixelRatio),
+              ResourceOptions().withCachePath(cachePath).withAccessToken("foobar") };
+    prepare(map);
+    // Along-line labels are reprojected on the CPU; a pitched, rotated camera makes that the dominant cost.
+    map.jumpTo(CameraOptions().withPitch(60.0).withBearing(30.0));
+
+    while (state.KeepRunning()) {
+        frontend.render(map);
+    }
+}
+
+static void API_renderStill_reuse_map_100_layers(::benchmark::State& state) {
+    RenderBenchmark bench;
+    HeadlessFrontend frontend { size, pixelRatio };
+    Map map { frontend, MapObserver::nullObserver(),
+              MapOptions().withMapMode(MapMode::Static).withSize(size).withPixelRatio(pixelRatio),
+              ResourceOptions().withCachePath(cachePath).withAccessToken("foobar") };
+    prepare(map);
+    // The bottom 100 layers are nearly all fills and lines, many of them sharing buckets, so the
+    // frame time is dominated by issuing draw calls rather than by symbol placement.
+    const auto layers = map.getStyle().getLayers();
+    for (auto it = layers.begin() + std::min<size_t>(layers.size(), 100); it != layers.end(); ++it) {
+        map.getStyle().removeLayer((*it)->getID());
+    }
+
+    while (state.KeepRunning()) {
+        frontend.render(map);
+    }
+}
+
 static void API_renderStill_reuse_map_switch_styles(::benchmark::State& state) {
     RenderBenchmark bench;
     HeadlessFrontend frontend { size, pixelRatio };
@@ -96,5 +133,7 @@ static void API_renderStill_recreate_map(::benchmark::State& state) {
 
 BENCHMARK(API_renderStill_reuse_map);
 BENCHMARK(API_renderStill_reuse_map_formatted_labels);
+BENCHMARK(API_renderStill_reuse_map_pitched_line_labels);
+BENCHMARK(API_renderStill_reuse_map_100_layers);
 BENCHMARK(API_renderStill_reuse_map_switch_styles);
 BENCHMARK(API_renderStill_recreate_map);
@@ -58,10 +58,31 @@ static void Evaluate_CompositeFunction(benchmark::State& state) {
     state.SetLabel(std::to_string(stopCount).c_str());
 }
 
+// Same as Evaluate_CompositeFunction, but evaluating the expression tree instead of its compiled form.
+static void Evaluate_CompositeFunctionTree(benchmark::State& state) {
+    size_t stopCount = state.range(0);
+    auto doc = createFunctionJSON(stopCount);
+    conversion::Error error;
+    optional<PropertyValue<float>> function = conversion::convertJSON<PropertyValue<float>>(doc, error, true, false);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+    const expression::Expression& tree = function->asExpression().getExpression();
+
+    while(state.KeepRunning()) {
+        float z = 24.0f * static_cast<float>(rand() % 100) / 100;
+        StubGeometryTileFeature feature(PropertyMap { { "x", static_cast<int64_t>(rand() % 100) } });
+        tree.evaluate(expression::EvaluationContext(z, &feature));
+    }
+
+    state.SetLabel(std::to_string(stopCount).c_str());
+}
+
 BENCHMARK(Parse_CompositeFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
 BENCHMARK(Evaluate_CompositeFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
-
+BENCHMARK(Evaluate_CompositeFunctionTree)
+    ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
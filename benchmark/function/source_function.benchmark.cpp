@@ -52,10 +52,61 @@ static void Evaluate_SourceFunction(benchmark::State& state) {
     state.SetLabel(std::to_string(stopCount).c_str());
 }
 
+// Same as Evaluate_SourceFunction, but evaluating the expression tree instead of its compiled form.
+static void Evaluate_SourceFunctionTree(benchmark::State& state) {
+    size_t stopCount = state.range(0);
+    auto doc = createFunctionJSON(stopCount);
+    conversion::Error error;
+    optional<PropertyValue<float>> function = conversion::convertJSON<PropertyValue<float>>(doc, error, true, false);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+    const expression::Expression& tree = function->asExpression().getExpression();
+
+    while(state.KeepRunning()) {
+        StubGeometryTileFeature feature(PropertyMap { { "x", static_cast<int64_t>(rand() % 100) } });
+        tree.evaluate(expression::EvaluationContext(&feature));
+    }
+
+    state.SetLabel(std::to_string(stopCount).c_str());
+}
+
+// Same as Evaluate_SourceFunction, but evaluating the expression for a whole tile's worth of
+// features at once.
+static void Evaluate_SourceFunctionColumn(benchmark::State& state) {
+    size_t stopCount = state.range(0);
+    auto doc = createFunctionJSON(stopCount);
+    conversion::Error error;
+    optional<PropertyValue<float>> function = conversion::convertJSON<PropertyValue<float>>(doc, error, true, false);
+    if (!function) {
+        state.SkipWithError(error.message.c_str());
+    }
+
+    std::vector<StubGeometryTileFeature> features;
+    for (size_t i = 0; i < 1000; i++) {
+        features.emplace_back(PropertyMap { { "x", static_cast<int64_t>(rand() % 100) } });
+    }
+    std::vector<const GeometryTileFeature*> column;
+    for (const auto& feature : features) {
+        column.push_back(&feature);
+    }
+
+    while(state.KeepRunning()) {
+        benchmark::DoNotOptimize(function->asExpression().evaluate(nullopt, column, -1.0f));
+    }
+
+    state.SetItemsProcessed(state.iterations() * column.size());
+    state.SetLabel(std::to_string(stopCount).c_str());
+}
+
 BENCHMARK(Parse_SourceFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
 BENCHMARK(Evaluate_SourceFunction)
     ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
+BENCHMARK(Evaluate_SourceFunctionTree)
+    ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
 
+BENCHMARK(Evaluate_SourceFunctionColumn)
+    ->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(10)->Arg(12);
@@ -30,5 +30,39 @@ static void Parse_EvaluateFilter(benchmark::State& state) {
     }
 }
 
+// Same as Parse_EvaluateFilter, but evaluating the expression tree instead of its compiled form.
+static void Parse_EvaluateFilterTree(benchmark::State& state) {
+    const style::Filter filter = parse(R"FILTER(["==", "foo", "bar"])FILTER");
+    const StubGeometryTileFeature feature = { {}, FeatureType::Unknown , {},  {{ "foo", std::string("bar") }} };
+    const style::expression::EvaluationContext context(&feature);
+
+    while (state.KeepRunning()) {
+        (*filter.expression)->evaluate(context);
+    }
+}
+
+static void Parse_EvaluateExpressionFilter(benchmark::State& state) {
+    const style::Filter filter = parse(R"FILTER(["all", ["==", ["get", "class"], "street"], [">=", ["get", "rank"], 3]])FILTER");
+    const StubGeometryTileFeature feature = { {}, FeatureType::Unknown , {},  {{ "class", std::string("street") }, { "rank", int64_t(5) }} };
+    const style::expression::EvaluationContext context(&feature);
+
+    while (state.KeepRunning()) {
+        filter(context);
+    }
+}
+
+static void Parse_EvaluateExpressionFilterTree(benchmark::State& state) {
+    const style::Filter filter = parse(R"FILTER(["all", ["==", ["get", "class"], "street"], [">=", ["get", "rank"], 3]])FILTER");
+    const StubGeometryTileFeature feature = { {}, FeatureType::Unknown , {},  {{ "class", std::string("street") }, { "rank", int64_t(5) }} };
+    const style::expression::EvaluationContext context(&feature);
+
+    while (state.KeepRunning()) {
+        (*filter.expression)->evaluate(context);
+    }
+}
+
 BENCHMARK(Parse_Filter);
 BENCHMARK(Parse_EvaluateFilter);
+BENCHMARK(Parse_EvaluateFilterTree);
+BENCHMARK(Parse_EvaluateExpressionFilter);
+BENCHMARK(Parse_EvaluateExpressionFilterTree);
@@ -5,9 +5,12 @@
 #include <mbgl/storage/response.hpp>
 #include <mbgl/storage/sqlite3.hpp>
 #include <mbgl/util/string.hpp>
+#include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <algorithm>
 #include <random>
+#include <vector>
 
 class OfflineDatabase : public benchmark::Fixture {
 public:
@@ -194,3 +197,55 @@ BENCHMARK_F(OfflineDatabase, ResizeDatabase)(benchmark::State& state) {
         }
     }
 }
+
+namespace {
+
+// Stores all small tiles of a zoom level in the region, and returns them in the order in which
+// TileCover, and thus OfflineDownload, enumerates them.
+std::vector<mbgl::Resource> putRegionTiles(mbgl::OfflineDatabase& db, int64_t regionID, int32_t zoom) {
+    mbgl::Response response;
+    response.data = std::make_shared<std::string>("data");
+
+    std::vector<mbgl::Resource> tiles;
+    mbgl::util::TileCover cover(mbgl::LatLngBounds::world(), zoom);
+    while (auto tileID = cover.next()) {
+        const auto& id = tileID->canonical;
+        tiles.push_back(mbgl::Resource::tile("mapbox://tile_offline_region/{z}/{x}/{y}", 1.0, id.x, id.y, id.z, mbgl::Tileset::Scheme::XYZ));
+        db.putRegionResource(regionID, tiles.back(), response);
+    }
+    return tiles;
+}
+
+} // namespace
+
+BENCHMARK_F(OfflineDatabase, HasRegionResourceTiles)(benchmark::State& state) {
+    using namespace mbgl;
+
+    const auto tiles = putRegionTiles(db, regionID, 6);
+
+    while (state.KeepRunning()) {
+        for (const auto& tile : tiles) {
+            auto size = db.hasRegionResource(regionID, tile);
+            assert(size);
+            (void)size;
+        }
+    }
+}
+
+BENCHMARK_F(OfflineDatabase, HasRegionResourcesBatchedTiles)(benchmark::State& state) {
+    using namespace mbgl;
+
+    const auto tiles = putRegionTiles(db, regionID, 6);
+
+    // Same batch size as OfflineDownload.
+    const std::size_t batchSize = 256;
+
+    while (state.KeepRunning()) {
+        for (std::size_t i = 0; i < tiles.size(); i += batchSize) {
+            std::vector<Resource> batch(tiles.begin() + i, tiles.begin() + std::min(i + batchSize, tiles.size()));
+            auto sizes = db.hasRegionResources(regionID, batch);
+            assert(sizes.size() == batch.size());
+            (void)sizes;
+        }
+    }
+}
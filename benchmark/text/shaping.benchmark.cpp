@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/text/bidi.hpp>
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+const FontStack fontStack {{ "Open Sans Regular" }};
+
+GlyphMap createGlyphMap() {
+    Glyphs glyphs;
+    for (char16_t character = u' '; character <= u'~'; ++character) {
+        Glyph glyph;
+        glyph.id = character;
+        glyph.metrics.width = 14;
+        glyph.metrics.height = 18;
+        glyph.metrics.advance = 10 + character % 5;
+        glyphs.emplace(character, Immutable<Glyph>(makeMutable<Glyph>(std::move(glyph))));
+    }
+    return {{ FontStackHasher()(fontStack), std::move(glyphs) }};
+}
+
+// Mimics the labels of a dense street map: a few hundred distinct street names, each appearing in
+// several tiles and at several zoom levels.
+std::vector<TaggedString> createLabels() {
+    static const std::vector<std::u16string> names {
+        u"Main", u"Oak", u"Maple", u"Cedar", u"Elm", u"Washington", u"Lake", u"Hill", u"Park", u"Pine",
+        u"Sunset", u"Ridge", u"Highland", u"Church", u"Mill", u"River", u"Spring", u"Meadow", u"Forest", u"Valley"
+    };
+    static const std::vector<std::u16string> kinds { u" Street", u" Avenue", u" Boulevard", u" Road", u" Lane" };
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::size_t> name(0, names.size() - 1);
+    std::uniform_int_distribution<std::size_t> kind(0, kinds.size() - 1);
+
+    std::vector<TaggedString> labels;
+    for (std::size_t i = 0; i < 2000; ++i) {
+        std::u16string label = names[name(generator)];
+        if (i % 3 == 0) {
+            label = u"North " + label;
+        }
+        labels.emplace_back(label + kinds[kind(generator)], SectionOptions(1.0, fontStack));
+    }
+    return labels;
+}
+
+template <class Shape>
+void shapeLabels(benchmark::State& state, Shape&& shape) {
+    const GlyphMap glyphs = createGlyphMap();
+    const std::vector<TaggedString> labels = createLabels();
+    BiDi bidi;
+
+    while (state.KeepRunning()) {
+        for (const auto& label : labels) {
+            benchmark::DoNotOptimize(shape(label, bidi, glyphs));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * labels.size());
+}
+
+// Lines of CJK text break between any two ideographs.
+void shapeIdeographs(benchmark::State& state, bool serverSuggestedBreaks) {
+    const std::size_t length = state.range(0);
+    Glyphs glyphs;
+    std::u16string text;
+    for (std::size_t i = 0; i < length; ++i) {
+        const char16_t character = u'\u4e00' + i % 512;
+        if (serverSuggestedBreaks && i % 7 == 6) {
+            text += u'\u200b';
+        }
+        text += character;
+
+        Glyph glyph;
+        glyph.id = character;
+        glyph.metrics.width = 20;
+        glyph.metrics.height = 20;
+        glyph.metrics.advance = 21;
+        glyphs.emplace(character, Immutable<Glyph>(makeMutable<Glyph>(std::move(glyph))));
+    }
+    const GlyphMap glyphMap {{ FontStackHasher()(fontStack), std::move(glyphs) }};
+    const TaggedString string(text, SectionOptions(1.0, fontStack));
+    BiDi bidi;
+
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(getShaping(string, 10 * util::ONE_EM, 1.2 * util::ONE_EM, style::SymbolAnchorType::Center,
+                                            style::TextJustifyType::Center, 0, { 0.0f, 0.0f }, WritingModeType::Horizontal, bidi, glyphMap));
+    }
+    state.SetItemsProcessed(state.iterations() * length);
+}
+
+} // namespace
+
+static void Shaping_Labels(benchmark::State& state) {
+    shapeLabels(state, [](const TaggedString& label, BiDi& bidi, const GlyphMap& glyphs) {
+        return getShaping(label, 10 * util::ONE_EM, 1.2 * util::ONE_EM, style::SymbolAnchorType::Center,
+                          style::TextJustifyType::Center, 0, { 0.0f, 0.0f }, WritingModeType::Horizontal, bidi, glyphs);
+    });
+}
+
+static void Shaping_LabelsCached(benchmark::State& state) {
+    ShapingCache cache(4096);
+    shapeLabels(state, [&](const TaggedString& label, BiDi& bidi, const GlyphMap& glyphs) {
+        return cache.getShaping(label, 10 * util::ONE_EM, 1.2 * util::ONE_EM, style::SymbolAnchorType::Center,
+                                style::TextJustifyType::Center, 0, { 0.0f, 0.0f }, WritingModeType::Horizontal, bidi, glyphs);
+    });
+}
+
+static void Shaping_Ideographs(benchmark::State& state) {
+    shapeIdeographs(state, false);
+}
+
+static void Shaping_IdeographsWithSuggestedBreaks(benchmark::State& state) {
+    shapeIdeographs(state, true);
+}
+
+BENCHMARK(Shaping_Labels);
+BENCHMARK(Shaping_LabelsCached);
+BENCHMARK(Shaping_Ideographs)->Arg(16)->Arg(64)->Arg(256)->Arg(1024)->Arg(4096);
+BENCHMARK(Shaping_IdeographsWithSuggestedBreaks)->Arg(16)->Arg(64)->Arg(256)->Arg(1024)->Arg(4096);
@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/layout/symbol_layout.hpp>
+#include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/style/layers/symbol_layer_impl.hpp>
+#include <mbgl/style/layers/symbol_layer_properties.hpp>
+#include <mbgl/text/glyph_atlas.hpp>
+#include <mbgl/util/constants.hpp>
+
+#include <random>
+
+using namespace mbgl;
+using namespace mbgl::style;
+
+namespace {
+
+const FontStack fontStack {{ "Open Sans Regular" }};
+
+class StubGeometryTileLayer : public GeometryTileLayer {
+public:
+    StubGeometryTileLayer(std::vector<GeometryCollection> lines_)
+        : lines(std::move(lines_)) {
+    }
+
+    std::size_t featureCount() const override {
+        return lines.size();
+    }
+
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override {
+        return std::make_unique<StubGeometryTileFeature>(FeatureIdentifier(), FeatureType::LineString, lines[i], PropertyMap());
+    }
+
+    std::string getName() const override {
+        return "roads";
+    }
+
+private:
+    std::vector<GeometryCollection> lines;
+};
+
+// Mimics a dense tile of highway segments that all carry the same shield.
+std::vector<GeometryCollection> createLines() {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int16_t> x(0, util::EXTENT - 1200);
+    std::uniform_int_distribution<int16_t> y(0, util::EXTENT);
+
+    std::vector<GeometryCollection> lines;
+    for (std::size_t i = 0; i < 3000; ++i) {
+        const int16_t startX = x(generator);
+        const int16_t startY = y(generator);
+        lines.push_back({ { { startX, startY }, { int16_t(startX + 1200), startY } } });
+    }
+    return lines;
+}
+
+} // namespace
+
+static void SymbolLayout_RepeatedLineLabels(benchmark::State& state) {
+    SymbolLayer layer("shields", "source");
+    layer.setSymbolPlacement(SymbolPlacementType::Line);
+    layer.setSymbolSpacing(float(state.range(0)));
+    layer.setTextField(expression::Formatted("I-95"));
+    layer.setTextFont(fontStack);
+    const std::vector<Immutable<LayerProperties>> layers {
+        makeMutable<SymbolLayerProperties>(staticImmutableCast<SymbolLayer::Impl>(layer.baseImpl))
+    };
+
+    Glyphs glyphs;
+    GlyphPositionMap positions;
+    for (char16_t character : std::u16string(u"I-95")) {
+        Glyph glyph;
+        glyph.id = character;
+        glyph.metrics.width = 14;
+        glyph.metrics.height = 18;
+        glyph.metrics.advance = 12;
+        positions.emplace(character, GlyphPosition { Rect<uint16_t>(0, 0, 20, 24), glyph.metrics });
+        glyphs.emplace(character, Immutable<Glyph>(makeMutable<Glyph>(std::move(glyph))));
+    }
+    const GlyphMap glyphMap {{ FontStackHasher()(fontStack), std::move(glyphs) }};
+    const GlyphPositions glyphPositions {{ FontStackHasher()(fontStack), std::move(positions) }};
+
+    const std::vector<GeometryCollection> lines = createLines();
+    const BucketParameters parameters { OverscaledTileID(14, 0, 0), MapMode::Static, 1.0f, SymbolLayer::Impl::staticTypeInfo() };
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        ImageDependencies imageDependencies;
+        GlyphDependencies glyphDependencies;
+        SymbolLayout layout(parameters, layers, std::make_unique<StubGeometryTileLayer>(lines), imageDependencies, glyphDependencies);
+        state.ResumeTiming();
+
+        layout.prepareSymbols(glyphMap, glyphPositions, {}, {});
+        benchmark::DoNotOptimize(layout.symbolInstances.size());
+    }
+    state.SetItemsProcessed(state.iterations() * lines.size());
+}
+
+BENCHMARK(SymbolLayout_RepeatedLineLabels)->Arg(10)->Arg(50)->Arg(250);
@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/grid_index.hpp>
+#include <mbgl/geometry/feature_index.hpp>
+
+#include <cmath>
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+using Grid = GridIndex<IndexedSubfeature>;
+
+// Mimics symbol placement into a viewport-sized collision grid: every candidate
+// label is hit-tested against the already placed ones and inserted if it is free.
+static std::size_t placeLabels(std::size_t count, bool alongLine) {
+    Grid grid(1200, 1200, 25);
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> position(0, 1200);
+    std::uniform_real_distribution<float> extent(10, 80);
+
+    const IndexedSubfeature feature(0, "", "", 0);
+    std::size_t placed = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        const float x = position(generator);
+        const float y = position(generator);
+        if (alongLine) {
+            const Grid::BCircle circle{ { x, y }, extent(generator) / 4 };
+            if (!grid.hitTest(circle)) {
+                grid.insert(IndexedSubfeature(feature), circle);
+                ++placed;
+            }
+        } else {
+            const float width = extent(generator);
+            const Grid::BBox box{ { x, y }, { x + width, y + width / 4 } };
+            if (!grid.hitTest(box)) {
+                grid.insert(IndexedSubfeature(feature), box);
+                ++placed;
+            }
+        }
+    }
+    return placed;
+}
+
+// Line labels are covered by a run of circles along a curved line, which are tested one by one
+// until the first one that collides.
+static std::size_t placeLineLabels(std::size_t count, std::size_t circleCount) {
+    Grid grid(1200, 1200, 25);
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> position(0, 1200);
+    std::uniform_real_distribution<float> angle(-M_PI, M_PI);
+    std::uniform_real_distribution<float> curvature(-0.1, 0.1);
+
+    const IndexedSubfeature feature(0, "", "", 0);
+    const float radius = 6;
+    std::vector<Grid::BCircle> circles;
+    std::size_t placed = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        float x = position(generator);
+        float y = position(generator);
+        float direction = angle(generator);
+        const float bend = curvature(generator);
+        circles.clear();
+        for (std::size_t j = 0; j < circleCount; ++j) {
+            circles.push_back({ { x, y }, radius });
+            x += std::cos(direction) * radius * 1.5f;
+            y += std::sin(direction) * radius * 1.5f;
+            direction += bend;
+        }
+
+        bool hit = false;
+        for (const auto& circle : circles) {
+            if (grid.hitTest(circle)) {
+                hit = true;
+                break;
+            }
+        }
+        if (!hit) {
+            for (const auto& circle : circles) {
+                grid.insert(IndexedSubfeature(feature), circle);
+            }
+            ++placed;
+        }
+    }
+    return placed;
+}
+
+} // namespace
+
+static void GridIndex_placeBoxes(benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::size_t placed = 0;
+    while (state.KeepRunning()) {
+        placed += placeLabels(count, false);
+    }
+    benchmark::DoNotOptimize(placed);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void GridIndex_placeCircles(benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    std::size_t placed = 0;
+    while (state.KeepRunning()) {
+        placed += placeLabels(count, true);
+    }
+    benchmark::DoNotOptimize(placed);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+static void GridIndex_placeLineLabels(benchmark::State& state) {
+    const auto count = static_cast<std::size_t>(state.range(0));
+    const auto circleCount = static_cast<std::size_t>(state.range(1));
+    std::size_t placed = 0;
+    while (state.KeepRunning()) {
+        placed += placeLineLabels(count, circleCount);
+    }
+    benchmark::DoNotOptimize(placed);
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(GridIndex_placeBoxes)->Arg(1000)->Arg(10000);
+BENCHMARK(GridIndex_placeCircles)->Arg(1000)->Arg(10000);
+BENCHMARK(GridIndex_placeLineLabels)->Args({ 1000, 8 })->Args({ 1000, 32 })->Args({ 10000, 8 })->Args({ 10000, 32 });
@@ -7,6 +7,8 @@
 
 #include <args.hxx>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <iostream>
 #include <csignal>
@@ -103,6 +105,9 @@ int main(int argc, char *argv[]) {
     args::ValueFlag<double> pixelRatioValue(argumentParser, "number", "Pixel ratio", {"pixelRatio"});
     args::ValueFlag<bool> includeIdeographsValue(argumentParser, "boolean", "Include CJK glyphs", {"includeIdeographs"});
 
+    args::ValueFlag<uint32_t> jobsValue(argumentParser, "number", "Number of concurrent requests", {'j', "jobs"});
+    args::Flag resumeFlag(argumentParser, "resume", "Resume a region with the same definition in the output database", {'r', "resume"});
+
     try {
         argumentParser.ParseCLI(argc, argv);
     } catch (const args::Help&) {
@@ -166,6 +171,9 @@ int main(int argc, char *argv[]) {
 
     fileSource.setAccessToken(token);
     fileSource.setAPIBaseURL(apiBaseURL);
+    if (jobsValue) {
+        fileSource.setMaximumConcurrentRequests(std::max(args::get(jobsValue), 1u));
+    }
 
     if (inputDb && mergePath) {
         DefaultFileSource inputSource(*inputDb, ".");
@@ -193,41 +201,68 @@ int main(int argc, char *argv[]) {
 
     class Observer : public OfflineRegionObserver {
     public:
-        Observer(OfflineRegion& region_, DefaultFileSource& fileSource_, util::RunLoop& loop_, mbgl::optional<std::string> mergePath_)
+        Observer(OfflineRegion& region_, DefaultFileSource& fileSource_, util::RunLoop& loop_, mbgl::optional<std::string> mergePath_, OfflineRegionStatus stored_)
             : region(region_),
               fileSource(fileSource_),
               loop(loop_),
               mergePath(std::move(mergePath_)),
+              stored(std::move(stored_)),
               start(util::now()) {
         }
 
         void statusChanged(OfflineRegionStatus status) override {
             if (status.downloadState == OfflineRegionDownloadState::Inactive) {
                 std::cout << "stopped" << std::endl;
+                printSummary(status);
                 loop.stop();
                 return;
             }
 
+            const double elapsedSeconds = std::chrono::duration<double>(util::now() - start).count();
+            std::string tilesPerSecond = "-";
             std::string bytesPerSecond = "-";
-
-            auto elapsedSeconds = (util::now() - start) / 1s;
-            if (elapsedSeconds != 0) {
-                bytesPerSecond = util::toString(status.completedResourceSize / elapsedSeconds);
+            if (elapsedSeconds >= 1) {
+                tilesPerSecond = util::toString(uint64_t(fetchedTileCount(status) / elapsedSeconds));
+                bytesPerSecond = util::toString(uint64_t(fetchedResourceSize(status) / elapsedSeconds));
             }
 
             std::cout << status.completedResourceCount << " / " << status.requiredResourceCount
                       << " resources"
                       << (status.requiredResourceCountIsPrecise ? "; " : " (indeterminate); ")
+                      << status.completedTileCount << " tiles"
+                      << " (" << tilesPerSecond << " tiles/sec); "
                       << status.completedResourceSize << " bytes downloaded"
                       << " (" << bytesPerSecond << " bytes/sec)"
                       << std::endl;
 
             if (status.complete()) {
                 std::cout << "Finished Download" << std::endl;
+                printSummary(status);
                 loop.stop();
             }
         }
 
+        // Rates are over what this run fetched, leaving out resources already stored by an
+        // earlier run of a resumed region.
+        uint64_t fetchedTileCount(const OfflineRegionStatus& status) const {
+            return status.completedTileCount - std::min(stored.completedTileCount, status.completedTileCount);
+        }
+
+        uint64_t fetchedResourceSize(const OfflineRegionStatus& status) const {
+            return status.completedResourceSize - std::min(stored.completedResourceSize, status.completedResourceSize);
+        }
+
+        void printSummary(const OfflineRegionStatus& status) const {
+            const double elapsedSeconds = std::max(std::chrono::duration<double>(util::now() - start).count(), 0.001);
+            const uint64_t tiles = fetchedTileCount(status);
+            const uint64_t bytes = fetchedResourceSize(status);
+
+            std::cout << "Fetched " << tiles << " tiles and " << bytes << " bytes in "
+                      << util::toString(elapsedSeconds) << " s ("
+                      << uint64_t(tiles / elapsedSeconds) << " tiles/sec, "
+                      << uint64_t(bytes / elapsedSeconds) << " bytes/sec)" << std::endl;
+        }
+
         void responseError(Response::Error error) override {
             std::cerr << error.reason << " downloading resource: " << error.message << std::endl;
         }
@@ -240,6 +275,7 @@ int main(int argc, char *argv[]) {
         DefaultFileSource& fileSource;
         util::RunLoop& loop;
         mbgl::optional<std::string> mergePath;
+        const OfflineRegionStatus stored;
         Timestamp start;
     };
 
@@ -252,18 +288,50 @@ int main(int argc, char *argv[]) {
 
     std::signal(SIGINT, [] (int) { stop(); });
 
-    fileSource.createOfflineRegion(definition, metadata, [&] (mbgl::expected<OfflineRegion, std::exception_ptr> region_) {
-        if (!region_) {
-            std::cerr << "Error creating region: " << util::toString(region_.error()) << std::endl;
-            loop.stop();
-            exit(1);
-        } else {
-            assert(region_);
-            region = std::make_unique<OfflineRegion>(std::move(*region_));
-            fileSource.setOfflineRegionObserver(*region, std::make_unique<Observer>(*region, fileSource, loop, mergePath));
+    auto download = [&] (OfflineRegion region_) {
+        region = std::make_unique<OfflineRegion>(std::move(region_));
+        // What is already stored counts as done; only the rest is fetched.
+        fileSource.getOfflineRegionStatus(*region, [&] (mbgl::expected<OfflineRegionStatus, std::exception_ptr> stored) {
+            fileSource.setOfflineRegionObserver(*region, std::make_unique<Observer>(*region, fileSource, loop, mergePath,
+                                                                                    stored ? *stored : OfflineRegionStatus()));
             fileSource.setOfflineRegionDownloadState(*region, OfflineRegionDownloadState::Active);
-        }
-    });
+        });
+    };
+
+    auto create = [&] {
+        fileSource.createOfflineRegion(definition, metadata, [&] (mbgl::expected<OfflineRegion, std::exception_ptr> region_) {
+            if (!region_) {
+                std::cerr << "Error creating region: " << util::toString(region_.error()) << std::endl;
+                loop.stop();
+                exit(1);
+            } else {
+                assert(region_);
+                download(std::move(*region_));
+            }
+        });
+    };
+
+    if (resumeFlag) {
+        fileSource.listOfflineRegions([&] (mbgl::expected<OfflineRegions, std::exception_ptr> regions) {
+            if (!regions) {
+                std::cerr << "Error listing regions: " << util::toString(regions.error()) << std::endl;
+                loop.stop();
+                exit(1);
+            }
+
+            const std::string encoded = encodeOfflineRegionDefinition(definition);
+            for (auto& existing : *regions) {
+                if (encodeOfflineRegionDefinition(existing.getDefinition()) == encoded) {
+                    std::cout << "Resuming region " << existing.getID() << std::endl;
+                    download(std::move(existing));
+                    return;
+                }
+            }
+            create();
+        });
+    } else {
+        create();
+    }
 
     loop.run();
     return 0;
@@ -0,0 +1,153 @@
+#!/usr/bin/env node
+/* jshint node: true */
+'use strict';
+
+// Runs mbgl-offline against a server for the test/fixtures/offline_download fixtures: a first
+// run is interrupted while the tiles of the last zoom level are requested, and a second run with
+// --resume completes the region.
+//
+// Usage: node bin/offline.test.js path/to/mbgl-offline
+
+var test = require('tape');
+var express = require('express');
+var spawn = require('child_process').spawn;
+var fs = require('fs');
+var os = require('os');
+var path = require('path');
+
+var offline = process.argv[2];
+if (!offline) {
+    console.error('Usage: node bin/offline.test.js path/to/mbgl-offline');
+    process.exit(1);
+}
+
+var fixtures = path.join(__dirname, '../test/fixtures/offline_download');
+var database = path.join(fs.mkdtempSync(path.join(os.tmpdir(), 'mbgl-offline-')), 'offline.db');
+var maxZoom = 2;
+
+var app = express();
+var server;
+var port;
+var tileRequests = {};
+var held = [];
+var holdLastZoom = false;
+
+app.get('/style.json', function(req, res) {
+    res.json({
+        version: 8,
+        sources: { streets: { type: 'vector', url: 'http://127.0.0.1:' + port + '/streets.json' } },
+        sprite: 'http://127.0.0.1:' + port + '/sprite',
+        layers: [{ id: 'water', type: 'fill', source: 'streets', 'source-layer': 'water' }]
+    });
+});
+
+app.get('/streets.json', function(req, res) {
+    res.json({
+        tilejson: '2.0.0',
+        minzoom: 0,
+        maxzoom: 15,
+        tiles: ['http://127.0.0.1:' + port + '/{z}-{x}-{y}.vector.pbf']
+    });
+});
+
+app.get(/^\/sprite(@2x)?\.(json|png)$/, function(req, res) {
+    res.sendFile(path.join(fixtures, 'sprite.' + req.params[1]));
+});
+
+app.get('/:z-:x-:y.vector.pbf', function(req, res) {
+    var key = req.params.z + '/' + req.params.x + '/' + req.params.y;
+    if (holdLastZoom && Number(req.params.z) === maxZoom) {
+        // Never answered; the tool cancels the request when it is interrupted.
+        held.push(res);
+        return;
+    }
+    tileRequests[key] = (tileRequests[key] || 0) + 1;
+    res.sendFile(path.join(fixtures, '0-0-0.vector.pbf'));
+});
+
+function run(args, callback) {
+    var child = spawn(offline, [
+        '--style', 'http://127.0.0.1:' + port + '/style.json',
+        '--north', '60', '--west', '-100', '--south', '-60', '--east', '100',
+        '--maxZoom', String(maxZoom),
+        '--output', database
+    ].concat(args));
+
+    var output = '';
+    child.stdout.on('data', function(data) {
+        output += data;
+    });
+    child.stderr.pipe(process.stderr);
+    child.on('close', function(code) {
+        callback(code, output);
+    });
+    return child;
+}
+
+// Returns the numbers of the last line of the output matching the pattern.
+function last(output, pattern) {
+    var matches = output.split('\n').filter(function(line) { return pattern.test(line); });
+    return matches.length ? matches[matches.length - 1].match(pattern).slice(1).map(Number) : null;
+}
+
+test('offline', function(t) {
+    var interruptedTiles;
+
+    t.test('setup', function(t) {
+        server = app.listen(0, '127.0.0.1', function() {
+            port = server.address().port;
+            t.end();
+        });
+    });
+
+    t.test('interrupted', function(t) {
+        holdLastZoom = true;
+        var child = run([], function(code, output) {
+            t.equal(code, 0, 'exits after stopping');
+            t.ok(/^Stopping download\.\.\. stopped$/m.test(output), 'reports that the download stopped');
+
+            var fetched = last(output, /^Fetched (\d+) tiles and (\d+) bytes/);
+            t.ok(fetched, 'prints a summary');
+            interruptedTiles = fetched[0];
+            t.ok(interruptedTiles > 0, 'stores the tiles fetched before stopping');
+            t.equal(interruptedTiles, Object.keys(tileRequests).length, 'counts every fetched tile');
+            t.end();
+        });
+
+        // Interrupt once the last zoom level is requested and the other tiles had time to arrive.
+        var timer = setInterval(function() {
+            if (held.length) {
+                clearInterval(timer);
+                setTimeout(function() { child.kill('SIGINT'); }, 500);
+            }
+        }, 50);
+    });
+
+    t.test('resumed', function(t) {
+        holdLastZoom = false;
+        held.forEach(function(res) { res.destroy(); });
+        var previous = Object.keys(tileRequests).length;
+        run(['--resume'], function(code, output) {
+            t.equal(code, 0, 'exits after finishing');
+            t.ok(/^Resuming region \d+$/m.test(output), 'resumes the region');
+            t.ok(/^Finished Download$/m.test(output), 'completes the download');
+
+            var progress = last(output, /^(\d+) \/ (\d+) resources; (\d+) tiles/);
+            t.ok(progress, 'prints progress');
+            t.equal(progress[0], progress[1], 'completes all required resources');
+
+            var fetched = last(output, /^Fetched (\d+) tiles and (\d+) bytes/);
+            t.equal(fetched[0], progress[2] - interruptedTiles, 'reports only the tiles fetched by this run');
+            t.equal(Object.keys(tileRequests).length - previous, fetched[0], 'requests only the missing tiles');
+            Object.keys(tileRequests).forEach(function(key) {
+                t.equal(tileRequests[key], 1, 'fetches tile ' + key + ' once');
+            });
+            t.end();
+        });
+    });
+
+    t.test('teardown', function(t) {
+        server.close();
+        t.end();
+    });
+});
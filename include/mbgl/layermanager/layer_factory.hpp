@@ -28,6 +28,8 @@ public:
     virtual const style::LayerTypeInfo* getTypeInfo() const noexcept = 0;
     /// Returns a new Layer instance on success call; returns `nullptr` otherwise. 
     virtual std::unique_ptr<style::Layer> createLayer(const std::string& id, const style::conversion::Convertible& value) noexcept = 0;
+    /// Returns a new Layer instance sharing the given implementation.
+    virtual std::unique_ptr<style::Layer> createLayer(Immutable<style::Layer::Impl>) noexcept = 0;
     /// Returns a new RenderLayer instance.
     virtual std::unique_ptr<RenderLayer> createRenderLayer(Immutable<style::Layer::Impl>) noexcept = 0;
     /// Returns a new Bucket instance on success call; returns `nullptr` otherwise. 
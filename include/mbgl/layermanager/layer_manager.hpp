@@ -37,6 +37,8 @@ public:
     /// Returns a new Layer instance on success call; returns `nullptr` otherwise.
     std::unique_ptr<style::Layer> createLayer(const std::string& type, const std::string& id,
                                               const style::conversion::Convertible& value, style::conversion::Error& error) noexcept;
+    /// Returns a new Layer instance sharing the given implementation, e.g. one of a previously parsed style.
+    std::unique_ptr<style::Layer> createLayer(Immutable<style::Layer::Impl>) noexcept;
     /// Returns a new RenderLayer instance on success call; returns `nullptr` otherwise.
     std::unique_ptr<RenderLayer> createRenderLayer(Immutable<style::Layer::Impl>) noexcept;
     /// Returns a new Bucket instance on success call; returns `nullptr` otherwise.
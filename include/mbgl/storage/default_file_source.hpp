@@ -2,6 +2,7 @@
 
 #include <mbgl/actor/actor_ref.hpp>
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/http_connection_options.hpp>
 #include <mbgl/storage/offline.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/optional.hpp>
@@ -145,6 +146,31 @@ public:
      */
     void setOfflineMapboxTileCountLimit(uint64_t) const;
 
+    /*
+     * Sets how many network requests may be in flight at once, both for regular
+     * requests and for offline region downloads. Raising it lets downloads from a
+     * nearby tile server keep more requests pipelined.
+     */
+    void setMaximumConcurrentRequests(uint32_t) const;
+
+    /*
+     * Sets how many requests revalidating expired cached resources may be in flight
+     * at once. These only use connections that regular requests leave idle.
+     */
+    void setMaximumConcurrentRevalidations(uint32_t) const;
+
+    /*
+     * Sets how connections to tile servers are shared and kept open between
+     * requests. Only HTTP backends that manage their own connections apply these.
+     */
+    void setConnectionOptions(const HTTPConnectionOptions&) const;
+
+    /*
+     * Sets how many bytes of each MBTiles file SQLite may memory-map when reading
+     * mbtiles:// resources. The default of 0 reads all pages through SQLite's cache.
+     */
+    void setMBTilesMmapSize(uint64_t) const;
+
     /*
      * Pause file request activity.
      *
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <cstdint>
+
+namespace mbgl {
+
+// Controls how HTTPFileSource reuses connections. Platforms whose networking stack manages
+// connections on its own (e.g. NSURLSession, OkHttp) may ignore some or all of these.
+struct HTTPConnectionOptions {
+    // Negotiate HTTP/2 over TLS and multiplex concurrent requests to the same host over a single
+    // connection instead of opening one connection per request.
+    bool multiplex = true;
+
+    // Upper bound of concurrent streams opened on one multiplexed connection.
+    uint32_t maxStreamsPerConnection = 100;
+
+    // Upper bound of connections opened to one host; 0 means no limit.
+    uint32_t maxConnectionsPerHost = 0;
+
+    // Idle time before TCP keepalive probes are sent on an open connection; 0 disables keepalive.
+    Seconds keepAliveIdle { 60 };
+
+    // How long resolved host names are cached; 0 disables the DNS cache.
+    Seconds dnsCacheTimeout { 60 };
+};
+
+} // namespace mbgl
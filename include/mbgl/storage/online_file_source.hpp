@@ -2,6 +2,7 @@
 
 #include <mbgl/actor/actor_ref.hpp>
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/http_connection_options.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/optional.hpp>
 
@@ -27,6 +28,13 @@ public:
     void setMaximumConcurrentRequests(uint32_t);
     uint32_t getMaximumConcurrentRequests() const;
 
+    // Requests revalidating a resource the requester already holds a usable copy of have a budget
+    // of their own, and are only started while no regular request is waiting for a connection.
+    void setMaximumConcurrentRevalidations(uint32_t);
+    uint32_t getMaximumConcurrentRevalidations() const;
+
+    void setConnectionOptions(const HTTPConnectionOptions&);
+
     // For testing only.
     void setOnlineStatus(bool);
 
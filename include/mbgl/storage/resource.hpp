@@ -7,6 +7,8 @@
 #include <mbgl/util/util.hpp>
 #include <mbgl/util/traits.hpp>
 
+#include <atomic>
+#include <memory>
 #include <string>
 
 namespace mbgl {
@@ -65,6 +67,12 @@ public:
     void setPriority(Priority p) { priority = p; }
     void setUsage(Usage u) { usage = u; }
 
+    // Orders requests of the same Priority; requests with a lower rank are started first. All copies
+    // of a Resource share one rank, so the requester can keep updating it after the request was
+    // made, e.g. while the tile it loads moves relative to the viewport.
+    void setRank(uint32_t);
+    uint32_t getRank() const;
+
     bool hasLoadingMethod(LoadingMethod method);
 
     static Resource style(const std::string& url);
@@ -87,6 +95,7 @@ public:
     LoadingMethod loadingMethod;
     Usage usage{ Usage::Online };
     Priority priority{ Priority::Regular };
+    std::shared_ptr<std::atomic<uint32_t>> rank;
     std::string url;
 
     // Includes auxiliary data if this is a tile request.
@@ -96,6 +105,10 @@ public:
     optional<Timestamp> priorExpires = {};
     optional<std::string> priorEtag = {};
     std::shared_ptr<const std::string> priorData;
+
+    // Set when the requester already holds a usable copy of the resource, so that a network
+    // request only revalidates it and may wait behind requests for resources that are missing.
+    bool priorUsable = false;
 };
 
 
@@ -115,4 +128,16 @@ inline bool Resource::hasLoadingMethod(Resource::LoadingMethod method) {
     return (loadingMethod & method) != Resource::LoadingMethod::None;
 }
 
+inline void Resource::setRank(uint32_t r) {
+    if (rank) {
+        rank->store(r, std::memory_order_relaxed);
+    } else {
+        rank = std::make_shared<std::atomic<uint32_t>>(r);
+    }
+}
+
+inline uint32_t Resource::getRank() const {
+    return rank ? rank->load(std::memory_order_relaxed) : 0;
+}
+
 } // namespace mbgl
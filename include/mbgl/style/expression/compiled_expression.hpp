@@ -0,0 +1,134 @@
+#pragma once
+
+#include <mbgl/style/expression/expression.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+namespace expression {
+
+/*
+    CompiledExpression is a flattened form of an expression that evaluates to a
+    number or a boolean, used in place of the expression tree for filtering and
+    for evaluating numeric paint and layout properties.
+
+    Each node of the tree is lowered to an instruction operating on unboxed
+    doubles (booleans are 0 or 1), so that evaluation needs neither virtual calls
+    nor intermediate Value variants. Subexpressions that depend on neither the
+    zoom level nor the feature are folded into constants. Subexpressions without
+    a dedicated instruction are still evaluated by the expression tree, so any
+    number or boolean expression can be compiled.
+*/
+class CompiledExpression {
+public:
+    // Returns nullptr if the expression evaluates to neither a number nor a boolean, or if no part
+    // of it would be evaluated faster than by the expression tree itself.
+    static std::shared_ptr<const CompiledExpression> compile(std::shared_ptr<const Expression>);
+
+    // Same as evaluating the expression tree and taking the resulting number or boolean; an
+    // evaluation error yields nullopt.
+    optional<double> evaluateNumber(const EvaluationContext&) const;
+    optional<bool> evaluateBoolean(const EvaluationContext&) const;
+
+    // Same as calling evaluateNumber() in the given zoom level for each of the features, but
+    // interpolate and step expressions are evaluated over the column of their inputs, so that stop
+    // lookups are shared among equal inputs and constant stop outputs are read directly.
+    std::vector<optional<double>> evaluateNumbers(optional<float> zoom, const std::vector<const GeometryTileFeature*>&) const;
+
+    const Expression& getExpression() const { return *expression; }
+
+private:
+    class Compiler;
+
+    enum class Op : uint8_t {
+        Constant,
+        Zoom,
+        ColorRampParameter,
+        GetNumber,
+        GetBoolean,
+        ToNumber,
+        Has,
+        Add,
+        Subtract,
+        Negate,
+        Multiply,
+        Divide,
+        Mod,
+        Pow,
+        Min,
+        Max,
+        Sqrt,
+        Log10,
+        Ln,
+        Log2,
+        Sin,
+        Cos,
+        Tan,
+        Asin,
+        Acos,
+        Atan,
+        Round,
+        Floor,
+        Ceil,
+        Abs,
+        Not,
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        CompareProperty,
+        FilterEquals,
+        FilterIn,
+        FilterHas,
+        Any,
+        All,
+        Case,
+        Interpolate,
+        Step,
+        // Evaluates the subexpression with the expression tree.
+        Tree
+    };
+
+    struct Instruction {
+        Op op;
+        // Index of the first argument, or of the key the operation reads.
+        std::size_t operand = 0;
+        // Number of arguments, or of literal values.
+        std::size_t count = 0;
+        // Index of the first literal value or stop input.
+        std::size_t value = 0;
+        // The comparison a CompareProperty instruction performs.
+        Op comparison = Op::Equal;
+        double constant = 0;
+        const Expression* expression = nullptr;
+    };
+
+    explicit CompiledExpression(std::shared_ptr<const Expression>);
+
+    bool evaluate(std::size_t index, const EvaluationContext&, double& result) const;
+    void evaluateCurve(optional<float> zoom, const std::vector<const GeometryTileFeature*>&, std::vector<optional<double>>& results) const;
+    bool evaluateProperty(const Instruction&, const optional<mbgl::Value>& property, double& result) const;
+    static bool compare(Op, double lhs, double rhs);
+
+    // The expression is kept alive, since instructions that fall back to the tree point into it.
+    std::shared_ptr<const Expression> expression;
+
+    std::vector<Instruction> code;
+    // Instruction operands: indices of argument instructions, stop inputs, property keys and
+    // literal values.
+    std::vector<std::size_t> arguments;
+    std::vector<double> stopInputs;
+    std::vector<std::string> keys;
+    std::vector<Value> values;
+};
+
+} // namespace expression
+} // namespace style
+} // namespace mbgl
@@ -12,19 +12,20 @@
 namespace mbgl {
 namespace style {
 
+namespace expression {
+class CompiledExpression;
+} // namespace expression
+
 class Filter {
 public:
     optional<std::shared_ptr<const expression::Expression>> expression;
 private:
     optional<mbgl::Value> legacyFilter;
+    std::shared_ptr<const expression::CompiledExpression> compiled;
 public:
     Filter() : expression() {}
     
-    Filter(expression::ParseResult _expression, optional<mbgl::Value> _filter = {})
-    : expression(std::move(*_expression)),
-     legacyFilter(std::move(_filter)){
-        assert(!expression || *expression != nullptr);
-    }
+    Filter(expression::ParseResult _expression, optional<mbgl::Value> _filter = {});
     
     bool operator()(const expression::EvaluationContext& context) const;
 
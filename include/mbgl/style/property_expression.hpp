@@ -10,6 +10,10 @@
 namespace mbgl {
 namespace style {
 
+namespace expression {
+class CompiledExpression;
+} // namespace expression
+
 class PropertyExpressionBase {
 public:
     explicit PropertyExpressionBase(std::unique_ptr<expression::Expression>);
@@ -24,7 +28,12 @@ public:
     bool useIntegerZoom = false;
 
 protected:
+    // Numeric expressions are evaluated in their compiled form, if they have one.
+    optional<float> evaluateCompiled(const expression::EvaluationContext&) const;
+    std::vector<optional<float>> evaluateCompiled(optional<float> zoom, const std::vector<const GeometryTileFeature*>&) const;
+
     std::shared_ptr<const expression::Expression> expression;
+    std::shared_ptr<const expression::CompiledExpression> compiled;
     variant<std::nullptr_t, const expression::Interpolate*, const expression::Step*> zoomCurve;
     bool isZoomConstant_;
     bool isFeatureConstant_;
@@ -41,12 +50,8 @@ public:
 
     T evaluate(const expression::EvaluationContext& context, T finalDefaultValue = T()) const {
         assert(canEvaluateWith(context));
-        const expression::EvaluationResult result = expression->evaluate(context);
-        if (result) {
-            const optional<T> typed = expression::fromExpressionValue<T>(*result);
-            return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
-        }
-        return defaultValue ? *defaultValue : finalDefaultValue;
+        const optional<T> typed = evaluateTyped(context, static_cast<T*>(nullptr));
+        return typed ? *typed : defaultValue ? *defaultValue : finalDefaultValue;
     }
 
     T evaluate(float zoom) const {
@@ -61,6 +66,19 @@ public:
         return evaluate(expression::EvaluationContext(zoom, &feature), finalDefaultValue);
     }
 
+    // Same as evaluating the expression for each of the features in turn, but numeric expressions
+    // are evaluated for all of the features at once.
+    std::vector<T> evaluate(optional<float> zoom, const std::vector<const GeometryTileFeature*>& features, T finalDefaultValue) const {
+        assert(features.empty() || canEvaluateWith(expression::EvaluationContext(zoom, features.front(), nullopt)));
+        std::vector<optional<T>> typed = evaluateTyped(zoom, features, static_cast<T*>(nullptr));
+        std::vector<T> result;
+        result.reserve(typed.size());
+        for (auto& value : typed) {
+            result.push_back(value ? std::move(*value) : defaultValue ? *defaultValue : finalDefaultValue);
+        }
+        return result;
+    }
+
     std::vector<optional<T>> possibleOutputs() const {
         return expression::fromExpressionValues<T>(expression->possibleOutputs());
     }
@@ -71,6 +89,30 @@ public:
     }
 
 private:
+    template <class U>
+    optional<U> evaluateTyped(const expression::EvaluationContext& context, U*) const {
+        const expression::EvaluationResult result = expression->evaluate(context);
+        return result ? expression::fromExpressionValue<U>(*result) : nullopt;
+    }
+
+    optional<float> evaluateTyped(const expression::EvaluationContext& context, float*) const {
+        return compiled ? evaluateCompiled(context) : evaluateTyped<float>(context, nullptr);
+    }
+
+    template <class U>
+    std::vector<optional<U>> evaluateTyped(optional<float> zoom, const std::vector<const GeometryTileFeature*>& features, U*) const {
+        std::vector<optional<U>> result;
+        result.reserve(features.size());
+        for (const GeometryTileFeature* feature : features) {
+            result.push_back(evaluateTyped(expression::EvaluationContext(zoom, feature, nullopt), static_cast<U*>(nullptr)));
+        }
+        return result;
+    }
+
+    std::vector<optional<float>> evaluateTyped(optional<float> zoom, const std::vector<const GeometryTileFeature*>& features, float*) const {
+        return compiled ? evaluateCompiled(zoom, features) : evaluateTyped<float>(zoom, features, nullptr);
+    }
+
     optional<T> defaultValue;
 };
 
@@ -53,6 +53,10 @@ constexpr uint64_t DEFAULT_MAX_CACHE_SIZE = 50 * 1024 * 1024;
 constexpr std::size_t DEFAULT_ON_DEMAND_IMAGES_CACHE_SIZE = 100 * 8192;
 
 constexpr Duration DEFAULT_TRANSITION_DURATION = Milliseconds(300);
+// Time per frame that symbol placement may take before it is paused and resumed on the next frame.
+constexpr Duration SYMBOL_PLACEMENT_TIME_BUDGET = Milliseconds(2);
+// Distance, in pixels, by which the view may move before symbols are placed again.
+constexpr double SYMBOL_PLACEMENT_REUSE_TOLERANCE = 0.5;
 constexpr Seconds CLOCK_SKEW_RETRY_TIMEOUT { 30 };
 
 constexpr UnitBezier DEFAULT_TRANSITION_EASE = { 0, 0, 0.25, 1 };
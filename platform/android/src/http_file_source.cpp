@@ -191,4 +191,8 @@ std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource,
     return std::make_unique<HTTPRequest>(*impl->env, resource, callback);
 }
 
+void HTTPFileSource::setConnectionOptions(const HTTPConnectionOptions&) {
+    // Connection reuse is managed by the platform's networking stack.
+}
+
 } // namespace mbgl
@@ -369,4 +369,8 @@ std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource,
     return std::move(request);
 }
 
+void HTTPFileSource::setConnectionOptions(const HTTPConnectionOptions&) {
+    // NSURLSession negotiates HTTP/2 and pools connections on its own.
+}
+
 }
@@ -16,21 +16,27 @@ static constexpr const char* mergeSideloadedDatabaseSQL =
 "      r.id AS main_region_id\n"
 "    FROM side.regions sr\n"
 "    JOIN regions r ON sr.definition = r.definition  AND sr.description IS r.description;\n"
+"INSERT OR IGNORE INTO tile_templates (url_template)\n"
+"    SELECT DISTINCT st.url_template\n"
+"    FROM side.region_tiles srt JOIN side_tiles st ON srt.tile_id = st.id;\n"
 "REPLACE INTO tiles\n"
 "    SELECT t.id,\n"
-"        st.url_template, st.pixel_ratio, st.z, st.x, st.y,\n"
-"        st.expires, st.modified, st.etag, st.data, st.compressed, st.accessed, st.must_revalidate\n"
-"    FROM (SELECT DISTINCT sti.* FROM side.region_tiles srt JOIN side.tiles sti ON srt.tile_id = sti.id)\n"
+"        tt.id, st.pixel_ratio, st.tile_key,\n"
+"        st.expires, st.modified, st.etag, st.data, st.compressed, st.accessed, st.must_revalidate,\n"
+"        NULL\n"
+"    FROM (SELECT DISTINCT sti.* FROM side.region_tiles srt JOIN side_tiles sti ON srt.tile_id = sti.id)\n"
 "    AS st\n"
-"    LEFT JOIN tiles t ON st.url_template = t.url_template AND st.pixel_ratio = t.pixel_ratio AND st.z = t.z AND st.x = t.x AND st.y = t.y\n"
+"    JOIN tile_templates tt ON st.url_template = tt.url_template\n"
+"    LEFT JOIN tiles t ON tt.id = t.template_id AND st.pixel_ratio = t.pixel_ratio AND st.tile_key = t.tile_key\n"
 "        WHERE t.id IS NULL\n"
 "        OR st.modified > t.modified;\n"
 "INSERT OR IGNORE INTO region_tiles\n"
 "    SELECT rm.main_region_id, sti.id\n"
 "    FROM side.region_tiles srt\n"
 "    JOIN region_mapping rm ON srt.region_id = rm.side_region_id\n"
-"    JOIN (SELECT t.id, st.id AS side_tile_id FROM side.tiles st\n"
-"            JOIN tiles t ON st.url_template = t.url_template AND st.pixel_ratio = t.pixel_ratio AND st.z = t.z AND st.x = t.x AND st.y = t.y\n"
+"    JOIN (SELECT t.id, st.id AS side_tile_id FROM side_tiles st\n"
+"            JOIN tile_templates tt ON st.url_template = tt.url_template\n"
+"            JOIN tiles t ON tt.id = t.template_id AND st.pixel_ratio = t.pixel_ratio AND st.tile_key = t.tile_key\n"
 "    ) AS sti ON srt.tile_id = sti.side_tile_id;\n"
 "REPLACE INTO resources\n"
 "    SELECT r.id, \n"
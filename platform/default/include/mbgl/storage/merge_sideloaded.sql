@@ -11,13 +11,21 @@ CREATE TEMPORARY TABLE region_mapping AS
     JOIN regions r ON sr.definition = r.definition  AND sr.description IS r.description;
 
 --Insert /Update tiles
+-- side_tiles is a temporary view over side.tiles with the columns of a version 6 tiles table,
+-- except for the coordinates which are packed into tile_key.
+INSERT OR IGNORE INTO tile_templates (url_template)
+    SELECT DISTINCT st.url_template
+    FROM side.region_tiles srt JOIN side_tiles st ON srt.tile_id = st.id;
+
 REPLACE INTO tiles
     SELECT t.id, -- use the old ID in case we run a REPLACE. If it doesn't exist yet, it'll be NULL which will auto-assign a new ID.
-        st.url_template, st.pixel_ratio, st.z, st.x, st.y,
-        st.expires, st.modified, st.etag, st.data, st.compressed, st.accessed, st.must_revalidate
-    FROM (SELECT DISTINCT sti.* FROM side.region_tiles srt JOIN side.tiles sti ON srt.tile_id = sti.id)   -- ensure that we're only considering region tiles, and not ambient tiles.
+        tt.id, st.pixel_ratio, st.tile_key,
+        st.expires, st.modified, st.etag, st.data, st.compressed, st.accessed, st.must_revalidate,
+        NULL -- blob_id; merged tiles keep their data inline.
+    FROM (SELECT DISTINCT sti.* FROM side.region_tiles srt JOIN side_tiles sti ON srt.tile_id = sti.id)   -- ensure that we're only considering region tiles, and not ambient tiles.
     AS st
-    LEFT JOIN tiles t ON st.url_template = t.url_template AND st.pixel_ratio = t.pixel_ratio AND st.z = t.z AND st.x = t.x AND st.y = t.y
+    JOIN tile_templates tt ON st.url_template = tt.url_template
+    LEFT JOIN tiles t ON tt.id = t.template_id AND st.pixel_ratio = t.pixel_ratio AND st.tile_key = t.tile_key
         WHERE t.id IS NULL -- only consider tiles that don't exist yet in the original database.
         OR st.modified > t.modified; -- ...or tiles that are newer in the side loaded DB.
 
@@ -26,8 +34,9 @@ INSERT OR IGNORE INTO region_tiles
     SELECT rm.main_region_id, sti.id
     FROM side.region_tiles srt
     JOIN region_mapping rm ON srt.region_id = rm.side_region_id
-    JOIN (SELECT t.id, st.id AS side_tile_id FROM side.tiles st
-            JOIN tiles t ON st.url_template = t.url_template AND st.pixel_ratio = t.pixel_ratio AND st.z = t.z AND st.x = t.x AND st.y = t.y
+    JOIN (SELECT t.id, st.id AS side_tile_id FROM side_tiles st
+            JOIN tile_templates tt ON st.url_template = tt.url_template
+            JOIN tiles t ON tt.id = t.template_id AND st.pixel_ratio = t.pixel_ratio AND st.tile_key = t.tile_key
     ) AS sti ON srt.tile_id = sti.side_tile_id;
 
 -- copy over resources
@@ -13,6 +13,7 @@
 #include <memory>
 #include <string>
 #include <list>
+#include <vector>
 
 namespace mapbox {
 namespace sqlite {
@@ -80,11 +81,20 @@ public:
     // Return value is (response, stored size)
     optional<std::pair<Response, uint64_t>> getRegionResource(int64_t regionID, const Resource&);
     optional<int64_t> hasRegionResource(int64_t regionID, const Resource&);
+    // Batched variant of hasRegionResource(), returning the stored size of each resource, in
+    // order. Tiles are looked up by their exact keys, in batches of up to 256 tiles per query.
+    std::vector<optional<int64_t>> hasRegionResources(int64_t regionID, const std::vector<Resource>&);
     uint64_t putRegionResource(int64_t regionID, const Resource&, const Response&);
     void putRegionResources(int64_t regionID, const std::list<std::tuple<Resource, Response>>&, OfflineRegionStatus&);
 
     expected<OfflineRegionDefinition, std::exception_ptr> getRegionDefinition(int64_t regionID);
+    // Reads the completed counts and sizes maintained in region_stats. The required resource count
+    // is included, and marked as precise, if it was stored with setRegionRequiredResourceCount().
     expected<OfflineRegionStatus, std::exception_ptr> getRegionCompletedStatus(int64_t regionID);
+    // Stores the precise required resource count, computed from the style and TileJSON resources
+    // at `resourceURLs`. Changes to these resources only clear the stored count if they belong to
+    // the region, so nothing is stored if any of them doesn't.
+    void setRegionRequiredResourceCount(int64_t regionID, uint64_t, const std::vector<std::string>& resourceURLs);
 
     std::exception_ptr setMaximumAmbientCacheSize(uint64_t);
     void setOfflineMapboxTileCountLimit(uint64_t);
@@ -93,6 +103,10 @@ public:
     uint64_t getOfflineMapboxTileCount();
     bool exceedsOfflineMapboxTileCountLimit(const Resource&);
 
+    // When enabled (the default), tiles written for offline regions store their data in a blob
+    // shared by all tiles with identical data. Ambient cache tiles always store their own copy.
+    void setTileDeduplication(bool);
+
 private:
     void initialize();
     void handleError(const mapbox::sqlite::Exception&, const char* action);
@@ -104,6 +118,10 @@ private:
     void migrateToVersion5();
     void migrateToVersion3();
     void migrateToVersion6();
+    void migrateToVersion7();
+    void migrateToVersion8();
+    void migrateToVersion9();
+    void rebuildRegionStats();
     void cleanup();
     bool disabled();
 
@@ -111,8 +129,12 @@ private:
 
     optional<std::pair<Response, uint64_t>> getTile(const Resource::TileData&);
     optional<int64_t> hasTile(const Resource::TileData&);
+    void hasRegionTiles(int64_t regionID, const std::vector<Resource>&, const std::vector<std::size_t>& indices,
+                        std::vector<optional<int64_t>>& sizes);
     bool putTile(const Resource::TileData&, const Response&,
-                 const std::string&, bool compressed);
+                 const std::string&, bool compressed, bool deduplicate);
+    // Returns the id of the blob holding the given data, adding it if there is none yet.
+    int64_t putTileBlob(const std::string&);
 
     optional<std::pair<Response, uint64_t>> getResource(const Resource&);
     optional<int64_t> hasResource(const Resource&);
@@ -128,8 +150,6 @@ private:
     // Return value is true iff the resource was previously unused by any other regions.
     bool markUsed(int64_t regionID, const Resource&);
 
-    std::pair<int64_t, int64_t> getCompletedResourceCountAndSize(int64_t regionID);
-    std::pair<int64_t, int64_t> getCompletedTileCountAndSize(int64_t regionID);
 
     std::string path;
     std::unique_ptr<mapbox::sqlite::Database> db;
@@ -142,6 +162,7 @@ private:
     uint64_t offlineMapboxTileCountLimit = util::mapbox::DEFAULT_OFFLINE_TILE_COUNT_LIMIT;
 
     optional<uint64_t> offlineMapboxTileCount;
+    bool tileDeduplication = true;
 
     bool evict(uint64_t neededFreeSize);
 };
@@ -8,6 +8,7 @@
 #include <unordered_set>
 #include <memory>
 #include <deque>
+#include <vector>
 
 namespace mbgl {
 
@@ -47,9 +48,20 @@ private:
      * is deactivated, all in progress requests are cancelled.
      */
     void ensureResource(const Resource&, std::function<void (Response)> = {});
-
+    // Checks the next batch of tiles against the database at once; tiles that are missing are
+    // queued in `tilesMissing` for download.
+    void ensureTiles();
+    // Requests a resource known to be missing from the database and stores the response.
+    void downloadResource(const Resource&, std::function<void (Response)> = {});
+
+    // Stores the buffered responses; returns false if the tile count limit was exceeded.
+    bool flushBuffer();
     void onMapboxTileCountLimitExceeded();
 
+    // Returns the next tile to download, if any, advancing the tile cursors.
+    optional<Resource> nextTileResource();
+    bool hasRemainingResources() const;
+
     int64_t id;
     OfflineRegionDefinition definition;
     OfflineDatabase& offlineDatabase;
@@ -59,7 +71,15 @@ private:
 
     std::list<std::unique_ptr<AsyncRequest>> requests;
     std::unordered_set<std::string> requiredSourceURLs;
+    // The style and TileJSON URLs that the required resource count is computed from.
+    std::vector<std::string> countedResourceURLs;
     std::deque<Resource> resourcesRemaining;
+    // Tiles are enumerated from the region's geometry as request slots free up, instead of queueing
+    // a Resource for every tile of the region up front.
+    class TileCursor;
+    std::deque<std::unique_ptr<TileCursor>> tilesRemaining;
+    std::deque<Resource> tilesMissing;
+    bool checkingTiles = false;
     std::list<std::tuple<Resource, Response>> buffer;
 
     void queueResource(Resource&&);
@@ -19,13 +19,21 @@ static constexpr const char* offlineDatabaseSchema =
 "  must_revalidate INTEGER NOT NULL DEFAULT 0,\n"
 "  UNIQUE (url)\n"
 ");\n"
-"CREATE TABLE tiles (\n"
+"CREATE TABLE tile_templates (\n"
 "  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,\n"
 "  url_template TEXT NOT NULL,\n"
+"  UNIQUE (url_template)\n"
+");\n"
+"CREATE TABLE tile_blobs (\n"
+"  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,\n"
+"  hash INTEGER NOT NULL,\n"
+"  data BLOB NOT NULL\n"
+");\n"
+"CREATE TABLE tiles (\n"
+"  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,\n"
+"  template_id INTEGER NOT NULL REFERENCES tile_templates(id),\n"
 "  pixel_ratio INTEGER NOT NULL,\n"
-"  z INTEGER NOT NULL,\n"
-"  x INTEGER NOT NULL,\n"
-"  y INTEGER NOT NULL,\n"
+"  tile_key INTEGER NOT NULL,\n"
 "  expires INTEGER,\n"
 "  modified INTEGER,\n"
 "  etag TEXT,\n"
@@ -33,7 +41,8 @@ static constexpr const char* offlineDatabaseSchema =
 "  compressed INTEGER NOT NULL DEFAULT 0,\n"
 "  accessed INTEGER NOT NULL,\n"
 "  must_revalidate INTEGER NOT NULL DEFAULT 0,\n"
-"  UNIQUE (url_template, pixel_ratio, z, x, y)\n"
+"  blob_id INTEGER REFERENCES tile_blobs(id),\n"
+"  UNIQUE (template_id, pixel_ratio, tile_key)\n"
 ");\n"
 "CREATE TABLE regions (\n"
 "  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,\n"
@@ -50,6 +59,66 @@ static constexpr const char* offlineDatabaseSchema =
 "  tile_id INTEGER NOT NULL REFERENCES tiles(id),\n"
 "  UNIQUE (region_id, tile_id)\n"
 ");\n"
+"CREATE TABLE region_stats (\n"
+"  region_id INTEGER NOT NULL PRIMARY KEY REFERENCES regions(id) ON DELETE CASCADE,\n"
+"  completed_resource_count INTEGER NOT NULL DEFAULT 0,\n"
+"  completed_resource_size INTEGER NOT NULL DEFAULT 0,\n"
+"  completed_tile_count INTEGER NOT NULL DEFAULT 0,\n"
+"  completed_tile_size INTEGER NOT NULL DEFAULT 0,\n"
+"  required_resource_count INTEGER\n"
+");\n"
+"CREATE TRIGGER regions_insert_stats AFTER INSERT ON regions\n"
+"BEGIN\n"
+"  INSERT INTO region_stats (region_id) VALUES (NEW.id);\n"
+"END;\n"
+"CREATE TRIGGER region_resources_insert_stats AFTER INSERT ON region_resources\n"
+"BEGIN\n"
+"  UPDATE region_stats\n"
+"  SET completed_resource_count = completed_resource_count + 1,\n"
+"      completed_resource_size = completed_resource_size + ifnull((SELECT length(data) FROM resources WHERE id = NEW.resource_id), 0)\n"
+"  WHERE region_id = NEW.region_id;\n"
+"END;\n"
+"CREATE TRIGGER region_tiles_insert_stats AFTER INSERT ON region_tiles\n"
+"BEGIN\n"
+"  UPDATE region_stats\n"
+"  SET completed_tile_count = completed_tile_count + 1,\n"
+"      completed_tile_size = completed_tile_size + ifnull((SELECT ifnull(length(tiles.data), (SELECT length(tile_blobs.data) FROM tile_blobs WHERE tile_blobs.id = tiles.blob_id))\n"
+"                                                          FROM tiles WHERE tiles.id = NEW.tile_id), 0)\n"
+"  WHERE region_id = NEW.region_id;\n"
+"END;\n"
+"CREATE TRIGGER resources_update_stats AFTER UPDATE OF data ON resources\n"
+"BEGIN\n"
+"  UPDATE region_stats\n"
+"  SET completed_resource_size = completed_resource_size - ifnull(length(OLD.data), 0) + ifnull(length(NEW.data), 0),\n"
+"      required_resource_count = CASE WHEN NEW.kind IN (1, 2) AND OLD.data IS NOT NEW.data\n"
+"                                     THEN NULL\n"
+"                                     ELSE required_resource_count END\n"
+"  WHERE region_id IN (SELECT region_id FROM region_resources WHERE resource_id = NEW.id);\n"
+"END;\n"
+"CREATE TRIGGER tiles_update_remove_stats BEFORE UPDATE OF data, blob_id ON tiles\n"
+"BEGIN\n"
+"  UPDATE region_stats\n"
+"  SET completed_tile_size = completed_tile_size - ifnull(length(OLD.data), ifnull((SELECT length(data) FROM tile_blobs WHERE id = OLD.blob_id), 0))\n"
+"  WHERE region_id IN (SELECT region_id FROM region_tiles WHERE tile_id = OLD.id);\n"
+"END;\n"
+"CREATE TRIGGER tiles_update_add_stats AFTER UPDATE OF data, blob_id ON tiles\n"
+"BEGIN\n"
+"  UPDATE region_stats\n"
+"  SET completed_tile_size = completed_tile_size + ifnull(length(NEW.data), ifnull((SELECT length(data) FROM tile_blobs WHERE id = NEW.blob_id), 0))\n"
+"  WHERE region_id IN (SELECT region_id FROM region_tiles WHERE tile_id = NEW.id);\n"
+"END;\n"
+"CREATE TRIGGER tiles_delete_blob AFTER DELETE ON tiles\n"
+"WHEN OLD.blob_id IS NOT NULL\n"
+"BEGIN\n"
+"  DELETE FROM tile_blobs\n"
+"  WHERE id = OLD.blob_id AND NOT EXISTS (SELECT 1 FROM tiles WHERE blob_id = OLD.blob_id);\n"
+"END;\n"
+"CREATE TRIGGER tiles_update_blob AFTER UPDATE OF blob_id ON tiles\n"
+"WHEN OLD.blob_id IS NOT NULL AND OLD.blob_id IS NOT NEW.blob_id\n"
+"BEGIN\n"
+"  DELETE FROM tile_blobs\n"
+"  WHERE id = OLD.blob_id AND NOT EXISTS (SELECT 1 FROM tiles WHERE blob_id = OLD.blob_id);\n"
+"END;\n"
 "CREATE INDEX resources_accessed\n"
 "ON resources (accessed);\n"
 "CREATE INDEX tiles_accessed\n"
@@ -58,6 +127,10 @@ static constexpr const char* offlineDatabaseSchema =
 "ON region_resources (resource_id);\n"
 "CREATE INDEX region_tiles_tile_id\n"
 "ON region_tiles (tile_id);\n"
+"CREATE INDEX tile_blobs_hash\n"
+"ON tile_blobs (hash);\n"
+"CREATE INDEX tiles_blob_id\n"
+"ON tiles (blob_id);\n"
 ;
 
 } // namespace mbgl
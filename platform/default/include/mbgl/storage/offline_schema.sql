@@ -12,13 +12,23 @@ CREATE TABLE resources (                   -- Generic table for style, source, s
   UNIQUE (url)
 );
 
-CREATE TABLE tiles (
+CREATE TABLE tile_templates (              -- URL templates of tile sources, shared by all their tiles.
   id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
   url_template TEXT NOT NULL,
+  UNIQUE (url_template)
+);
+
+CREATE TABLE tile_blobs (                  -- Tile payloads stored once for all tiles with identical data.
+  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
+  hash INTEGER NOT NULL,                    -- 64-bit FNV-1a hash of data.
+  data BLOB NOT NULL
+);
+
+CREATE TABLE tiles (
+  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
+  template_id INTEGER NOT NULL REFERENCES tile_templates(id),
   pixel_ratio INTEGER NOT NULL,
-  z INTEGER NOT NULL,
-  x INTEGER NOT NULL,
-  y INTEGER NOT NULL,
+  tile_key INTEGER NOT NULL,                -- Tile coordinates packed as (z << 58) | (y << 29) | x.
   expires INTEGER,
   modified INTEGER,
   etag TEXT,
@@ -26,7 +36,8 @@ CREATE TABLE tiles (
   compressed INTEGER NOT NULL DEFAULT 0,
   accessed INTEGER NOT NULL,
   must_revalidate INTEGER NOT NULL DEFAULT 0,
-  UNIQUE (url_template, pixel_ratio, z, x, y)
+  blob_id INTEGER REFERENCES tile_blobs(id), -- Set instead of data when the payload is deduplicated.
+  UNIQUE (template_id, pixel_ratio, tile_key)
 );
 
 CREATE TABLE regions (
@@ -49,6 +60,79 @@ CREATE TABLE region_tiles (
   UNIQUE (region_id, tile_id)
 );
 
+CREATE TABLE region_stats (                -- Status of each region, kept up to date by the triggers below.
+  region_id INTEGER NOT NULL PRIMARY KEY REFERENCES regions(id) ON DELETE CASCADE,
+  completed_resource_count INTEGER NOT NULL DEFAULT 0,  -- Excluding tiles.
+  completed_resource_size INTEGER NOT NULL DEFAULT 0,
+  completed_tile_count INTEGER NOT NULL DEFAULT 0,
+  completed_tile_size INTEGER NOT NULL DEFAULT 0,
+  required_resource_count INTEGER                       -- Precise count, once known.
+);
+
+CREATE TRIGGER regions_insert_stats AFTER INSERT ON regions
+BEGIN
+  INSERT INTO region_stats (region_id) VALUES (NEW.id);
+END;
+
+CREATE TRIGGER region_resources_insert_stats AFTER INSERT ON region_resources
+BEGIN
+  UPDATE region_stats
+  SET completed_resource_count = completed_resource_count + 1,
+      completed_resource_size = completed_resource_size + ifnull((SELECT length(data) FROM resources WHERE id = NEW.resource_id), 0)
+  WHERE region_id = NEW.region_id;
+END;
+
+CREATE TRIGGER region_tiles_insert_stats AFTER INSERT ON region_tiles
+BEGIN
+  UPDATE region_stats
+  SET completed_tile_count = completed_tile_count + 1,
+      completed_tile_size = completed_tile_size + ifnull((SELECT ifnull(length(tiles.data), (SELECT length(tile_blobs.data) FROM tile_blobs WHERE tile_blobs.id = tiles.blob_id))
+                                                          FROM tiles WHERE tiles.id = NEW.tile_id), 0)
+  WHERE region_id = NEW.region_id;
+END;
+
+CREATE TRIGGER resources_update_stats AFTER UPDATE OF data ON resources
+BEGIN
+  UPDATE region_stats
+  SET completed_resource_size = completed_resource_size - ifnull(length(OLD.data), 0) + ifnull(length(NEW.data), 0),
+      required_resource_count = CASE WHEN NEW.kind IN (1, 2) AND OLD.data IS NOT NEW.data  -- A changed style or source
+                                     THEN NULL                                             -- may require other resources.
+                                     ELSE required_resource_count END
+  WHERE region_id IN (SELECT region_id FROM region_resources WHERE resource_id = NEW.id);
+END;
+
+-- The old size is taken before the update, while a blob that the tile stops referencing still exists.
+CREATE TRIGGER tiles_update_remove_stats BEFORE UPDATE OF data, blob_id ON tiles
+BEGIN
+  UPDATE region_stats
+  SET completed_tile_size = completed_tile_size - ifnull(length(OLD.data), ifnull((SELECT length(data) FROM tile_blobs WHERE id = OLD.blob_id), 0))
+  WHERE region_id IN (SELECT region_id FROM region_tiles WHERE tile_id = OLD.id);
+END;
+
+CREATE TRIGGER tiles_update_add_stats AFTER UPDATE OF data, blob_id ON tiles
+BEGIN
+  UPDATE region_stats
+  SET completed_tile_size = completed_tile_size + ifnull(length(NEW.data), ifnull((SELECT length(data) FROM tile_blobs WHERE id = NEW.blob_id), 0))
+  WHERE region_id IN (SELECT region_id FROM region_tiles WHERE tile_id = NEW.id);
+END;
+
+-- Blobs are removed along with the last tile referencing them, whether it is evicted, deleted
+-- with its region, or updated with another payload.
+
+CREATE TRIGGER tiles_delete_blob AFTER DELETE ON tiles
+WHEN OLD.blob_id IS NOT NULL
+BEGIN
+  DELETE FROM tile_blobs
+  WHERE id = OLD.blob_id AND NOT EXISTS (SELECT 1 FROM tiles WHERE blob_id = OLD.blob_id);
+END;
+
+CREATE TRIGGER tiles_update_blob AFTER UPDATE OF blob_id ON tiles
+WHEN OLD.blob_id IS NOT NULL AND OLD.blob_id IS NOT NEW.blob_id
+BEGIN
+  DELETE FROM tile_blobs
+  WHERE id = OLD.blob_id AND NOT EXISTS (SELECT 1 FROM tiles WHERE blob_id = OLD.blob_id);
+END;
+
 -- Indexes for efficient eviction queries
 
 CREATE INDEX resources_accessed
@@ -62,3 +146,11 @@ ON region_resources (resource_id);
 
 CREATE INDEX region_tiles_tile_id
 ON region_tiles (tile_id);
+
+-- Indexes for deduplicating tile payloads and releasing them
+
+CREATE INDEX tile_blobs_hash
+ON tile_blobs (hash);
+
+CREATE INDEX tiles_blob_id
+ON tiles (blob_id);
@@ -2,6 +2,7 @@
 #include <mbgl/storage/asset_file_source.hpp>
 #include <mbgl/storage/file_source_request.hpp>
 #include <mbgl/storage/local_file_source.hpp>
+#include <mbgl/storage/mbtiles_file_source.hpp>
 #include <mbgl/storage/online_file_source.hpp>
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/offline_download.hpp>
@@ -114,6 +115,13 @@ public:
         } else if (LocalFileSource::acceptsURL(resource.url)) {
             //Local file request
             tasks[req] = localFileSource->request(resource, callback);
+        } else if (MBTilesFileSource::acceptsURL(resource.url)) {
+            //MBTiles file request
+            if (!mbtilesFileSource) {
+                // Its reader threads are only started once MBTiles files are in use.
+                mbtilesFileSource = std::make_unique<MBTilesFileSource>(2, mbtilesMmapSize);
+            }
+            tasks[req] = mbtilesFileSource->request(resource, callback);
         } else {
             // Try the offline database
             if (resource.hasLoadingMethod(Resource::LoadingMethod::Cache)) {
@@ -144,6 +152,7 @@ public:
                     resource.priorData = offlineResponse->data;
 
                     if (offlineResponse->isUsable()) {
+                        resource.priorUsable = true;
                         callback(*offlineResponse);
                     }
                 }
@@ -176,6 +185,25 @@ public:
         offlineDatabase->setOfflineMapboxTileCountLimit(limit);
     }
 
+    void setMaximumConcurrentRequests(uint32_t maximumConcurrentRequests) {
+        onlineFileSource.setMaximumConcurrentRequests(maximumConcurrentRequests);
+    }
+
+    void setMaximumConcurrentRevalidations(uint32_t maximumConcurrentRevalidations) {
+        onlineFileSource.setMaximumConcurrentRevalidations(maximumConcurrentRevalidations);
+    }
+
+    void setConnectionOptions(const HTTPConnectionOptions& options) {
+        onlineFileSource.setConnectionOptions(options);
+    }
+
+    void setMBTilesMmapSize(uint64_t size) {
+        mbtilesMmapSize = size;
+        if (mbtilesFileSource) {
+            mbtilesFileSource->setMmapSize(size);
+        }
+    }
+
     void setOnlineStatus(const bool status) {
         onlineFileSource.setOnlineStatus(status);
     }
@@ -218,6 +246,8 @@ private:
     // shared so that destruction is done on the creating thread
     const std::shared_ptr<FileSource> assetFileSource;
     const std::unique_ptr<FileSource> localFileSource;
+    std::unique_ptr<MBTilesFileSource> mbtilesFileSource;
+    uint64_t mbtilesMmapSize = 0;
     std::unique_ptr<OfflineDatabase> offlineDatabase;
     OnlineFileSource onlineFileSource;
     std::unordered_map<AsyncRequest*, std::unique_ptr<AsyncRequest>> tasks;
@@ -332,6 +362,22 @@ void DefaultFileSource::setOfflineMapboxTileCountLimit(uint64_t limit) const {
     impl->actor().invoke(&Impl::setOfflineMapboxTileCountLimit, limit);
 }
 
+void DefaultFileSource::setMaximumConcurrentRequests(uint32_t maximumConcurrentRequests) const {
+    impl->actor().invoke(&Impl::setMaximumConcurrentRequests, maximumConcurrentRequests);
+}
+
+void DefaultFileSource::setMaximumConcurrentRevalidations(uint32_t maximumConcurrentRevalidations) const {
+    impl->actor().invoke(&Impl::setMaximumConcurrentRevalidations, maximumConcurrentRevalidations);
+}
+
+void DefaultFileSource::setConnectionOptions(const HTTPConnectionOptions& options) const {
+    impl->actor().invoke(&Impl::setConnectionOptions, options);
+}
+
+void DefaultFileSource::setMBTilesMmapSize(uint64_t size) const {
+    impl->actor().invoke(&Impl::setMBTilesMmapSize, size);
+}
+
 void DefaultFileSource::pause() {
     impl->pause();
 }
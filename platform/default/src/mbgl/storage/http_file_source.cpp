@@ -48,6 +48,8 @@ namespace curl {
     X(multi_setopt) \
     X(share_init) \
     X(share_cleanup) \
+    X(share_setopt) \
+    X(share_strerror) \
     X(slist_append) \
     X(slist_free_all)
 
@@ -110,6 +112,27 @@ static void handleError(CURLcode code) {
     }
 }
 
+static void handleError(CURLSHcode code) {
+    if (code != CURLSHE_OK) {
+        throw std::runtime_error(std::string("CURL share error: ") + curl::share_strerror(code));
+    }
+}
+
+// Connection tuning options are best-effort: the libcurl we load at runtime may be older than the
+// headers we compiled against, or may have been built without HTTP/2 support.
+static void handleOptionalError(CURLMcode code) {
+    if (code != CURLM_UNKNOWN_OPTION) {
+        handleError(code);
+    }
+}
+
+static void handleOptionalError(CURLcode code) {
+    if (code != CURLE_UNKNOWN_OPTION && code != CURLE_NOT_BUILT_IN &&
+        code != CURLE_UNSUPPORTED_PROTOCOL) {
+        handleError(code);
+    }
+}
+
 namespace mbgl {
 
 class HTTPFileSource::Impl {
@@ -125,6 +148,8 @@ public:
     CURL *getHandle();
     void returnHandle(CURL *handle);
     void checkMultiInfo();
+    void setConnectionOptions(const HTTPConnectionOptions&);
+    void applyConnectionOptions(CURL *handle) const;
 
     // Used as the CURL timer function to periodically check for socket updates.
     util::Timer timeout;
@@ -133,9 +158,11 @@ public:
     // block and spawn threads.
     CURLM *multi = nullptr;
 
-    // CURL share handles are used for sharing session state (e.g.)
+    // CURL share handles are used for sharing session state (DNS cache and TLS sessions)
     CURLSH *share = nullptr;
 
+    HTTPConnectionOptions options;
+
     // A queue that we use for storing resuable CURL easy handles to avoid creating and destroying
     // them all the time.
     std::queue<CURL *> handles;
@@ -175,12 +202,16 @@ HTTPFileSource::Impl::Impl() {
     }
 
     share = curl::share_init();
+    handleError(curl::share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS));
+    handleError(curl::share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION));
 
     multi = curl::multi_init();
     handleError(curl::multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, handleSocket));
     handleError(curl::multi_setopt(multi, CURLMOPT_SOCKETDATA, this));
     handleError(curl::multi_setopt(multi, CURLMOPT_TIMERFUNCTION, startTimeout));
     handleError(curl::multi_setopt(multi, CURLMOPT_TIMERDATA, this));
+
+    setConnectionOptions(options);
 }
 
 HTTPFileSource::Impl::~Impl() {
@@ -213,6 +244,44 @@ void HTTPFileSource::Impl::returnHandle(CURL *handle) {
     handles.push(handle);
 }
 
+void HTTPFileSource::Impl::setConnectionOptions(const HTTPConnectionOptions& options_) {
+    options = options_;
+
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (43) << 8 | 0) // Added in 7.43.0
+    handleOptionalError(curl::multi_setopt(multi, CURLMOPT_PIPELINING,
+                                           long(options.multiplex ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING)));
+#endif
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (30) << 8 | 0) // Added in 7.30.0
+    handleOptionalError(curl::multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS,
+                                           long(options.maxConnectionsPerHost)));
+#endif
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (67) << 8 | 0) // Added in 7.67.0
+    if (options.maxStreamsPerConnection > 0) {
+        handleOptionalError(curl::multi_setopt(multi, CURLMOPT_MAX_CONCURRENT_STREAMS,
+                                               long(options.maxStreamsPerConnection)));
+    }
+#endif
+}
+
+void HTTPFileSource::Impl::applyConnectionOptions(CURL *handle) const {
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (47) << 8 | 0) // Added in 7.47.0
+    handleOptionalError(curl::easy_setopt(handle, CURLOPT_HTTP_VERSION,
+                                          long(options.multiplex ? CURL_HTTP_VERSION_2TLS : CURL_HTTP_VERSION_1_1)));
+#endif
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (43) << 8 | 0) // Added in 7.43.0
+    // Wait for a pending connection that may be multiplexed rather than opening another one.
+    handleOptionalError(curl::easy_setopt(handle, CURLOPT_PIPEWAIT, long(options.multiplex)));
+#endif
+#if LIBCURL_VERSION_NUM >= ((7) << 16 | (25) << 8 | 0) // Added in 7.25.0
+    if (options.keepAliveIdle.count() > 0) {
+        handleOptionalError(curl::easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L));
+        handleOptionalError(curl::easy_setopt(handle, CURLOPT_TCP_KEEPIDLE, long(options.keepAliveIdle.count())));
+        handleOptionalError(curl::easy_setopt(handle, CURLOPT_TCP_KEEPINTVL, long(options.keepAliveIdle.count())));
+    }
+#endif
+    handleError(curl::easy_setopt(handle, CURLOPT_DNS_CACHE_TIMEOUT, long(options.dnsCacheTimeout.count())));
+}
+
 void HTTPFileSource::Impl::checkMultiInfo() {
     CURLMsg *message = nullptr;
     int pending = 0;
@@ -339,6 +408,7 @@ HTTPRequest::HTTPRequest(HTTPFileSource::Impl* context_, Resource resource_, Fil
 #endif
     handleError(curl::easy_setopt(handle, CURLOPT_USERAGENT, "MapboxGL/1.0"));
     handleError(curl::easy_setopt(handle, CURLOPT_SHARE, context->share));
+    context->applyConnectionOptions(handle);
 
     // Start requesting the information.
     handleError(curl::multi_add_handle(context->multi, handle));
@@ -492,4 +562,8 @@ std::unique_ptr<AsyncRequest> HTTPFileSource::request(const Resource& resource,
     return std::make_unique<HTTPRequest>(impl.get(), resource, callback);
 }
 
+void HTTPFileSource::setConnectionOptions(const HTTPConnectionOptions& options) {
+    impl->setConnectionOptions(options);
+}
+
 } // namespace mbgl
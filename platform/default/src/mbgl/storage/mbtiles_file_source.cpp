@@ -0,0 +1,218 @@
+#include <mbgl/storage/mbtiles_file_source.hpp>
+#include <mbgl/storage/file_source_request.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/storage/sqlite3.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/thread.hpp>
+#include <mbgl/util/url.hpp>
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+const std::string mbtilesProtocol = "mbtiles://";
+
+} // namespace
+
+namespace mbgl {
+
+class MBTilesFileSource::Impl {
+public:
+    Impl(ActorRef<Impl>, uint64_t mmapSize_) : mmapSize(mmapSize_) {}
+
+    void request(const Resource& resource, ActorRef<FileSourceRequest> req) {
+        Response response;
+
+        try {
+            if (!acceptsURL(resource.url)) {
+                response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other,
+                                                                   "Invalid MBTiles URL");
+            } else if (Connection* connection = getConnection(resource.url, response)) {
+                if (resource.kind == Resource::Kind::Tile) {
+                    readTile(*connection, resource, response);
+                } else {
+                    readTileJSON(*connection, resource.url, response);
+                }
+            }
+        } catch (const std::exception& ex) {
+            response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other, ex.what());
+        }
+
+        req.invoke(&FileSourceRequest::setResponse, response);
+    }
+
+    void setMmapSize(uint64_t mmapSize_) {
+        mmapSize = mmapSize_;
+        for (auto& connection : connections) {
+            connection.second->db.exec("PRAGMA mmap_size = " + util::toString(mmapSize));
+        }
+    }
+
+private:
+    struct Connection {
+        explicit Connection(mapbox::sqlite::Database&& db_)
+            : db(std::move(db_)),
+              tileStatement(db, "SELECT tile_data FROM tiles WHERE zoom_level = ?1 AND tile_column = ?2 AND tile_row = ?3") {
+        }
+
+        mapbox::sqlite::Database db;
+        mapbox::sqlite::Statement tileStatement;
+    };
+
+    // Both the TileJSON URL and the tile URLs derived from it name the file before the query string.
+    static std::string getPath(const std::string& url) {
+        const auto end = url.find('?', mbtilesProtocol.size());
+        return util::percentDecode(url.substr(mbtilesProtocol.size(),
+                                              end == std::string::npos ? end : end - mbtilesProtocol.size()));
+    }
+
+    Connection* getConnection(const std::string& url, Response& response) {
+        const auto path = getPath(url);
+        auto it = connections.find(path);
+        if (it != connections.end()) {
+            return it->second.get();
+        }
+
+        auto result = mapbox::sqlite::Database::tryOpen(path, mapbox::sqlite::ReadOnly);
+        if (result.is<mapbox::sqlite::Exception>()) {
+            const auto& ex = result.get<mapbox::sqlite::Exception>();
+            response.error = std::make_unique<Response::Error>(
+                ex.code == mapbox::sqlite::ResultCode::CantOpen ? Response::Error::Reason::NotFound
+                                                                : Response::Error::Reason::Other,
+                ex.what());
+            return nullptr;
+        }
+
+        auto& db = result.get<mapbox::sqlite::Database>();
+        if (mmapSize) {
+            db.exec("PRAGMA mmap_size = " + util::toString(mmapSize));
+        }
+
+        auto connection = std::make_unique<Connection>(std::move(db));
+        return connections.emplace(path, std::move(connection)).first->second.get();
+    }
+
+    void readTile(Connection& connection, const Resource& resource, Response& response) {
+        if (!resource.tileData) {
+            response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other,
+                                                               "Invalid MBTiles tile URL");
+            return;
+        }
+
+        // The TileJSON declares the "tms" scheme, so tileData already carries the MBTiles row.
+        const auto& tile = *resource.tileData;
+        mapbox::sqlite::Query query{ connection.tileStatement };
+        query.bind(1, tile.z);
+        query.bind(2, tile.x);
+        query.bind(3, tile.y);
+
+        if (!query.run()) {
+            response.noContent = true;
+            return;
+        }
+
+        auto data = query.get<std::string>(0);
+        // Vector tiles are customarily stored gzipped.
+        if (data.size() >= 2 && uint8_t(data[0]) == 0x1f && uint8_t(data[1]) == 0x8b) {
+            data = util::decompress(data);
+        }
+        response.data = std::make_shared<std::string>(std::move(data));
+    }
+
+    void readTileJSON(Connection& connection, const std::string& url, Response& response) {
+        rapidjson::Document doc;
+        doc.SetObject();
+        auto& allocator = doc.GetAllocator();
+
+        const auto addNumbers = [&](const char* name, const std::string& value) {
+            rapidjson::Value array(rapidjson::kArrayType);
+            std::istringstream stream(value);
+            std::string part;
+            while (std::getline(stream, part, ',')) {
+                array.PushBack(std::stod(part), allocator);
+            }
+            doc.AddMember(rapidjson::Value(name, allocator), array, allocator);
+        };
+
+        mapbox::sqlite::Statement stmt{ connection.db, "SELECT name, value FROM metadata" };
+        mapbox::sqlite::Query query{ stmt };
+        while (query.run()) {
+            const auto name = query.get<std::string>(0);
+            const auto value = query.get<std::string>(1);
+
+            if (name == "tilejson" || name == "scheme" || name == "tiles") {
+                // Describe the file itself rather than where its tiles were fetched from.
+                continue;
+            } else if (name == "bounds" || name == "center") {
+                addNumbers(name.c_str(), value);
+            } else if (name == "minzoom" || name == "maxzoom") {
+                doc.AddMember(rapidjson::Value(name, allocator), std::stod(value), allocator);
+            } else if (name == "json") {
+                // Holds additional TileJSON members, e.g. vector_layers.
+                rapidjson::Document json(&allocator);
+                json.Parse(value.c_str());
+                if (json.IsObject()) {
+                    for (auto it = json.MemberBegin(); it != json.MemberEnd(); ++it) {
+                        doc.AddMember(it->name, it->value, allocator);
+                    }
+                }
+            } else {
+                doc.AddMember(rapidjson::Value(name, allocator), rapidjson::Value(value, allocator), allocator);
+            }
+        }
+
+        rapidjson::Value tiles(rapidjson::kArrayType);
+        tiles.PushBack(rapidjson::Value(url.substr(0, url.find('?')) + "?z={z}&x={x}&y={y}", allocator),
+                       allocator);
+        doc.AddMember("tilejson", "2.2.0", allocator);
+        doc.AddMember("scheme", "tms", allocator);
+        doc.AddMember("tiles", tiles, allocator);
+
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+        doc.Accept(writer);
+
+        response.data = std::make_shared<std::string>(buffer.GetString(), buffer.GetSize());
+    }
+
+    uint64_t mmapSize;
+    std::unordered_map<std::string, std::unique_ptr<Connection>> connections;
+};
+
+MBTilesFileSource::MBTilesFileSource(std::size_t readerCount, uint64_t mmapSize) {
+    readerCount = std::max<std::size_t>(readerCount, 1);
+    readers.reserve(readerCount);
+    for (std::size_t i = 0; i < readerCount; ++i) {
+        readers.push_back(std::make_unique<util::Thread<Impl>>("MBTilesFileSource", mmapSize));
+    }
+}
+
+MBTilesFileSource::~MBTilesFileSource() = default;
+
+std::unique_ptr<AsyncRequest> MBTilesFileSource::request(const Resource& resource, Callback callback) {
+    auto req = std::make_unique<FileSourceRequest>(std::move(callback));
+
+    auto& reader = readers[nextReader++ % readers.size()];
+    reader->actor().invoke(&Impl::request, resource, req->actor());
+
+    return std::move(req);
+}
+
+void MBTilesFileSource::setMmapSize(uint64_t mmapSize) {
+    for (auto& reader : readers) {
+        reader->actor().invoke(&Impl::setMmapSize, mmapSize);
+    }
+}
+
+bool MBTilesFileSource::acceptsURL(const std::string& url) {
+    return 0 == url.rfind(mbtilesProtocol, 0);
+}
+
+} // namespace mbgl
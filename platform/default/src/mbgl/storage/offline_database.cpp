@@ -10,9 +10,61 @@
 #include <mbgl/storage/offline_schema.hpp>
 #include <mbgl/storage/merge_sideloaded.hpp>
 
+#include <map>
+#include <tuple>
+
 
 namespace mbgl {
 
+namespace {
+
+// Tiles are keyed by their coordinates packed into a single integer (see offline_schema.sql),
+// which keeps the tiles index small and orders the tiles of a zoom level by y, then x. That is
+// the order in which TileCover enumerates them, so the tiles of a download batch are next to
+// each other in the index.
+int64_t packTileKey(const Resource::TileData& tile) {
+    assert(tile.z >= 0 && tile.z < 32);
+    assert(tile.x >= 0 && tile.x < (1 << 29));
+    assert(tile.y >= 0 && tile.y < (1 << 29));
+    return (int64_t(tile.z) << 58) | (int64_t(tile.y) << 29) | int64_t(tile.x);
+}
+
+// Number of tile keys looked up by a single query in hasRegionTiles().
+constexpr const std::size_t regionTilesBatchSize = 256;
+
+// Selects the stored tiles of one tile pyramid with any of regionTilesBatchSize keys, bound to
+// parameters ?3 and up.
+const char* selectRegionTilesSQL() {
+    static const std::string sql = [] {
+        // clang-format off
+        std::string result =
+            "SELECT id, tile_key, ifnull(length(data), (SELECT length(tile_blobs.data) FROM tile_blobs WHERE tile_blobs.id = tiles.blob_id)) "
+            "FROM tiles "
+            "WHERE template_id  = (SELECT id FROM tile_templates WHERE url_template = ?1) "
+            "  AND pixel_ratio  = ?2 "
+            "  AND tile_key IN (?3";
+        // clang-format on
+        for (std::size_t i = 1; i < regionTilesBatchSize; ++i) {
+            result += ", ?" + util::toString(3 + i);
+        }
+        return result + ")";
+    }();
+    return sql.c_str();
+}
+
+// 64-bit FNV-1a. Deduplicated tile payloads are looked up by this hash and then compared
+// byte for byte, so collisions only cost an extra comparison.
+int64_t hashTileData(const std::string& data) {
+    uint64_t hash = 14695981039346656037ull;
+    for (const char c : data) {
+        hash ^= uint8_t(c);
+        hash *= 1099511628211ull;
+    }
+    return static_cast<int64_t>(hash);
+}
+
+} // namespace
+
 OfflineDatabase::OfflineDatabase(std::string path_)
     : path(std::move(path_)) {
     try {
@@ -59,6 +111,15 @@ void OfflineDatabase::initialize() {
         migrateToVersion6();
         // fall through
     case 6:
+        migrateToVersion7();
+        // fall through
+    case 7:
+        migrateToVersion8();
+        // fall through
+    case 8:
+        migrateToVersion9();
+        // fall through
+    case 9:
         // Happy path; we're done
         return;
     default:
@@ -145,7 +206,7 @@ void OfflineDatabase::createSchema() {
     db->exec("PRAGMA synchronous = FULL");
     mapbox::sqlite::Transaction transaction(*db);
     db->exec(offlineDatabaseSchema);
-    db->exec("PRAGMA user_version = 6");
+    db->exec("PRAGMA user_version = 9");
     transaction.commit();
 }
 
@@ -177,6 +238,195 @@ void OfflineDatabase::migrateToVersion6() {
     transaction.commit();
 }
 
+void OfflineDatabase::migrateToVersion7() {
+    assert(db);
+    // Rebuilding the tiles table drops the old one, which region_tiles refers to. Foreign keys
+    // can only be toggled outside of a transaction.
+    db->exec("PRAGMA foreign_keys = OFF");
+    try {
+        mapbox::sqlite::Transaction transaction(*db);
+        // clang-format off
+        db->exec(
+            "CREATE TABLE tile_templates ("
+            "  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,"
+            "  url_template TEXT NOT NULL,"
+            "  UNIQUE (url_template)"
+            ");"
+            "INSERT INTO tile_templates (url_template) "
+            "  SELECT DISTINCT url_template FROM tiles;"
+            "CREATE TABLE tiles_v7 ("
+            "  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,"
+            "  template_id INTEGER NOT NULL REFERENCES tile_templates(id),"
+            "  pixel_ratio INTEGER NOT NULL,"
+            "  tile_key INTEGER NOT NULL,"
+            "  expires INTEGER,"
+            "  modified INTEGER,"
+            "  etag TEXT,"
+            "  data BLOB,"
+            "  compressed INTEGER NOT NULL DEFAULT 0,"
+            "  accessed INTEGER NOT NULL,"
+            "  must_revalidate INTEGER NOT NULL DEFAULT 0,"
+            "  UNIQUE (template_id, pixel_ratio, tile_key)"
+            ");"
+            // Keep the tile ids, which are referenced by region_tiles.
+            "INSERT INTO tiles_v7 "
+            "  SELECT tiles.id, tile_templates.id, pixel_ratio, (z << 58) | (y << 29) | x, "
+            "         expires, modified, etag, data, compressed, accessed, must_revalidate "
+            "  FROM tiles JOIN tile_templates USING (url_template);"
+            "DROP TABLE tiles;"
+            "ALTER TABLE tiles_v7 RENAME TO tiles;"
+            "CREATE INDEX tiles_accessed ON tiles (accessed);");
+        // clang-format on
+        db->exec("PRAGMA user_version = 7");
+        transaction.commit();
+    } catch (...) {
+        // The transaction was rolled back; don't leave the connection without foreign keys.
+        db->exec("PRAGMA foreign_keys = ON");
+        throw;
+    }
+    db->exec("PRAGMA foreign_keys = ON");
+    db->exec("VACUUM");
+}
+
+void OfflineDatabase::migrateToVersion8() {
+    assert(db);
+    mapbox::sqlite::Transaction transaction(*db);
+    // clang-format off
+    db->exec(
+        "CREATE TABLE region_stats ("
+        "  region_id INTEGER NOT NULL PRIMARY KEY REFERENCES regions(id) ON DELETE CASCADE,"
+        "  completed_resource_count INTEGER NOT NULL DEFAULT 0,"
+        "  completed_resource_size INTEGER NOT NULL DEFAULT 0,"
+        "  completed_tile_count INTEGER NOT NULL DEFAULT 0,"
+        "  completed_tile_size INTEGER NOT NULL DEFAULT 0,"
+        "  required_resource_count INTEGER"
+        ");"
+        "CREATE TRIGGER regions_insert_stats AFTER INSERT ON regions "
+        "BEGIN"
+        "  INSERT INTO region_stats (region_id) VALUES (NEW.id);"
+        "END;"
+        "CREATE TRIGGER region_resources_insert_stats AFTER INSERT ON region_resources "
+        "BEGIN"
+        "  UPDATE region_stats"
+        "  SET completed_resource_count = completed_resource_count + 1,"
+        "      completed_resource_size = completed_resource_size + ifnull((SELECT length(data) FROM resources WHERE id = NEW.resource_id), 0)"
+        "  WHERE region_id = NEW.region_id;"
+        "END;"
+        "CREATE TRIGGER region_tiles_insert_stats AFTER INSERT ON region_tiles "
+        "BEGIN"
+        "  UPDATE region_stats"
+        "  SET completed_tile_count = completed_tile_count + 1,"
+        "      completed_tile_size = completed_tile_size + ifnull((SELECT length(data) FROM tiles WHERE id = NEW.tile_id), 0)"
+        "  WHERE region_id = NEW.region_id;"
+        "END;"
+        "CREATE TRIGGER resources_update_stats AFTER UPDATE OF data ON resources "
+        "BEGIN"
+        "  UPDATE region_stats"
+        "  SET completed_resource_size = completed_resource_size - ifnull(length(OLD.data), 0) + ifnull(length(NEW.data), 0),"
+        "      required_resource_count = CASE WHEN NEW.kind IN (1, 2) AND OLD.data IS NOT NEW.data"
+        "                                     THEN NULL"
+        "                                     ELSE required_resource_count END"
+        "  WHERE region_id IN (SELECT region_id FROM region_resources WHERE resource_id = NEW.id);"
+        "END;"
+        "CREATE TRIGGER tiles_update_stats AFTER UPDATE OF data ON tiles "
+        "BEGIN"
+        "  UPDATE region_stats"
+        "  SET completed_tile_size = completed_tile_size - ifnull(length(OLD.data), 0) + ifnull(length(NEW.data), 0)"
+        "  WHERE region_id IN (SELECT region_id FROM region_tiles WHERE tile_id = NEW.id);"
+        "END;"
+        "INSERT INTO region_stats (region_id) SELECT id FROM regions;"
+        "UPDATE region_stats "
+        "SET completed_resource_count = ("
+        "      SELECT COUNT(*) FROM region_resources, resources "
+        "      WHERE region_resources.region_id = region_stats.region_id AND resource_id = resources.id), "
+        "    completed_resource_size = ("
+        "      SELECT ifnull(SUM(length(data)), 0) FROM region_resources, resources "
+        "      WHERE region_resources.region_id = region_stats.region_id AND resource_id = resources.id), "
+        "    completed_tile_count = ("
+        "      SELECT COUNT(*) FROM region_tiles, tiles "
+        "      WHERE region_tiles.region_id = region_stats.region_id AND tile_id = tiles.id), "
+        "    completed_tile_size = ("
+        "      SELECT ifnull(SUM(length(data)), 0) FROM region_tiles, tiles "
+        "      WHERE region_tiles.region_id = region_stats.region_id AND tile_id = tiles.id);");
+    // clang-format on
+    db->exec("PRAGMA user_version = 8");
+    transaction.commit();
+}
+
+void OfflineDatabase::migrateToVersion9() {
+    assert(db);
+    mapbox::sqlite::Transaction transaction(*db);
+    // Existing tiles keep their data inline; only tiles written from now on share blobs.
+    // clang-format off
+    db->exec(
+        "CREATE TABLE tile_blobs ("
+        "  id INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,"
+        "  hash INTEGER NOT NULL,"
+        "  data BLOB NOT NULL"
+        ");"
+        "ALTER TABLE tiles ADD COLUMN blob_id INTEGER REFERENCES tile_blobs(id);"
+        "DROP TRIGGER region_tiles_insert_stats;"
+        "DROP TRIGGER tiles_update_stats;"
+        "CREATE TRIGGER region_tiles_insert_stats AFTER INSERT ON region_tiles "
+        "BEGIN"
+        "  UPDATE region_stats"
+        "  SET completed_tile_count = completed_tile_count + 1,"
+        "      completed_tile_size = completed_tile_size + ifnull((SELECT ifnull(length(tiles.data), (SELECT length(tile_blobs.data) FROM tile_blobs WHERE tile_blobs.id = tiles.blob_id))"
+        "                                                          FROM tiles WHERE tiles.id = NEW.tile_id), 0)"
+        "  WHERE region_id = NEW.region_id;"
+        "END;"
+        "CREATE TRIGGER tiles_update_remove_stats BEFORE UPDATE OF data, blob_id ON tiles "
+        "BEGIN"
+        "  UPDATE region_stats"
+        "  SET completed_tile_size = completed_tile_size - ifnull(length(OLD.data), ifnull((SELECT length(data) FROM tile_blobs WHERE id = OLD.blob_id), 0))"
+        "  WHERE region_id IN (SELECT region_id FROM region_tiles WHERE tile_id = OLD.id);"
+        "END;"
+        "CREATE TRIGGER tiles_update_add_stats AFTER UPDATE OF data, blob_id ON tiles "
+        "BEGIN"
+        "  UPDATE region_stats"
+        "  SET completed_tile_size = completed_tile_size + ifnull(length(NEW.data), ifnull((SELECT length(data) FROM tile_blobs WHERE id = NEW.blob_id), 0))"
+        "  WHERE region_id IN (SELECT region_id FROM region_tiles WHERE tile_id = NEW.id);"
+        "END;"
+        "CREATE TRIGGER tiles_delete_blob AFTER DELETE ON tiles "
+        "WHEN OLD.blob_id IS NOT NULL "
+        "BEGIN"
+        "  DELETE FROM tile_blobs"
+        "  WHERE id = OLD.blob_id AND NOT EXISTS (SELECT 1 FROM tiles WHERE blob_id = OLD.blob_id);"
+        "END;"
+        "CREATE TRIGGER tiles_update_blob AFTER UPDATE OF blob_id ON tiles "
+        "WHEN OLD.blob_id IS NOT NULL AND OLD.blob_id IS NOT NEW.blob_id "
+        "BEGIN"
+        "  DELETE FROM tile_blobs"
+        "  WHERE id = OLD.blob_id AND NOT EXISTS (SELECT 1 FROM tiles WHERE blob_id = OLD.blob_id);"
+        "END;"
+        "CREATE INDEX tile_blobs_hash ON tile_blobs (hash);"
+        "CREATE INDEX tiles_blob_id ON tiles (blob_id);");
+    // clang-format on
+    db->exec("PRAGMA user_version = 9");
+    transaction.commit();
+}
+
+void OfflineDatabase::rebuildRegionStats() {
+    assert(db);
+    // clang-format off
+    db->exec(
+        "UPDATE region_stats "
+        "SET completed_resource_count = ("
+        "      SELECT COUNT(*) FROM region_resources, resources "
+        "      WHERE region_resources.region_id = region_stats.region_id AND resource_id = resources.id), "
+        "    completed_resource_size = ("
+        "      SELECT ifnull(SUM(length(data)), 0) FROM region_resources, resources "
+        "      WHERE region_resources.region_id = region_stats.region_id AND resource_id = resources.id), "
+        "    completed_tile_count = ("
+        "      SELECT COUNT(*) FROM region_tiles, tiles "
+        "      WHERE region_tiles.region_id = region_stats.region_id AND tile_id = tiles.id), "
+        "    completed_tile_size = ("
+        "      SELECT ifnull(SUM(ifnull(length(tiles.data), (SELECT length(tile_blobs.data) FROM tile_blobs WHERE tile_blobs.id = tiles.blob_id))), 0) "
+        "      FROM region_tiles, tiles "
+        "      WHERE region_tiles.region_id = region_stats.region_id AND tile_id = tiles.id)");
+    // clang-format on
+}
+
 mapbox::sqlite::Statement& OfflineDatabase::getStatement(const char* sql) {
     if (!db) {
         initialize();
@@ -263,9 +513,10 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
 
     if (resource.kind == Resource::Kind::Tile) {
         assert(resource.tileData);
+        // Region tiles repeat a lot (oceans, empty land), ambient ones hardly ever.
         inserted = putTile(*resource.tileData, response,
                 compressed ? compressedData : response.data ? *response.data : "",
-                compressed);
+                compressed, !evict_ && tileDeduplication);
     } else {
         inserted = putResource(resource, response,
                 compressed ? compressedData : response.data ? *response.data : "",
@@ -430,19 +681,15 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
         mapbox::sqlite::Query accessedQuery{ getStatement(
             "UPDATE tiles "
             "SET accessed       = ?1 "
-            "WHERE url_template = ?2 "
+            "WHERE template_id  = (SELECT id FROM tile_templates WHERE url_template = ?2) "
             "  AND pixel_ratio  = ?3 "
-            "  AND x            = ?4 "
-            "  AND y            = ?5 "
-            "  AND z            = ?6 ") };
+            "  AND tile_key     = ?4 ") };
         // clang-format on
 
         accessedQuery.bind(1, util::now());
         accessedQuery.bind(2, tile.urlTemplate);
         accessedQuery.bind(3, tile.pixelRatio);
-        accessedQuery.bind(4, tile.x);
-        accessedQuery.bind(5, tile.y);
-        accessedQuery.bind(6, tile.z);
+        accessedQuery.bind(4, packTileKey(tile));
         accessedQuery.run();
     } catch (const mapbox::sqlite::Exception& ex) {
         if (ex.code == mapbox::sqlite::ResultCode::NotADB || ex.code == mapbox::sqlite::ResultCode::Corrupt) {
@@ -456,20 +703,17 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
         //        0      1           2,            3,      4,      5
-        "SELECT etag, expires, must_revalidate, modified, data, compressed "
+        "SELECT etag, expires, must_revalidate, modified, "
+        "       ifnull(data, (SELECT tile_blobs.data FROM tile_blobs WHERE tile_blobs.id = tiles.blob_id)), compressed "
         "FROM tiles "
-        "WHERE url_template = ?1 "
+        "WHERE template_id  = (SELECT id FROM tile_templates WHERE url_template = ?1) "
         "  AND pixel_ratio  = ?2 "
-        "  AND x            = ?3 "
-        "  AND y            = ?4 "
-        "  AND z            = ?5 ") };
+        "  AND tile_key     = ?3 ") };
     // clang-format on
 
     query.bind(1, tile.urlTemplate);
     query.bind(2, tile.pixelRatio);
-    query.bind(3, tile.x);
-    query.bind(4, tile.y);
-    query.bind(5, tile.z);
+    query.bind(3, packTileKey(tile));
 
     if (!query.run()) {
         return nullopt;
@@ -500,20 +744,16 @@ optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource:
 optional<int64_t> OfflineDatabase::hasTile(const Resource::TileData& tile) {
     // clang-format off
     mapbox::sqlite::Query size{ getStatement(
-        "SELECT length(data) "
+        "SELECT ifnull(length(data), (SELECT length(tile_blobs.data) FROM tile_blobs WHERE tile_blobs.id = tiles.blob_id)) "
         "FROM tiles "
-        "WHERE url_template = ?1 "
+        "WHERE template_id  = (SELECT id FROM tile_templates WHERE url_template = ?1) "
         "  AND pixel_ratio  = ?2 "
-        "  AND x            = ?3 "
-        "  AND y            = ?4 "
-        "  AND z            = ?5 ") };
+        "  AND tile_key     = ?3 ") };
     // clang-format on
 
     size.bind(1, tile.urlTemplate);
     size.bind(2, tile.pixelRatio);
-    size.bind(3, tile.x);
-    size.bind(4, tile.y);
-    size.bind(5, tile.z);
+    size.bind(3, packTileKey(tile));
 
     if (!size.run()) {
         return nullopt;
@@ -525,7 +765,8 @@ optional<int64_t> OfflineDatabase::hasTile(const Resource::TileData& tile) {
 bool OfflineDatabase::putTile(const Resource::TileData& tile,
                               const Response& response,
                               const std::string& data,
-                              bool compressed) {
+                              bool compressed,
+                              bool deduplicate) {
     if (response.notModified) {
         // clang-format off
         mapbox::sqlite::Query notModifiedQuery{ getStatement(
@@ -533,11 +774,9 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
             "SET accessed        = ?1, "
             "    expires         = ?2, "
             "    must_revalidate = ?3 "
-            "WHERE url_template  = ?4 "
+            "WHERE template_id   = (SELECT id FROM tile_templates WHERE url_template = ?4) "
             "  AND pixel_ratio   = ?5 "
-            "  AND x             = ?6 "
-            "  AND y             = ?7 "
-            "  AND z             = ?8 ") };
+            "  AND tile_key      = ?6 ") };
         // clang-format on
 
         notModifiedQuery.bind(1, util::now());
@@ -545,13 +784,17 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         notModifiedQuery.bind(3, response.mustRevalidate);
         notModifiedQuery.bind(4, tile.urlTemplate);
         notModifiedQuery.bind(5, tile.pixelRatio);
-        notModifiedQuery.bind(6, tile.x);
-        notModifiedQuery.bind(7, tile.y);
-        notModifiedQuery.bind(8, tile.z);
+        notModifiedQuery.bind(6, packTileKey(tile));
         notModifiedQuery.run();
         return false;
     }
 
+    // Deduplicated tiles reference a shared blob and store no data of their own.
+    optional<int64_t> blobID;
+    if (deduplicate && !response.noContent) {
+        blobID = putTileBlob(data);
+    }
+
     // We can't use REPLACE because it would change the id value.
 
     // clang-format off
@@ -563,12 +806,11 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         "    must_revalidate = ?4, "
         "    accessed        = ?5, "
         "    data            = ?6, "
-        "    compressed      = ?7 "
-        "WHERE url_template  = ?8 "
+        "    compressed      = ?7, "
+        "    blob_id         = ?11 "
+        "WHERE template_id   = (SELECT id FROM tile_templates WHERE url_template = ?8) "
         "  AND pixel_ratio   = ?9 "
-        "  AND x             = ?10 "
-        "  AND y             = ?11 "
-        "  AND z             = ?12 ") };
+        "  AND tile_key      = ?10 ") };
     // clang-format on
 
     updateQuery.bind(1, response.modified);
@@ -578,16 +820,20 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
     updateQuery.bind(5, util::now());
     updateQuery.bind(8, tile.urlTemplate);
     updateQuery.bind(9, tile.pixelRatio);
-    updateQuery.bind(10, tile.x);
-    updateQuery.bind(11, tile.y);
-    updateQuery.bind(12, tile.z);
+    updateQuery.bind(10, packTileKey(tile));
 
     if (response.noContent) {
         updateQuery.bind(6, nullptr);
         updateQuery.bind(7, false);
+        updateQuery.bind(11, nullptr);
+    } else if (blobID) {
+        updateQuery.bind(6, nullptr);
+        updateQuery.bind(7, compressed);
+        updateQuery.bind(11, *blobID);
     } else {
         updateQuery.bindBlob(6, data.data(), data.size(), false);
         updateQuery.bind(7, compressed);
+        updateQuery.bind(11, nullptr);
     }
 
     updateQuery.run();
@@ -595,29 +841,44 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
         return false;
     }
 
+    // clang-format off
+    mapbox::sqlite::Query templateQuery{ getStatement(
+        "INSERT OR IGNORE INTO tile_templates (url_template) "
+        "VALUES                               (?1)") };
+    // clang-format on
+
+    templateQuery.bind(1, tile.urlTemplate);
+    templateQuery.run();
+
     // clang-format off
     mapbox::sqlite::Query insertQuery{ getStatement(
-        "INSERT INTO tiles (url_template, pixel_ratio, x,  y,  z,  modified, must_revalidate, etag, expires, accessed,  data, compressed) "
-        "VALUES            (?1,           ?2,          ?3, ?4, ?5, ?6,       ?7,              ?8,   ?9,      ?10,       ?11,  ?12)") };
+        "INSERT INTO tiles (template_id, pixel_ratio, tile_key, modified, must_revalidate, etag, expires, accessed, data, compressed, blob_id) "
+        "SELECT             id,          ?2,          ?3,       ?4,       ?5,              ?6,   ?7,      ?8,       ?9,   ?10,        ?11 "
+        "FROM tile_templates "
+        "WHERE url_template = ?1 ") };
     // clang-format on
 
     insertQuery.bind(1, tile.urlTemplate);
     insertQuery.bind(2, tile.pixelRatio);
-    insertQuery.bind(3, tile.x);
-    insertQuery.bind(4, tile.y);
-    insertQuery.bind(5, tile.z);
-    insertQuery.bind(6, response.modified);
-    insertQuery.bind(7, response.mustRevalidate);
-    insertQuery.bind(8, response.etag);
-    insertQuery.bind(9, response.expires);
-    insertQuery.bind(10, util::now());
+    insertQuery.bind(3, packTileKey(tile));
+    insertQuery.bind(4, response.modified);
+    insertQuery.bind(5, response.mustRevalidate);
+    insertQuery.bind(6, response.etag);
+    insertQuery.bind(7, response.expires);
+    insertQuery.bind(8, util::now());
 
     if (response.noContent) {
+        insertQuery.bind(9, nullptr);
+        insertQuery.bind(10, false);
         insertQuery.bind(11, nullptr);
-        insertQuery.bind(12, false);
+    } else if (blobID) {
+        insertQuery.bind(9, nullptr);
+        insertQuery.bind(10, compressed);
+        insertQuery.bind(11, *blobID);
     } else {
-        insertQuery.bindBlob(11, data.data(), data.size(), false);
-        insertQuery.bind(12, compressed);
+        insertQuery.bindBlob(9, data.data(), data.size(), false);
+        insertQuery.bind(10, compressed);
+        insertQuery.bind(11, nullptr);
     }
 
     insertQuery.run();
@@ -625,6 +886,37 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
     return true;
 }
 
+int64_t OfflineDatabase::putTileBlob(const std::string& data) {
+    const int64_t hash = hashTileData(data);
+
+    {
+        // clang-format off
+        mapbox::sqlite::Query selectQuery{ getStatement(
+            "SELECT id FROM tile_blobs "
+            "WHERE hash = ?1 "
+            "  AND data = ?2 ") };
+        // clang-format on
+
+        selectQuery.bind(1, hash);
+        selectQuery.bindBlob(2, data.data(), data.size(), false);
+        if (selectQuery.run()) {
+            return selectQuery.get<int64_t>(0);
+        }
+    }
+
+    // clang-format off
+    mapbox::sqlite::Query insertQuery{ getStatement(
+        "INSERT INTO tile_blobs (hash, data) "
+        "VALUES                 (?1,   ?2) ") };
+    // clang-format on
+
+    insertQuery.bind(1, hash);
+    insertQuery.bindBlob(2, data.data(), data.size(), false);
+    insertQuery.run();
+
+    return insertQuery.lastInsertRowId();
+}
+
 std::exception_ptr OfflineDatabase::invalidateAmbientCache() try {
     // clang-format off
     mapbox::sqlite::Query tileQuery{ getStatement(
@@ -779,27 +1071,60 @@ OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
         return unexpected<std::exception_ptr>(std::current_exception());
     }
     try {
-        // Support sideloaded databases at user_version = 6. Future schema version
+        // Support sideloaded databases at user_version = 6 and later. Future schema version
         // changes will need to implement migration paths for sideloaded databases at
         // version 6.
         auto sideUserVersion = static_cast<int>(getPragma<int64_t>("PRAGMA side.user_version"));
         const auto mainUserVersion = getPragma<int64_t>("PRAGMA user_version");
-        if (sideUserVersion < 6 || sideUserVersion != mainUserVersion) {
+        if (sideUserVersion < 6 || sideUserVersion > mainUserVersion) {
             throw std::runtime_error("Merge database has incorrect user_version");
         }
 
+        // The merge reads the side tiles through a view with the template URL and the packed
+        // tile key, which both supported versions can provide.
+        db->exec("DROP VIEW IF EXISTS temp.side_tiles");
+        if (sideUserVersion == 6) {
+            // clang-format off
+            db->exec(
+                "CREATE TEMPORARY VIEW side_tiles AS "
+                "SELECT id, url_template, pixel_ratio, (z << 58) | (y << 29) | x AS tile_key, "
+                "       expires, modified, etag, data, compressed, accessed, must_revalidate "
+                "FROM side.tiles");
+            // clang-format on
+        } else if (sideUserVersion < 9) {
+            // clang-format off
+            db->exec(
+                "CREATE TEMPORARY VIEW side_tiles AS "
+                "SELECT st.id, stt.url_template, st.pixel_ratio, st.tile_key, "
+                "       st.expires, st.modified, st.etag, st.data, st.compressed, st.accessed, st.must_revalidate "
+                "FROM side.tiles st "
+                "JOIN side.tile_templates stt ON st.template_id = stt.id");
+            // clang-format on
+        } else {
+            // Deduplicated side tiles are merged with their data inline.
+            // clang-format off
+            db->exec(
+                "CREATE TEMPORARY VIEW side_tiles AS "
+                "SELECT st.id, stt.url_template, st.pixel_ratio, st.tile_key, "
+                "       st.expires, st.modified, st.etag, ifnull(st.data, stb.data) AS data, st.compressed, "
+                "       st.accessed, st.must_revalidate "
+                "FROM side.tiles st "
+                "JOIN side.tile_templates stt ON st.template_id = stt.id "
+                "LEFT JOIN side.tile_blobs stb ON st.blob_id = stb.id");
+            // clang-format on
+        }
+
         auto currentTileCount = getOfflineMapboxTileCount();
         // clang-format off
          mapbox::sqlite::Query queryTiles{ getStatement(
             "SELECT COUNT(DISTINCT st.id) "
-            "FROM side.tiles st "
+            "FROM side_tiles st "
             //only consider region tiles, and not ambient tiles.
             "JOIN side.region_tiles srt ON srt.tile_id = st.id "
-            "LEFT JOIN tiles t ON st.url_template = t.url_template AND "
+            "LEFT JOIN tile_templates tt ON st.url_template = tt.url_template "
+            "LEFT JOIN tiles t ON tt.id = t.template_id AND "
                 "st.pixel_ratio = t.pixel_ratio AND "
-                "st.z = t.z AND "
-                "st.x = t.x AND "
-                "st.y = t.y "
+                "st.tile_key = t.tile_key "
             "WHERE t.id IS NULL "
             "AND st.url_template LIKE 'mapbox://%' ") };
         // clang-format on
@@ -812,6 +1137,10 @@ OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
 
         mapbox::sqlite::Transaction transaction(*db);
         db->exec(mergeSideloadedDatabaseSQL);
+        // Replaced tiles and resources may have changed size without notifying the region stats,
+        // and replaced tiles did not release their blobs.
+        rebuildRegionStats();
+        db->exec("DELETE FROM tile_blobs WHERE id NOT IN (SELECT blob_id FROM tiles WHERE blob_id IS NOT NULL)");
         transaction.commit();
 
         // clang-format off
@@ -829,10 +1158,12 @@ OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
                 queryRegions.get<std::vector<uint8_t>>(2));
             result.emplace_back(std::move(region));
         }
+        db->exec("DROP VIEW IF EXISTS temp.side_tiles");
         db->exec("DETACH DATABASE side");
         // Explicit move to avoid triggering the copy constructor.
         return { std::move(result) };
     } catch (const std::runtime_error& ex) {
+        db->exec("DROP VIEW IF EXISTS temp.side_tiles");
         db->exec("DETACH DATABASE side");
         Log::Error(Event::Database, "%s", ex.what());
 
@@ -903,6 +1234,91 @@ optional<int64_t> OfflineDatabase::hasRegionResource(int64_t regionID, const Res
     return nullopt;
 }
 
+std::vector<optional<int64_t>> OfflineDatabase::hasRegionResources(int64_t regionID,
+                                                                   const std::vector<Resource>& resources) try {
+    if (!db) {
+        initialize();
+    }
+    mapbox::sqlite::Transaction transaction(*db);
+
+    std::vector<optional<int64_t>> sizes(resources.size());
+
+    // Group the tiles by pyramid so that the tiles of each group are looked up in batches.
+    std::map<std::pair<std::string, uint8_t>, std::vector<std::size_t>> tileGroups;
+    for (std::size_t i = 0; i < resources.size(); ++i) {
+        const Resource& resource = resources[i];
+        if (resource.kind == Resource::Kind::Tile) {
+            assert(resource.tileData);
+            const Resource::TileData& tile = *resource.tileData;
+            tileGroups[std::make_pair(tile.urlTemplate, tile.pixelRatio)].push_back(i);
+        } else if ((sizes[i] = hasResource(resource))) {
+            markUsed(regionID, resource);
+        }
+    }
+
+    for (const auto& group : tileGroups) {
+        hasRegionTiles(regionID, resources, group.second, sizes);
+    }
+
+    transaction.commit();
+    return sizes;
+} catch (const mapbox::sqlite::Exception& ex) {
+    handleError(ex, "query region resources");
+    return std::vector<optional<int64_t>>(resources.size());
+}
+
+void OfflineDatabase::hasRegionTiles(int64_t regionID,
+                                     const std::vector<Resource>& resources,
+                                     const std::vector<std::size_t>& indices,
+                                     std::vector<optional<int64_t>>& sizes) {
+    assert(!indices.empty());
+    const Resource::TileData& first = *resources[indices.front()].tileData;
+
+    // Look the tiles up by their exact keys, a batch of keys per query. Unused parameters of the
+    // last batch are left unbound, i.e. NULL, which matches no tile.
+    mapbox::sqlite::Query selectQuery{ getStatement(selectRegionTilesSQL()) };
+
+    std::vector<int64_t> found;
+    std::unordered_map<int64_t, std::size_t> wanted;
+    for (std::size_t begin = 0; begin < indices.size(); begin += regionTilesBatchSize) {
+        const std::size_t end = std::min(indices.size(), begin + regionTilesBatchSize);
+
+        wanted.clear();
+        selectQuery.bind(1, first.urlTemplate);
+        selectQuery.bind(2, first.pixelRatio);
+        for (std::size_t i = begin; i < end; ++i) {
+            const int64_t key = packTileKey(*resources[indices[i]].tileData);
+            selectQuery.bind(int(3 + i - begin), key);
+            wanted.emplace(key, indices[i]);
+        }
+
+        while (selectQuery.run()) {
+            const std::size_t index = wanted.at(selectQuery.get<int64_t>(1));
+            // Like hasTile(), treat tiles stored without data as missing.
+            optional<int64_t> size = selectQuery.get<optional<int64_t>>(2);
+            if (size) {
+                sizes[index] = size;
+                found.push_back(selectQuery.get<int64_t>(0));
+            }
+        }
+        selectQuery.reset();
+        selectQuery.clearBindings();
+    }
+
+    // clang-format off
+    mapbox::sqlite::Query insertQuery{ getStatement(
+        "INSERT OR IGNORE INTO region_tiles (region_id, tile_id) "
+        "VALUES (?1, ?2) ") };
+    // clang-format on
+
+    for (int64_t tileID : found) {
+        insertQuery.bind(1, regionID);
+        insertQuery.bind(2, tileID);
+        insertQuery.run();
+        insertQuery.reset();
+    }
+}
+
 uint64_t OfflineDatabase::putRegionResource(int64_t regionID,
                                             const Resource& resource,
                                             const Response& response) try {
@@ -988,20 +1404,16 @@ bool OfflineDatabase::markUsed(int64_t regionID, const Resource& resource) {
             "INSERT OR IGNORE INTO region_tiles (region_id, tile_id) "
             "SELECT                              ?1,        tiles.id "
             "FROM tiles "
-            "WHERE url_template = ?2 "
+            "WHERE template_id  = (SELECT id FROM tile_templates WHERE url_template = ?2) "
             "  AND pixel_ratio  = ?3 "
-            "  AND x            = ?4 "
-            "  AND y            = ?5 "
-            "  AND z            = ?6 ") };
+            "  AND tile_key     = ?4 ") };
         // clang-format on
 
         const Resource::TileData& tile = *resource.tileData;
         insertQuery.bind(1, regionID);
         insertQuery.bind(2, tile.urlTemplate);
         insertQuery.bind(3, tile.pixelRatio);
-        insertQuery.bind(4, tile.x);
-        insertQuery.bind(5, tile.y);
-        insertQuery.bind(6, tile.z);
+        insertQuery.bind(4, packTileKey(tile));
         insertQuery.run();
 
         bool notOnThisRegion = insertQuery.changes() != 0;
@@ -1012,20 +1424,16 @@ bool OfflineDatabase::markUsed(int64_t regionID, const Resource& resource) {
             "FROM region_tiles, tiles "
             "WHERE region_id   != ?1 "
             "  AND tile_id      = id "
-            "  AND url_template = ?2 "
+            "  AND template_id  = (SELECT id FROM tile_templates WHERE url_template = ?2) "
             "  AND pixel_ratio  = ?3 "
-            "  AND x            = ?4 "
-            "  AND y            = ?5 "
-            "  AND z            = ?6 "
+            "  AND tile_key     = ?4 "
             "LIMIT 1 ") };
         // clang-format on
 
         selectQuery.bind(1, regionID);
         selectQuery.bind(2, tile.urlTemplate);
         selectQuery.bind(3, tile.pixelRatio);
-        selectQuery.bind(4, tile.x);
-        selectQuery.bind(5, tile.y);
-        selectQuery.bind(6, tile.z);
+        selectQuery.bind(4, packTileKey(tile));
 
         bool notOnOtherRegion = !selectQuery.run();
 
@@ -1074,15 +1482,29 @@ expected<OfflineRegionDefinition, std::exception_ptr> OfflineDatabase::getRegion
 }
 
 expected<OfflineRegionStatus, std::exception_ptr> OfflineDatabase::getRegionCompletedStatus(int64_t regionID) try {
+    // clang-format off
+    mapbox::sqlite::Query query{ getStatement(
+        "SELECT completed_resource_count, completed_resource_size, "
+        "       completed_tile_count, completed_tile_size, required_resource_count "
+        "FROM region_stats "
+        "WHERE region_id = ?1 ") };
+    // clang-format on
+    query.bind(1, regionID);
+
     OfflineRegionStatus result;
+    if (!query.run()) {
+        return result;
+    }
 
-    std::tie(result.completedResourceCount, result.completedResourceSize)
-        = getCompletedResourceCountAndSize(regionID);
-    std::tie(result.completedTileCount, result.completedTileSize)
-        = getCompletedTileCountAndSize(regionID);
+    result.completedTileCount = query.get<int64_t>(2);
+    result.completedTileSize = query.get<int64_t>(3);
+    result.completedResourceCount = query.get<int64_t>(0) + result.completedTileCount;
+    result.completedResourceSize = query.get<int64_t>(1) + result.completedTileSize;
 
-    result.completedResourceCount += result.completedTileCount;
-    result.completedResourceSize += result.completedTileSize;
+    if (optional<int64_t> requiredResourceCount = query.get<optional<int64_t>>(4)) {
+        result.requiredResourceCount = *requiredResourceCount;
+        result.requiredResourceCountIsPrecise = true;
+    }
 
     return result;
 } catch (const mapbox::sqlite::Exception& ex) {
@@ -1090,30 +1512,39 @@ expected<OfflineRegionStatus, std::exception_ptr> OfflineDatabase::getRegionComp
     return unexpected<std::exception_ptr>(std::current_exception());
 }
 
-std::pair<int64_t, int64_t> OfflineDatabase::getCompletedResourceCountAndSize(int64_t regionID) {
+void OfflineDatabase::setRegionRequiredResourceCount(int64_t regionID,
+                                                     uint64_t count,
+                                                     const std::vector<std::string>& resourceURLs) try {
     // clang-format off
-    mapbox::sqlite::Query query{ getStatement(
-        "SELECT COUNT(*), SUM(LENGTH(data)) "
+    mapbox::sqlite::Query regionResourceQuery{ getStatement(
+        "SELECT 1 "
         "FROM region_resources, resources "
-        "WHERE region_id = ?1 "
-        "AND resource_id = resources.id ") };
+        "WHERE region_id   = ?1 "
+        "  AND resource_id = id "
+        "  AND url         = ?2 ") };
     // clang-format on
-    query.bind(1, regionID);
-    query.run();
-    return { query.get<int64_t>(0), query.get<int64_t>(1) };
-}
 
-std::pair<int64_t, int64_t> OfflineDatabase::getCompletedTileCountAndSize(int64_t regionID) {
+    for (const auto& url : resourceURLs) {
+        regionResourceQuery.bind(1, regionID);
+        regionResourceQuery.bind(2, url);
+        const bool isRegionResource = regionResourceQuery.run();
+        regionResourceQuery.reset();
+        if (!isRegionResource) {
+            return;
+        }
+    }
+
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
-        "SELECT COUNT(*), SUM(LENGTH(data)) "
-        "FROM region_tiles, tiles "
-        "WHERE region_id = ?1 "
-        "AND tile_id = tiles.id ") };
+        "UPDATE region_stats "
+        "SET required_resource_count = ?1 "
+        "WHERE region_id = ?2 ") };
     // clang-format on
-    query.bind(1, regionID);
+    query.bind(1, static_cast<int64_t>(count));
+    query.bind(2, regionID);
     query.run();
-    return { query.get<int64_t>(0), query.get<int64_t>(1) };
+} catch (const mapbox::sqlite::Exception& ex) {
+    handleError(ex, "set region required resource count");
 }
 
 template <class T>
@@ -1237,6 +1668,10 @@ void OfflineDatabase::setOfflineMapboxTileCountLimit(uint64_t limit) {
     offlineMapboxTileCountLimit = limit;
 }
 
+void OfflineDatabase::setTileDeduplication(bool enabled) {
+    tileDeduplication = enabled;
+}
+
 uint64_t OfflineDatabase::getOfflineMapboxTileCountLimit() {
     return offlineMapboxTileCountLimit;
 }
@@ -1257,9 +1692,10 @@ uint64_t OfflineDatabase::getOfflineMapboxTileCount() try {
 
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
-        "SELECT COUNT(DISTINCT id) "
-        "FROM region_tiles, tiles "
+        "SELECT COUNT(DISTINCT tiles.id) "
+        "FROM region_tiles, tiles, tile_templates "
         "WHERE tile_id = tiles.id "
+        "AND template_id = tile_templates.id "
         "AND url_template LIKE 'mapbox://%' ") };
     // clang-format on
 
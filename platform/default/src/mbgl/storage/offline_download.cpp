@@ -25,6 +25,9 @@ namespace mbgl {
 
 using namespace style;
 
+// Number of tiles checked against the database with a single query before downloading.
+constexpr const std::size_t TILE_CHECK_BATCH_SIZE = 256;
+
 // Generic functions
 
 template <class RegionDefinition>
@@ -40,29 +43,6 @@ Range<uint8_t> coveringZoomRange(const RegionDefinition& definition,
     return { static_cast<uint8_t>(minZ), static_cast<uint8_t>(maxZ) };
 }
 
-template <class Geometry, class Fn>
-void tileCover(const Geometry& geometry, uint8_t z, Fn&& fn) {
-    util::TileCover cover(geometry, z);
-    while (cover.hasNext()) {
-        fn(cover.next()->canonical);
-    }
-}
-
-
-template <class Fn>
-void tileCover(const OfflineRegionDefinition& definition, style::SourceType type,
-               uint16_t tileSize, const Range<uint8_t>& zoomRange, Fn&& fn) {
-    const Range<uint8_t> clampedZoomRange =
-            definition.match([&](auto& reg) { return coveringZoomRange(reg, type, tileSize, zoomRange); });
-
-    for (uint8_t z = clampedZoomRange.min; z <= clampedZoomRange.max; z++) {
-        definition.match(
-                [&](const OfflineTilePyramidRegionDefinition& reg){ tileCover(reg.bounds, z, fn); },
-                [&](const OfflineGeometryRegionDefinition& reg){ tileCover(reg.geometry, z, fn); }
-        );
-    }
-}
-
 uint64_t tileCount(const OfflineRegionDefinition& definition, style::SourceType type,
                    uint16_t tileSize, const Range<uint8_t>& zoomRange) {
 
@@ -80,6 +60,79 @@ uint64_t tileCount(const OfflineRegionDefinition& definition, style::SourceType
     return result;
 }
 
+// Resumable tile cover of a tiled source over the region, walking one zoom level at a time.
+class OfflineDownload::TileCursor {
+public:
+    TileCursor(const OfflineRegionDefinition& definition_, style::SourceType type, uint16_t tileSize, const Tileset& tileset)
+        : definition(definition_),
+          urlTemplate(tileset.tiles[0]),
+          scheme(tileset.scheme),
+          pixelRatio(definition.match([](auto& def) { return def.pixelRatio; })),
+          zoomRange(definition.match([&](auto& reg) { return coveringZoomRange(reg, type, tileSize, tileset.zoomRange); })),
+          z(zoomRange.min),
+          expectedCount(tileCount(definition, type, tileSize, tileset.zoomRange)) {
+        advance();
+    }
+
+    bool done() const {
+        return !upcoming;
+    }
+
+    Resource next() {
+        assert(upcoming);
+        auto tileResource = Resource::tile(urlTemplate, pixelRatio, upcoming->x, upcoming->y, upcoming->z, scheme);
+        tileResource.setPriority(Resource::Priority::Low);
+        tileResource.setUsage(Resource::Usage::Offline);
+
+        enumeratedCount++;
+        advance();
+        return tileResource;
+    }
+
+    // The number of tiles accounted for in the status before enumerating them, and the number
+    // enumerated so far.
+    uint64_t getExpectedCount() const {
+        return expectedCount;
+    }
+
+    uint64_t getEnumeratedCount() const {
+        return enumeratedCount;
+    }
+
+private:
+    void advance() {
+        upcoming = nullopt;
+        while (!upcoming && z <= zoomRange.max) {
+            if (!cover) {
+                definition.match(
+                    [&](const OfflineTilePyramidRegionDefinition& reg) { cover.emplace(reg.bounds, z); },
+                    [&](const OfflineGeometryRegionDefinition& reg) { cover.emplace(reg.geometry, z); });
+            }
+
+            if (cover->hasNext()) {
+                if (auto tile = cover->next()) {
+                    upcoming = tile->canonical;
+                }
+            } else {
+                cover = nullopt;
+                z++;
+            }
+        }
+    }
+
+    const OfflineRegionDefinition& definition;
+    const std::string urlTemplate;
+    const Tileset::Scheme scheme;
+    const float pixelRatio;
+    const Range<uint8_t> zoomRange;
+    uint8_t z;
+    const uint64_t expectedCount;
+    uint64_t enumeratedCount = 0;
+
+    optional<util::TileCover> cover;
+    optional<CanonicalTileID> upcoming;
+};
+
 // OfflineDownload
 
 OfflineDownload::OfflineDownload(int64_t id_,
@@ -109,6 +162,20 @@ void OfflineDownload::setState(OfflineRegionDownloadState state) {
     if (status.downloadState == OfflineRegionDownloadState::Active) {
         activateDownload();
     } else {
+        // Keep the responses fetched so far, so that the next download of the region doesn't
+        // request them again.
+        if (!buffer.empty()) {
+            try {
+                offlineDatabase.putRegionResources(id, buffer, status);
+            } catch (const MapboxTileLimitExceededException&) {
+                observer->mapboxTileCountLimitExceeded(offlineDatabase.getOfflineMapboxTileCountLimit());
+            }
+            buffer.clear();
+        }
+        if (status.requiredResourceCountIsPrecise) {
+            // Lets getStatus() answer without parsing the style again.
+            offlineDatabase.setRegionRequiredResourceCount(id, status.requiredResourceCount, countedResourceURLs);
+        }
         deactivateDownload();
     }
 
@@ -127,9 +194,14 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
         return {};
     }
 
+    if (result->requiredResourceCountIsPrecise) {
+        // Stored by an earlier download or status query of this region.
+        return *result;
+    }
+
     result->requiredResourceCount++;
-    optional<Response> styleResponse =
-            offlineDatabase.get(Resource::style(definition.match([](auto& reg){ return reg.styleURL; })));
+    std::vector<std::string> resourceURLs { definition.match([](auto& reg){ return reg.styleURL; }) };
+    optional<Response> styleResponse = offlineDatabase.get(Resource::style(resourceURLs.front()));
     if (!styleResponse) {
         return *result;
     }
@@ -151,6 +223,7 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
                 const auto& url = urlOrTileset.get<std::string>();
                 optional<Response> sourceResponse = offlineDatabase.get(Resource::source(url));
                 if (sourceResponse) {
+                    resourceURLs.push_back(url);
                     style::conversion::Error error;
                     optional<Tileset> tileset = style::conversion::convertJSON<Tileset>(*sourceResponse->data, error);
                     if (tileset) {
@@ -216,6 +289,10 @@ OfflineRegionStatus OfflineDownload::getStatus() const {
         result->requiredResourceCount += 4;
     }
 
+    if (result->requiredResourceCountIsPrecise) {
+        offlineDatabase.setRegionRequiredResourceCount(id, result->requiredResourceCount, resourceURLs);
+    }
+
     return *result;
 }
 
@@ -225,6 +302,7 @@ void OfflineDownload::activateDownload() {
     status.requiredResourceCount++;
 
     auto styleResource = Resource::style(definition.match([](auto& reg){ return reg.styleURL; }));
+    countedResourceURLs = { styleResource.url };
     styleResource.setPriority(Resource::Priority::Low);
     styleResource.setUsage(Resource::Usage::Offline);
 
@@ -245,6 +323,7 @@ void OfflineDownload::activateDownload() {
                     status.requiredResourceCountIsPrecise = false;
                     status.requiredResourceCount++;
                     requiredSourceURLs.insert(url);
+                    countedResourceURLs.push_back(url);
 
                     auto sourceResource = Resource::source(url);
                     sourceResource.setPriority(Resource::Priority::Low);
@@ -352,23 +431,47 @@ void OfflineDownload::activateDownload() {
    the first few errors is fruitless anyway.
 */
 void OfflineDownload::continueDownload() {
-    if (resourcesRemaining.empty() && status.complete()) {
+    // Responses that arrived while the last tiles were still being checked against the database
+    // have not been flushed yet.
+    if (!hasRemainingResources() && requests.empty() && !buffer.empty() && !flushBuffer()) {
+        return;
+    }
+
+    if (!hasRemainingResources() && status.complete()) {
         setState(OfflineRegionDownloadState::Inactive);
         return;
     }
 
-    while (!resourcesRemaining.empty() && requests.size() < onlineFileSource.getMaximumConcurrentRequests()) {
-        ensureResource(resourcesRemaining.front());
-        resourcesRemaining.pop_front();
+    while (requests.size() < onlineFileSource.getMaximumConcurrentRequests()) {
+        if (!resourcesRemaining.empty()) {
+            ensureResource(resourcesRemaining.front());
+            resourcesRemaining.pop_front();
+        } else if (!tilesMissing.empty()) {
+            // Exceeding the tile count limit deactivates the download, which clears the queue.
+            Resource tileResource = std::move(tilesMissing.front());
+            tilesMissing.pop_front();
+            downloadResource(tileResource);
+        } else if (!checkingTiles && !tilesRemaining.empty()) {
+            ensureTiles();
+        } else {
+            break;
+        }
     }
 }
 
 void OfflineDownload::deactivateDownload() {
     requiredSourceURLs.clear();
     resourcesRemaining.clear();
+    tilesRemaining.clear();
+    tilesMissing.clear();
+    checkingTiles = false;
     requests.clear();
 }
 
+bool OfflineDownload::hasRemainingResources() const {
+    return !resourcesRemaining.empty() || !tilesRemaining.empty() || !tilesMissing.empty() || checkingTiles;
+}
+
 void OfflineDownload::queueResource(Resource&& resource) {
     resource.setPriority(Resource::Priority::Low);
     resource.setUsage(Resource::Usage::Offline);
@@ -377,18 +480,30 @@ void OfflineDownload::queueResource(Resource&& resource) {
 }
 
 void OfflineDownload::queueTiles(SourceType type, uint16_t tileSize, const Tileset& tileset) {
-    tileCover(definition, type, tileSize, tileset.zoomRange, [&](const auto& tile) {
-        status.requiredResourceCount++;
+    auto cursor = std::make_unique<TileCursor>(definition, type, tileSize, tileset);
+    if (!cursor->done()) {
+        status.requiredResourceCount += cursor->getExpectedCount();
+        tilesRemaining.push_back(std::move(cursor));
+    }
+}
 
-        auto tileResource = Resource::tile(
-                tileset.tiles[0], definition.match([](auto& def) { return def.pixelRatio; }),
-                tile.x, tile.y, tile.z, tileset.scheme);
+optional<Resource> OfflineDownload::nextTileResource() {
+    if (tilesRemaining.empty()) {
+        return {};
+    }
 
-        tileResource.setPriority(Resource::Priority::Low);
-        tileResource.setUsage(Resource::Usage::Offline);
+    TileCursor& cursor = *tilesRemaining.front();
+    Resource tileResource = cursor.next();
 
-        resourcesRemaining.push_back(std::move(tileResource));
-    });
+    if (cursor.done()) {
+        // The expected count was computed up front with tileCount(); settle on the number of
+        // tiles actually enumerated in case the two differ.
+        status.requiredResourceCount -= cursor.getExpectedCount();
+        status.requiredResourceCount += cursor.getEnumeratedCount();
+        tilesRemaining.pop_front();
+    }
+
+    return tileResource;
 }
 
 void OfflineDownload::ensureResource(const Resource& resource,
@@ -426,50 +541,99 @@ void OfflineDownload::ensureResource(const Resource& resource,
             return;
         }
 
-        if (offlineDatabase.exceedsOfflineMapboxTileCountLimit(resource)) {
-            onMapboxTileCountLimitExceeded();
-            return;
+        downloadResource(resource, callback);
+    });
+}
+
+void OfflineDownload::ensureTiles() {
+    std::vector<Resource> tiles;
+    tiles.reserve(TILE_CHECK_BATCH_SIZE);
+    while (tiles.size() < TILE_CHECK_BATCH_SIZE) {
+        optional<Resource> tileResource = nextTileResource();
+        if (!tileResource) {
+            break;
         }
+        tiles.push_back(std::move(*tileResource));
+    }
+
+    checkingTiles = true;
 
-        auto fileRequestsIt = requests.insert(requests.begin(), nullptr);
-        *fileRequestsIt = onlineFileSource.request(resource, [=](Response onlineResponse) {
-            if (onlineResponse.error) {
-                observer->responseError(*onlineResponse.error);
-                return;
+    auto workRequestsIt = requests.insert(requests.begin(), nullptr);
+    *workRequestsIt = util::RunLoop::Get()->invokeCancellable([this, workRequestsIt, tiles = std::move(tiles)]() {
+        requests.erase(workRequestsIt);
+        checkingTiles = false;
+
+        std::vector<optional<int64_t>> sizes = offlineDatabase.hasRegionResources(id, tiles);
+        bool found = false;
+        for (std::size_t i = 0; i < tiles.size(); ++i) {
+            if (sizes[i]) {
+                status.completedResourceCount++;
+                status.completedResourceSize += *sizes[i];
+                status.completedTileCount += 1;
+                status.completedTileSize += *sizes[i];
+                found = true;
+            } else {
+                tilesMissing.push_back(tiles[i]);
             }
+        }
 
-            requests.erase(fileRequestsIt);
+        if (found) {
+            observer->statusChanged(status);
+        }
+        continueDownload();
+    });
+}
 
-            if (callback) {
-                callback(onlineResponse);
-            }
+void OfflineDownload::downloadResource(const Resource& resource,
+                                       std::function<void(Response)> callback) {
+    if (offlineDatabase.exceedsOfflineMapboxTileCountLimit(resource)) {
+        onMapboxTileCountLimitExceeded();
+        return;
+    }
 
-            // Queue up for batched insertion
-            buffer.emplace_back(resource, onlineResponse);
+    auto fileRequestsIt = requests.insert(requests.begin(), nullptr);
+    *fileRequestsIt = onlineFileSource.request(resource, [=](Response onlineResponse) {
+        if (onlineResponse.error) {
+            observer->responseError(*onlineResponse.error);
+            return;
+        }
 
-            // Flush buffer periodically
-            if (buffer.size() == 64 || resourcesRemaining.size() == 0) {
-                try {
-                    offlineDatabase.putRegionResources(id, buffer, status);
-                } catch (const MapboxTileLimitExceededException&) {
-                    onMapboxTileCountLimitExceeded();
-                    return;
-                }
+        requests.erase(fileRequestsIt);
 
-                buffer.clear();
-                observer->statusChanged(status);
-            }
+        if (callback) {
+            callback(onlineResponse);
+        }
 
-            if (offlineDatabase.exceedsOfflineMapboxTileCountLimit(resource)) {
-                onMapboxTileCountLimitExceeded();
-                return;
-            }
+        // Queue up for batched insertion
+        buffer.emplace_back(resource, onlineResponse);
 
-            continueDownload();
-        });
+        // Flush buffer periodically
+        if ((buffer.size() == 64 || !hasRemainingResources()) && !flushBuffer()) {
+            return;
+        }
+
+        if (offlineDatabase.exceedsOfflineMapboxTileCountLimit(resource)) {
+            onMapboxTileCountLimitExceeded();
+            return;
+        }
+
+        continueDownload();
     });
 }
 
+bool OfflineDownload::flushBuffer() {
+    try {
+        offlineDatabase.putRegionResources(id, buffer, status);
+    } catch (const MapboxTileLimitExceededException&) {
+        onMapboxTileCountLimitExceeded();
+        return false;
+    }
+
+    buffer.clear();
+    observer->statusChanged(status);
+    return true;
+}
+
 void OfflineDownload::onMapboxTileCountLimitExceeded() {
     observer->mapboxTileCountLimitExceeded(offlineDatabase.getOfflineMapboxTileCountLimit());
     setState(OfflineRegionDownloadState::Inactive);
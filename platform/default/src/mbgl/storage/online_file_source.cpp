@@ -26,6 +26,7 @@
 namespace mbgl {
 
 static uint32_t DEFAULT_MAXIMUM_CONCURRENT_REQUESTS = 20;
+static uint32_t DEFAULT_MAXIMUM_CONCURRENT_REVALIDATIONS = 2;
 
 class OnlineFileRequest : public AsyncRequest {
 public:
@@ -60,6 +61,10 @@ public:
     uint32_t failedRequests = 0;
     Response::Error::Reason failedRequestReason = Response::Error::Reason::Success;
     optional<Timestamp> retryAfter;
+
+    // The rank of the resource when the request was activated. An active request whose rank has
+    // grown since then became less useful to the requester and may be preempted.
+    uint32_t activatedRank = 0;
 };
 
 class OnlineFileSource::Impl {
@@ -67,6 +72,7 @@ public:
     Impl() {
         NetworkStatus::Subscribe(&reachability);
         setMaximumConcurrentRequests(DEFAULT_MAXIMUM_CONCURRENT_REQUESTS);
+        setMaximumConcurrentRevalidations(DEFAULT_MAXIMUM_CONCURRENT_REVALIDATIONS);
     }
 
     ~Impl() {
@@ -91,18 +97,32 @@ public:
         allRequests.erase(request);
         if (activeRequests.erase(request)) {
             activatePendingRequest();
+            activatePendingRevalidations();
+        } else if (activeRevalidations.erase(request)) {
+            activatePendingRevalidations();
         } else {
             pendingRequests.remove(request);
+            pendingRevalidations.remove(request);
         }
     }
 
     void activateOrQueueRequest(OnlineFileRequest* request) {
         assert(allRequests.find(request) != allRequests.end());
         assert(activeRequests.find(request) == activeRequests.end());
+        assert(activeRevalidations.find(request) == activeRevalidations.end());
         assert(!request->request);
 
-        if (activeRequests.size() >= getMaximumConcurrentRequests()) {
-            queueRequest(request);
+        if (request->resource.priorUsable) {
+            // The requester can keep using its copy meanwhile, e.g. a cached tile that expired.
+            pendingRevalidations.insert(request);
+            activatePendingRevalidations();
+        } else if (activeRequests.size() >= getMaximumConcurrentRequests()) {
+            if (OnlineFileRequest* stale = findPreemptibleRequest(request)) {
+                preemptRequest(stale);
+                activateRequest(request);
+            } else {
+                queueRequest(request);
+            }
         } else {
             activateRequest(request);
         }
@@ -114,13 +134,22 @@ public:
 
     void activateRequest(OnlineFileRequest* request) {
         auto callback = [=](Response response) {
+            const bool revalidation = activeRevalidations.erase(request);
             activeRequests.erase(request);
             request->request.reset();
             request->completed(response);
-            activatePendingRequest();
+            if (!revalidation) {
+                activatePendingRequest();
+            }
+            activatePendingRevalidations();
         };
 
-        activeRequests.insert(request);
+        if (request->resource.priorUsable) {
+            activeRevalidations.insert(request);
+        } else {
+            activeRequests.insert(request);
+        }
+        request->activatedRank = request->resource.getRank();
 
         if (online) {
             request->request = httpFileSource.request(request->resource, callback);
@@ -133,6 +162,28 @@ public:
 
     }
 
+    // Returns the least useful active request that became stale, i.e. whose rank grew after it was
+    // activated, if it is outranked by the given request.
+    OnlineFileRequest* findPreemptibleRequest(const OnlineFileRequest* request) const {
+        OnlineFileRequest* candidate = nullptr;
+        for (auto active : activeRequests) {
+            if (active->resource.getRank() > active->activatedRank &&
+                PendingRequests::precedes(request, active) &&
+                (!candidate || PendingRequests::precedes(candidate, active))) {
+                candidate = active;
+            }
+        }
+        return candidate;
+    }
+
+    // Cancels an active request and puts it back into the queue, keeping the state it needs to
+    // resume, e.g. prior data and retry counters.
+    void preemptRequest(OnlineFileRequest* request) {
+        activeRequests.erase(request);
+        request->request.reset();
+        queueRequest(request);
+    }
+
     void activatePendingRequest() {
 
         auto request = pendingRequests.pop();
@@ -142,12 +193,27 @@ public:
         }
     }
 
+    // Revalidations only use connections that regular requests leave idle, so that they never
+    // delay resources the requester doesn't have yet.
+    void activatePendingRevalidations() {
+        while (pendingRequests.empty() &&
+               activeRequests.size() < getMaximumConcurrentRequests() &&
+               activeRevalidations.size() < getMaximumConcurrentRevalidations()) {
+            auto request = pendingRevalidations.pop();
+            if (!request) {
+                break;
+            }
+            activateRequest(*request);
+        }
+    }
+
     bool isPending(OnlineFileRequest* request) {
-        return pendingRequests.contains(request);
+        return pendingRequests.contains(request) || pendingRevalidations.contains(request);
     }
 
     bool isActive(OnlineFileRequest* request) {
-        return activeRequests.find(request) != activeRequests.end();
+        return activeRequests.find(request) != activeRequests.end() ||
+               activeRevalidations.find(request) != activeRevalidations.end();
     }
 
     void setResourceTransform(optional<ActorRef<ResourceTransform>>&& transform) {
@@ -167,6 +233,18 @@ public:
         maximumConcurrentRequests = maximumConcurrentRequests_;
     }
 
+    uint32_t getMaximumConcurrentRevalidations() const {
+        return maximumConcurrentRevalidations;
+    }
+
+    void setMaximumConcurrentRevalidations(uint32_t maximumConcurrentRevalidations_) {
+        maximumConcurrentRevalidations = maximumConcurrentRevalidations_;
+    }
+
+    void setConnectionOptions(const HTTPConnectionOptions& options) {
+        httpFileSource.setConnectionOptions(options);
+    }
+
 private:
 
     void networkIsReachableAgain() {
@@ -185,67 +263,60 @@ private:
         }
     }
 
-    // Using Pending Requests as an priority queue which processes
-    // file requests in a FIFO manner but prefers regular requests
-    // over offline requests with a low priority such that low priority
-    // requests do not throttle regular requests.
-    //
-    // The order of a queue is therefore:
+    // Using Pending Requests as a priority queue which prefers regular requests over offline
+    // requests with a low priority, such that low priority requests do not throttle regular
+    // requests. Requests of the same priority are processed in order of their rank, and in a FIFO
+    // manner for equal ranks.
     //
-    // hi0 -- hi1 -- hi2 -- hi3 -- lo0 -- lo1 --lo2
-    //                              ^
-    //                              firstLowPriorityRequest
+    // Ranks may change at any time while a request is pending, e.g. when the viewport moves, so
+    // the queue is ordered when a request is popped rather than when it is inserted.
 
     struct PendingRequests {
-        PendingRequests() : queue(), firstLowPriorityRequest(queue.begin()) {}
-
         std::list<OnlineFileRequest*> queue;
-        std::list<OnlineFileRequest*>::iterator firstLowPriorityRequest;
+
+        static bool precedes(const OnlineFileRequest* a, const OnlineFileRequest* b) {
+            if (a->resource.priority != b->resource.priority) {
+                return a->resource.priority == Resource::Priority::Regular;
+            }
+            return a->resource.getRank() < b->resource.getRank();
+        }
 
         void remove(const OnlineFileRequest* request) {
             auto it = std::find(queue.begin(), queue.end(), request);
             if (it != queue.end()) {
-                if (it == firstLowPriorityRequest) {
-                    firstLowPriorityRequest++;
-                }
                 queue.erase(it);
             }
         }
 
         void insert(OnlineFileRequest* request) {
-            if (request->resource.priority == Resource::Priority::Regular) {
-                firstLowPriorityRequest = queue.insert(firstLowPriorityRequest, request);
-                firstLowPriorityRequest++;
-            }
-            else {
-                if (firstLowPriorityRequest == queue.end()) {
-                    firstLowPriorityRequest = queue.insert(queue.end(), request);
-                }
-                else {
-                    queue.insert(queue.end(), request);
-                }
-            }
+            queue.push_back(request);
         }
 
-
         optional<OnlineFileRequest*> pop() {
             if (queue.empty()) {
                 return optional<OnlineFileRequest*>();
             }
 
-            if (queue.begin() == firstLowPriorityRequest) {
-                firstLowPriorityRequest++;
+            auto next = queue.begin();
+            for (auto it = std::next(next); it != queue.end(); ++it) {
+                if (precedes(*it, *next)) {
+                    next = it;
+                }
             }
 
-            OnlineFileRequest* next = queue.front();
-            queue.pop_front();
-            return optional<OnlineFileRequest*>(next);
+            OnlineFileRequest* request = *next;
+            queue.erase(next);
+            return optional<OnlineFileRequest*>(request);
         }
 
         bool contains(OnlineFileRequest* request) const {
             return (std::find(queue.begin(), queue.end(), request) != queue.end());
         }
 
+        bool empty() const {
+            return queue.empty();
+        }
+
     };
 
     optional<ActorRef<ResourceTransform>> resourceTransform;
@@ -259,16 +330,21 @@ private:
      * 4. Back to #1
      *
      * Requests in any state are in `allRequests`. Requests in the pending state are in
-     * `pendingRequests`. Requests in the active state are in `activeRequests`.
+     * `pendingRequests`. Requests in the active state are in `activeRequests`. Requests for
+     * resources the requester already holds a usable copy of are kept in `pendingRevalidations`
+     * and `activeRevalidations` instead.
      */
     std::unordered_set<OnlineFileRequest*> allRequests;
 
     PendingRequests pendingRequests;
+    PendingRequests pendingRevalidations;
 
     std::unordered_set<OnlineFileRequest*> activeRequests;
+    std::unordered_set<OnlineFileRequest*> activeRevalidations;
 
     bool online = true;
     uint32_t maximumConcurrentRequests;
+    uint32_t maximumConcurrentRevalidations;
     HTTPFileSource httpFileSource;
     util::AsyncTask reachability { std::bind(&Impl::networkIsReachableAgain, this) };
 };
@@ -446,6 +522,8 @@ void OnlineFileRequest::completed(Response response) {
     } else {
         failedRequests = 0;
         failedRequestReason = Response::Error::Reason::Success;
+        // Subsequent requests, e.g. once the response expires, only revalidate it.
+        resource.priorUsable = true;
     }
 
     schedule(response.expires);
@@ -488,6 +566,18 @@ uint32_t OnlineFileSource::getMaximumConcurrentRequests() const {
     return impl->getMaximumConcurrentRequests();
 }
 
+void OnlineFileSource::setMaximumConcurrentRevalidations(uint32_t maximumConcurrentRevalidations_) {
+    impl->setMaximumConcurrentRevalidations(maximumConcurrentRevalidations_);
+}
+
+uint32_t OnlineFileSource::getMaximumConcurrentRevalidations() const {
+    return impl->getMaximumConcurrentRevalidations();
+}
+
+void OnlineFileSource::setConnectionOptions(const HTTPConnectionOptions& options) {
+    impl->setConnectionOptions(options);
+}
+
 
 // For testing only:
 
@@ -4,6 +4,7 @@
 #include <mbgl/annotation/symbol_annotation_impl.hpp>
 #include <mbgl/annotation/line_annotation_impl.hpp>
 #include <mbgl/annotation/fill_annotation_impl.hpp>
+#include <mbgl/annotation/shape_annotation_batch.hpp>
 #include <mbgl/layermanager/layer_manager.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/style_impl.hpp>
@@ -11,8 +12,15 @@
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/style/expression/dsl.hpp>
 
+#include <mbgl/math/clamp.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/projection.hpp>
+
 #include <boost/function_output_iterator.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 // Note: LayerManager::annotationsEnabled is defined
 // at compile time, so that linker (with LTO on) is able
 // to optimize out the unreachable code.
@@ -53,7 +61,6 @@ AnnotationID AnnotationManager::addAnnotation(const Annotation& annotation) {
     Annotation::visit(annotation, [&] (const auto& annotation_) {
         this->add(id, annotation_);
     });
-    dirty = true;
     return id;
 }
 
@@ -70,25 +77,154 @@ void AnnotationManager::removeAnnotation(const AnnotationID& id) {
     CHECK_ANNOTATIONS_ENABLED_AND_RETURN();
     std::lock_guard<std::mutex> lock(mutex);
     remove(id);
-    dirty = true;
 }
 
 void AnnotationManager::add(const AnnotationID& id, const SymbolAnnotation& annotation) {
     auto impl = std::make_shared<SymbolAnnotationImpl>(id, annotation);
     symbolTree.insert(impl);
     symbolAnnotations.emplace(id, impl);
+    markDirty({ annotation.geometry, annotation.geometry });
 }
 
 void AnnotationManager::add(const AnnotationID& id, const LineAnnotation& annotation) {
-    ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
-        std::make_unique<LineAnnotationImpl>(id, annotation)).first->second;
-    impl.updateStyle(*style.get().impl);
+    addShape(std::make_unique<LineAnnotationImpl>(id, annotation));
 }
 
 void AnnotationManager::add(const AnnotationID& id, const FillAnnotation& annotation) {
-    ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(id,
-        std::make_unique<FillAnnotationImpl>(id, annotation)).first->second;
-    impl.updateStyle(*style.get().impl);
+    addShape(std::make_unique<FillAnnotationImpl>(id, annotation));
+}
+
+void AnnotationManager::addShape(std::unique_ptr<ShapeAnnotationImpl> shape) {
+    ShapeAnnotationImpl& impl = *shapeAnnotations.emplace(shape->id, std::move(shape)).first->second;
+
+    if (impl.batchProperties()) {
+        if (!openBatch || openBatch->kind != impl.kind() || openBatch->size() >= ShapeAnnotationBatch::maxSize) {
+            shapeBatches.push_back(makeBatch(impl));
+            openBatch = shapeBatches.back().get();
+        }
+        impl.batch = openBatch;
+        openBatch->add(impl);
+        openBatch->updateStyle(*style.get().impl);
+    } else {
+        openBatch = nullptr;
+        impl.updateStyle(*style.get().impl);
+    }
+
+    markDirty(impl.bounds());
+}
+
+// Returns the layer drawn right above the given one, if any.
+static optional<std::string> layerAbove(Style::Impl& style, const std::string& layerID) {
+    const auto layers = style.getLayers();
+    auto it = std::find_if(layers.begin(), layers.end(), [&] (const Layer* layer) {
+        return layer->getID() == layerID;
+    });
+    if (it == layers.end() || ++it == layers.end()) {
+        return {};
+    }
+    return (*it)->getID();
+}
+
+// Moves the layer right below the given one. Without one, the layer stays where it was added,
+// on top of the other shapes.
+static void moveLayer(Style::Impl& style, const std::string& layerID, const optional<std::string>& before) {
+    if (!before) {
+        return;
+    }
+    if (auto layer = style.removeLayer(layerID)) {
+        style.addLayer(std::move(layer), before);
+    }
+}
+
+void AnnotationManager::updateShape(ShapeAnnotationMap::iterator it, std::unique_ptr<ShapeAnnotationImpl> shape) {
+    ShapeAnnotationImpl& existing = *it->second;
+    markDirty(existing.bounds());
+    markDirty(shape->bounds());
+
+    ShapeAnnotationBatch* batch = existing.batch;
+    if (batch && batch->kind == shape->kind() && shape->batchProperties()) {
+        // Stays in its batch, and thus at its place in the draw order. Other batches keep their tiles.
+        shape->batch = batch;
+        it->second = std::move(shape);
+        batch->add(*it->second);
+        return;
+    }
+
+    // Otherwise the shape is drawn by a layer of its own at the place it was drawn at, even once
+    // it could be batched again: a shape changed this way is likely to change again.
+    optional<std::string> before;
+    if (batch) {
+        before = splitBatch(existing);
+        removeFromBatch(existing);
+    } else if (existing.kind() == shape->kind()) {
+        // Keeps its layer, which updateStyle() updates in place.
+        it->second = std::move(shape);
+        it->second->updateStyle(*style.get().impl);
+        return;
+    } else {
+        before = layerAbove(*style.get().impl, existing.layerID);
+        style.get().impl->removeLayer(existing.layerID);
+    }
+
+    it->second = std::move(shape);
+    it->second->updateStyle(*style.get().impl);
+    moveLayer(*style.get().impl, it->second->layerID, before);
+}
+
+std::unique_ptr<ShapeAnnotationBatch> AnnotationManager::makeBatch(const ShapeAnnotationImpl& impl) {
+    return std::make_unique<ShapeAnnotationBatch>(impl.kind(), ShapeLayerID + "batch." + util::toString(nextBatchID++));
+}
+
+optional<std::string> AnnotationManager::splitBatch(const ShapeAnnotationImpl& impl) {
+    ShapeAnnotationBatch* batch = impl.batch;
+    assert(batch);
+    const optional<std::string> above = layerAbove(*style.get().impl, batch->layerID);
+
+    std::unique_ptr<ShapeAnnotationBatch> upper = makeBatch(impl);
+    for (auto it = shapeAnnotations.upper_bound(impl.id); it != shapeAnnotations.end(); ++it) {
+        ShapeAnnotationImpl& shape = *it->second;
+        if (shape.batch == batch) {
+            batch->remove(shape.id);
+            upper->add(shape);
+            shape.batch = upper.get();
+            // Its features move to the layer of the new batch.
+            markDirty(shape.bounds());
+        }
+    }
+
+    if (openBatch == batch) {
+        // Shapes added later are drawn above the ones moved out, or above the given shape.
+        openBatch = upper->empty() ? nullptr : upper.get();
+    }
+    if (upper->empty()) {
+        return above;
+    }
+
+    upper->updateStyle(*style.get().impl);
+    moveLayer(*style.get().impl, upper->layerID, above);
+    optional<std::string> upperLayerID = upper->layerID;
+    shapeBatches.insert(std::find_if(shapeBatches.begin(), shapeBatches.end(), [&] (const auto& entry) {
+        return entry.get() == batch;
+    }) + 1, std::move(upper));
+    return upperLayerID;
+}
+
+void AnnotationManager::removeFromBatch(ShapeAnnotationImpl& impl) {
+    ShapeAnnotationBatch* batch = impl.batch;
+    assert(batch);
+    impl.batch = nullptr;
+    batch->remove(impl.id);
+    if (!batch->empty()) {
+        return;
+    }
+
+    style.get().impl->removeLayer(batch->layerID);
+    if (openBatch == batch) {
+        openBatch = nullptr;
+    }
+    shapeBatches.erase(std::find_if(shapeBatches.begin(), shapeBatches.end(), [&] (const auto& entry) {
+        return entry.get() == batch;
+    }));
 }
 
 void AnnotationManager::update(const AnnotationID& id, const SymbolAnnotation& annotation) {
@@ -101,8 +237,6 @@ void AnnotationManager::update(const AnnotationID& id, const SymbolAnnotation& a
     const SymbolAnnotation& existing = it->second->annotation;
 
     if (existing.geometry != annotation.geometry || existing.icon != annotation.icon) {
-        dirty = true;
-
         remove(id);
         add(id, annotation);
     }
@@ -115,9 +249,7 @@ void AnnotationManager::update(const AnnotationID& id, const LineAnnotation& ann
         return;
     }
 
-    shapeAnnotations.erase(it);
-    add(id, annotation);
-    dirty = true;
+    updateShape(it, std::make_unique<LineAnnotationImpl>(id, annotation));
 }
 
 void AnnotationManager::update(const AnnotationID& id, const FillAnnotation& annotation) {
@@ -127,25 +259,66 @@ void AnnotationManager::update(const AnnotationID& id, const FillAnnotation& ann
         return;
     }
 
-    shapeAnnotations.erase(it);
-    add(id, annotation);
-    dirty = true;
+    updateShape(it, std::make_unique<FillAnnotationImpl>(id, annotation));
 }
 
 void AnnotationManager::remove(const AnnotationID& id) {
     CHECK_ANNOTATIONS_ENABLED_AND_RETURN();
     if (symbolAnnotations.find(id) != symbolAnnotations.end()) {
+        const auto& geometry = symbolAnnotations.at(id)->annotation.geometry;
+        markDirty({ geometry, geometry });
         symbolTree.remove(symbolAnnotations.at(id));
         symbolAnnotations.erase(id);
     } else if (shapeAnnotations.find(id) != shapeAnnotations.end()) {
         auto it = shapeAnnotations.find(id);
-        *style.get().impl->removeLayer(it->second->layerID);
+        markDirty(it->second->bounds());
+        if (it->second->batch) {
+            removeFromBatch(*it->second);
+        } else {
+            style.get().impl->removeLayer(it->second->layerID);
+        }
         shapeAnnotations.erase(it);
     } else {
         assert(false); // Should never happen
     }
 }
 
+void AnnotationManager::markDirty(const mapbox::geometry::box<double>& box) {
+    const auto project = [] (const Point<double>& point) {
+        const LatLng latLng(util::clamp(point.y, -util::LATITUDE_MAX, util::LATITUDE_MAX), point.x);
+        return Projection::project(latLng, int32_t(0));
+    };
+    // Latitude grows northwards, while projected y grows southwards.
+    const auto northwest = project({ box.min.x, box.max.y });
+    const auto southeast = project({ box.max.x, box.min.y });
+    dirtyAreas.push_back({ northwest, southeast });
+    dirty = true;
+}
+
+// Whether a change within the given area may alter the tile's data. Shapes are tiled with a
+// buffer, so changes next to a tile may affect it as well.
+static bool affectsTile(const mapbox::geometry::box<double>& area, const CanonicalTileID& tileID) {
+    const double scale = std::pow(2.0, tileID.z);
+    const double buffer = double(ShapeAnnotationImpl::tileBuffer) / util::EXTENT;
+    const double minY = area.min.y * scale;
+    const double maxY = area.max.y * scale;
+    if (maxY < tileID.y - buffer || minY > tileID.y + 1 + buffer) {
+        return false;
+    }
+
+    // Compare against the tile in the world copies next to the one the area starts in, so that
+    // areas crossing the antimeridian are handled as well.
+    const double wrap = std::floor(area.min.x);
+    const double minX = (area.min.x - wrap) * scale;
+    const double maxX = (area.max.x - wrap) * scale;
+    for (double x = tileID.x - scale; x <= tileID.x + scale; x += scale) {
+        if (maxX >= x - buffer && minX <= x + 1 + buffer) {
+            return true;
+        }
+    }
+    return false;
+}
+
 std::unique_ptr<AnnotationTileData> AnnotationManager::getTileData(const CanonicalTileID& tileID) {
     if (symbolAnnotations.empty() && shapeAnnotations.empty())
         return nullptr;
@@ -168,7 +341,13 @@ std::unique_ptr<AnnotationTileData> AnnotationManager::getTileData(const Canonic
         }));
 
     for (const auto& shape : shapeAnnotations) {
-        shape.second->updateTileData(tileID, *tileData);
+        if (!shape.second->batch) {
+            shape.second->updateTileData(tileID, *tileData);
+        }
+    }
+
+    for (const auto& batch : shapeBatches) {
+        batch->updateTileData(tileID, *tileData);
     }
 
     return tileData;
@@ -194,7 +373,11 @@ void AnnotationManager::updateStyle() {
     std::lock_guard<std::mutex> lock(mutex);
 
     for (const auto& shape : shapeAnnotations) {
-        shape.second->updateStyle(*style.get().impl);
+        if (shape.second->batch) {
+            shape.second->batch->updateStyle(*style.get().impl);
+        } else {
+            shape.second->updateStyle(*style.get().impl);
+        }
     }
 
     for (const auto& image : images) {
@@ -213,8 +396,14 @@ void AnnotationManager::updateData() {
     std::lock_guard<std::mutex> lock(mutex);
     if (dirty) {
         for (auto& tile : tiles) {
-            tile->setData(getTileData(tile->id.canonical));
+            const CanonicalTileID& tileID = tile->id.canonical;
+            if (std::any_of(dirtyAreas.begin(), dirtyAreas.end(), [&] (const auto& area) {
+                    return affectsTile(area, tileID);
+                })) {
+                tile->setData(getTileData(tileID));
+            }
         }
+        dirtyAreas.clear();
         dirty = false;
     }
 }
@@ -4,6 +4,9 @@
 #include <mbgl/annotation/symbol_annotation_impl.hpp>
 #include <mbgl/style/image.hpp>
 #include <mbgl/util/noncopyable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <mapbox/geometry/box.hpp>
 
 #include <mutex>
 #include <string>
@@ -18,6 +21,7 @@ class AnnotationTile;
 class AnnotationTileData;
 class SymbolAnnotationImpl;
 class ShapeAnnotationImpl;
+class ShapeAnnotationBatch;
 
 namespace style {
 class Style;
@@ -59,6 +63,20 @@ private:
 
     void remove(const AnnotationID&);
 
+    using ShapeAnnotationMap = std::map<AnnotationID, std::unique_ptr<ShapeAnnotationImpl>>;
+
+    void addShape(std::unique_ptr<ShapeAnnotationImpl>);
+    void updateShape(ShapeAnnotationMap::iterator, std::unique_ptr<ShapeAnnotationImpl>);
+    // Creates an empty batch for shapes of the same kind as the given one.
+    std::unique_ptr<ShapeAnnotationBatch> makeBatch(const ShapeAnnotationImpl&);
+    // Moves the shapes drawn above the given one out of its batch, into a batch of their own.
+    // Returns the layer that a layer drawing the shape alone has to be placed below.
+    optional<std::string> splitBatch(const ShapeAnnotationImpl&);
+    void removeFromBatch(ShapeAnnotationImpl&);
+
+    // Marks the tiles that cover the given longitude/latitude box for regeneration.
+    void markDirty(const mapbox::geometry::box<double>&);
+
     void updateStyle();
 
     std::unique_ptr<AnnotationTileData> getTileData(const CanonicalTileID&);
@@ -68,19 +86,27 @@ private:
     std::mutex mutex;
 
     bool dirty = false;
-    
+    // Areas changed since the last updateData() call, in world coordinates ([0, 1] across the
+    // projected world). Only tiles near one of them are regenerated.
+    std::vector<mapbox::geometry::box<double>> dirtyAreas;
+
     AnnotationID nextID = 0;
 
     using SymbolAnnotationTree = boost::geometry::index::rtree<std::shared_ptr<const SymbolAnnotationImpl>, boost::geometry::index::rstar<16, 4>>;
     // Unlike std::unordered_map, std::map is guaranteed to sort by AnnotationID, ensuring that older annotations are below newer annotations.
     // <https://github.com/mapbox/mapbox-gl-native/issues/5691>
     using SymbolAnnotationMap = std::map<AnnotationID, std::shared_ptr<SymbolAnnotationImpl>>;
-    using ShapeAnnotationMap = std::map<AnnotationID, std::unique_ptr<ShapeAnnotationImpl>>;
     using ImageMap = std::unordered_map<std::string, style::Image>;
 
     SymbolAnnotationTree symbolTree;
     SymbolAnnotationMap symbolAnnotations;
     ShapeAnnotationMap shapeAnnotations;
+    // Batches drawing shapes with constant properties, in draw order. New shapes join the topmost
+    // batch as long as no shape with a layer of its own is drawn above it and it isn't full, which
+    // keeps the draw order of shapes intact.
+    std::vector<std::unique_ptr<ShapeAnnotationBatch>> shapeBatches;
+    ShapeAnnotationBatch* openBatch = nullptr;
+    uint64_t nextBatchID = 0;
     ImageMap images;
 
     std::unordered_set<AnnotationTile*> tiles;
@@ -2,6 +2,8 @@
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/style/style_impl.hpp>
 #include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/expression/dsl.hpp>
+#include <mbgl/util/string.hpp>
 
 namespace mbgl {
 
@@ -12,6 +14,10 @@ FillAnnotationImpl::FillAnnotationImpl(AnnotationID id_, FillAnnotation annotati
       annotation(ShapeAnnotationGeometry::visit(annotation_.geometry, CloseShapeAnnotation{}), annotation_.opacity, annotation_.color, annotation_.outlineColor) {
 }
 
+ShapeAnnotationImpl::Kind FillAnnotationImpl::kind() const {
+    return Kind::Fill;
+}
+
 void FillAnnotationImpl::updateStyle(Style::Impl& style) const {
     Layer* layer = style.getLayer(layerID);
 
@@ -31,4 +37,30 @@ const ShapeAnnotationGeometry& FillAnnotationImpl::geometry() const {
     return annotation.geometry;
 }
 
+optional<ShapeAnnotationImpl::Properties> FillAnnotationImpl::batchProperties() const {
+    if (!annotation.opacity.isConstant() || !annotation.color.isConstant() ||
+        !(annotation.outlineColor.isConstant() || annotation.outlineColor.isUndefined())) {
+        return {};
+    }
+
+    // An undefined outline color falls back to the fill color.
+    const Color& outlineColor = annotation.outlineColor.isConstant() ? annotation.outlineColor.asConstant()
+                                                                     : annotation.color.asConstant();
+    return Properties {
+        { "opacity", util::toString(annotation.opacity.asConstant()) },
+        { "color", annotation.color.asConstant().stringify() },
+        { "outline-color", outlineColor.stringify() },
+    };
+}
+
+void FillAnnotationImpl::addBatchLayer(Style::Impl& style, const std::string& batchLayerID) const {
+    using namespace expression::dsl;
+    auto layer = std::make_unique<FillLayer>(batchLayerID, AnnotationManager::SourceID);
+    layer->setSourceLayer(batchLayerID);
+    layer->setFillOpacity(PropertyExpression<float>(toNumber(get("opacity"))));
+    layer->setFillColor(PropertyExpression<Color>(toColor(get("color"))));
+    layer->setFillOutlineColor(PropertyExpression<Color>(toColor(get("outline-color"))));
+    style.addLayer(std::move(layer), AnnotationManager::PointLayerID);
+}
+
 } // namespace mbgl
@@ -9,8 +9,11 @@ class FillAnnotationImpl : public ShapeAnnotationImpl {
 public:
     FillAnnotationImpl(AnnotationID, FillAnnotation);
 
+    Kind kind() const final;
     void updateStyle(style::Style::Impl&) const final;
     const ShapeAnnotationGeometry& geometry() const final;
+    optional<Properties> batchProperties() const final;
+    void addBatchLayer(style::Style::Impl&, const std::string& batchLayerID) const final;
 
 private:
     const FillAnnotation annotation;
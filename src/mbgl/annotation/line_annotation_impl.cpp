@@ -2,6 +2,8 @@
 #include <mbgl/annotation/annotation_manager.hpp>
 #include <mbgl/style/style_impl.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/style/expression/dsl.hpp>
+#include <mbgl/util/string.hpp>
 
 namespace mbgl {
 
@@ -12,6 +14,10 @@ LineAnnotationImpl::LineAnnotationImpl(AnnotationID id_, LineAnnotation annotati
       annotation(ShapeAnnotationGeometry::visit(annotation_.geometry, CloseShapeAnnotation{}), annotation_.opacity, annotation_.width, annotation_.color) {
 }
 
+ShapeAnnotationImpl::Kind LineAnnotationImpl::kind() const {
+    return Kind::Line;
+}
+
 void LineAnnotationImpl::updateStyle(Style::Impl& style) const {
     Layer* layer = style.getLayer(layerID);
 
@@ -32,4 +38,27 @@ const ShapeAnnotationGeometry& LineAnnotationImpl::geometry() const {
     return annotation.geometry;
 }
 
+optional<ShapeAnnotationImpl::Properties> LineAnnotationImpl::batchProperties() const {
+    if (!annotation.opacity.isConstant() || !annotation.width.isConstant() || !annotation.color.isConstant()) {
+        return {};
+    }
+
+    return Properties {
+        { "opacity", util::toString(annotation.opacity.asConstant()) },
+        { "width", util::toString(annotation.width.asConstant()) },
+        { "color", annotation.color.asConstant().stringify() },
+    };
+}
+
+void LineAnnotationImpl::addBatchLayer(Style::Impl& style, const std::string& batchLayerID) const {
+    using namespace expression::dsl;
+    auto layer = std::make_unique<LineLayer>(batchLayerID, AnnotationManager::SourceID);
+    layer->setSourceLayer(batchLayerID);
+    layer->setLineJoin(LineJoinType::Round);
+    layer->setLineOpacity(PropertyExpression<float>(toNumber(get("opacity"))));
+    layer->setLineWidth(PropertyExpression<float>(toNumber(get("width"))));
+    layer->setLineColor(PropertyExpression<Color>(toColor(get("color"))));
+    style.addLayer(std::move(layer), AnnotationManager::PointLayerID);
+}
+
 } // namespace mbgl
@@ -0,0 +1,68 @@
+#include <mbgl/annotation/shape_annotation_batch.hpp>
+#include <mbgl/annotation/annotation_tile.hpp>
+#include <mbgl/style/style_impl.hpp>
+#include <mbgl/tile/tile_id.hpp>
+
+#include <cassert>
+
+namespace mbgl {
+
+constexpr std::size_t ShapeAnnotationBatch::maxSize;
+
+ShapeAnnotationBatch::ShapeAnnotationBatch(ShapeAnnotationImpl::Kind kind_, std::string layerID_)
+    : kind(kind_),
+      layerID(std::move(layerID_)) {
+}
+
+void ShapeAnnotationBatch::add(const ShapeAnnotationImpl& shape) {
+    assert(shape.kind() == kind);
+    shapes[shape.id] = &shape;
+    shapeTiler.reset();
+}
+
+void ShapeAnnotationBatch::remove(const AnnotationID& id) {
+    shapes.erase(id);
+    shapeTiler.reset();
+}
+
+void ShapeAnnotationBatch::updateStyle(style::Style::Impl& style) const {
+    if (shapes.empty() || style.getLayer(layerID)) {
+        return;
+    }
+
+    shapes.begin()->second->addBatchLayer(style, layerID);
+}
+
+void ShapeAnnotationBatch::updateTileData(const CanonicalTileID& tileID, AnnotationTileData& data) {
+    if (shapes.empty()) {
+        return;
+    }
+
+    if (!shapeTiler) {
+        mapbox::feature::feature_collection<double> features;
+        features.reserve(shapes.size());
+        for (const auto& entry : shapes) {
+            const ShapeAnnotationImpl& shape = *entry.second;
+            features.emplace_back(ShapeAnnotationGeometry::visit(shape.geometry(), [] (auto&& geom) {
+                return Feature { std::move(geom) };
+            }));
+            features.back().id = shape.id;
+
+            const auto properties = shape.batchProperties();
+            assert(properties);
+            for (const auto& property : *properties) {
+                features.back().properties.emplace(property.first, property.second);
+            }
+        }
+        shapeTiler = ShapeAnnotationImpl::createTiler(features);
+    }
+
+    const auto& shapeTile = shapeTiler->getTile(tileID.z, tileID.x, tileID.y);
+    if (shapeTile.features.empty())
+        return;
+
+    auto layer = data.addLayer(layerID);
+    ShapeAnnotationImpl::addTileFeatures(shapeTile, *layer);
+}
+
+} // namespace mbgl
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <mbgl/annotation/annotation.hpp>
+#include <mbgl/annotation/shape_annotation_impl.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace mbgl {
+
+class AnnotationTileData;
+class CanonicalTileID;
+
+// A group of shape annotations of the same kind drawn by a single style layer. The shapes are
+// tiled together, and each feature carries the paint properties of its shape, which the layer
+// reads with data-driven expressions.
+class ShapeAnnotationBatch : private util::noncopyable {
+public:
+    // Every change to a batch tiles all of its shapes anew, so batches are kept small.
+    static constexpr std::size_t maxSize = 128;
+
+    ShapeAnnotationBatch(ShapeAnnotationImpl::Kind, std::string layerID);
+
+    // Adds the shape, or replaces the shape with the same identifier.
+    void add(const ShapeAnnotationImpl&);
+    void remove(const AnnotationID&);
+    bool empty() const { return shapes.empty(); }
+    std::size_t size() const { return shapes.size(); }
+
+    void updateStyle(style::Style::Impl&) const;
+    void updateTileData(const CanonicalTileID&, AnnotationTileData&);
+
+    const ShapeAnnotationImpl::Kind kind;
+    const std::string layerID;
+
+private:
+    // Sorted by identifier, so that newer shapes are drawn above older ones.
+    std::map<AnnotationID, const ShapeAnnotationImpl*> shapes;
+    std::unique_ptr<mapbox::geojsonvt::GeoJSONVT> shapeTiler;
+};
+
+} // namespace mbgl
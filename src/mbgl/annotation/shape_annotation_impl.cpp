@@ -8,6 +8,8 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/geometry.hpp>
 
+#include <mapbox/geometry/envelope.hpp>
+
 namespace mbgl {
 
 using namespace style;
@@ -19,21 +21,13 @@ ShapeAnnotationImpl::ShapeAnnotationImpl(const AnnotationID id_)
 }
 
 void ShapeAnnotationImpl::updateTileData(const CanonicalTileID& tileID, AnnotationTileData& data) {
-    static const double baseTolerance = 4;
-
     if (!shapeTiler) {
         mapbox::feature::feature_collection<double> features;
         features.emplace_back(ShapeAnnotationGeometry::visit(geometry(), [] (auto&& geom) {
             return Feature { std::move(geom) };
         }));
-        mapbox::geojsonvt::Options options;
-        // The annotation source is currently hard coded to maxzoom 16, so we're topping out at z16
-        // here as well.
-        options.maxZoom = 16;
-        options.buffer = 255u;
-        options.extent = util::EXTENT;
-        options.tolerance = baseTolerance;
-        shapeTiler = std::make_unique<mapbox::geojsonvt::GeoJSONVT>(features, options);
+        features.back().id = id;
+        shapeTiler = createTiler(features);
     }
 
     const auto& shapeTile = shapeTiler->getTile(tileID.z, tileID.x, tileID.y);
@@ -41,7 +35,23 @@ void ShapeAnnotationImpl::updateTileData(const CanonicalTileID& tileID, Annotati
         return;
 
     auto layer = data.addLayer(layerID);
+    addTileFeatures(shapeTile, *layer);
+}
+
+std::unique_ptr<geojsonvt::GeoJSONVT> ShapeAnnotationImpl::createTiler(const mapbox::feature::feature_collection<double>& features) {
+    static const double baseTolerance = 4;
 
+    mapbox::geojsonvt::Options options;
+    // The annotation source is currently hard coded to maxzoom 16, so we're topping out at z16
+    // here as well.
+    options.maxZoom = 16;
+    options.buffer = tileBuffer;
+    options.extent = util::EXTENT;
+    options.tolerance = baseTolerance;
+    return std::make_unique<mapbox::geojsonvt::GeoJSONVT>(features, options);
+}
+
+void ShapeAnnotationImpl::addTileFeatures(const geojsonvt::Tile& shapeTile, AnnotationTileLayer& layer) {
     ToGeometryCollection toGeometryCollection;
     ToFeatureType toFeatureType;
     for (const auto& shapeFeature : shapeTile.features) {
@@ -55,8 +65,19 @@ void ShapeAnnotationImpl::updateTileData(const CanonicalTileID& tileID, Annotati
             renderGeometry = fixupPolygons(renderGeometry);
         }
 
-        layer->addFeature(id, featureType, renderGeometry);
+        Properties properties;
+        for (const auto& property : shapeFeature.properties) {
+            properties.emplace(property.first, property.second.get<std::string>());
+        }
+
+        layer.addFeature(shapeFeature.id.get<uint64_t>(), featureType, renderGeometry, std::move(properties));
     }
 }
 
+mapbox::geometry::box<double> ShapeAnnotationImpl::bounds() const {
+    return ShapeAnnotationGeometry::visit(geometry(), [] (const auto& geom) {
+        return mapbox::geometry::envelope(geom);
+    });
+}
+
 } // namespace mbgl
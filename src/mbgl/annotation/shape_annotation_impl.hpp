@@ -5,29 +5,64 @@
 
 #include <mbgl/annotation/annotation.hpp>
 #include <mbgl/util/geometry.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <mapbox/geometry/box.hpp>
 #include <mbgl/style/style.hpp>
 
 #include <string>
 #include <memory>
+#include <unordered_map>
 
 namespace mbgl {
 
 class AnnotationTileData;
+class AnnotationTileLayer;
 class CanonicalTileID;
+class ShapeAnnotationBatch;
 
 class ShapeAnnotationImpl {
 public:
+    enum class Kind : uint8_t {
+        Line,
+        Fill
+    };
+
+    using Properties = std::unordered_map<std::string, std::string>;
+
     ShapeAnnotationImpl(const AnnotationID);
     virtual ~ShapeAnnotationImpl() = default;
 
+    virtual Kind kind() const = 0;
     virtual void updateStyle(style::Style::Impl&) const = 0;
     virtual const ShapeAnnotationGeometry& geometry() const = 0;
 
+    // Shapes whose properties are all constant are drawn in batches of shapes of the same kind,
+    // sharing one style layer and one tiler. Returns the feature properties the batch layer reads
+    // the shape's paint properties from, or nothing if the shape needs a layer of its own.
+    virtual optional<Properties> batchProperties() const = 0;
+    // Adds a layer drawing a batch of shapes of this kind.
+    virtual void addBatchLayer(style::Style::Impl&, const std::string& batchLayerID) const = 0;
+
     void updateTileData(const CanonicalTileID&, AnnotationTileData&);
 
+    static std::unique_ptr<mapbox::geojsonvt::GeoJSONVT> createTiler(const mapbox::feature::feature_collection<double>&);
+    // Adds the features of the tile, keeping their identifiers and properties.
+    static void addTileFeatures(const mapbox::geojsonvt::Tile&, AnnotationTileLayer&);
+
+    // The smallest box containing the shape, in longitude/latitude. Used to find the tiles a
+    // change to the shape affects.
+    mapbox::geometry::box<double> bounds() const;
+
+    // Features are clipped with this buffer around each tile, in tile extent units.
+    static constexpr uint16_t tileBuffer = 255;
+
     const AnnotationID id;
     const std::string layerID;
     std::unique_ptr<mapbox::geojsonvt::GeoJSONVT> shapeTiler;
+
+    // The batch drawing this shape, if any. Owned by the AnnotationManager.
+    ShapeAnnotationBatch* batch = nullptr;
 };
 
 struct CloseShapeAnnotation {
@@ -26,6 +26,7 @@ public:
     static constexpr const uint32_t minimumRequiredVertexBindingCount = 8;
     const uint32_t maximumVertexBindingCount;
     bool supportsHalfFloatTextures = false;
+    bool supportsUInt32Indices = false;
 
 public:
     Context(Context&&) = delete;
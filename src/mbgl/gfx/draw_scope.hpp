@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <cassert>
+#include <cstddef>
 
 namespace mbgl {
 namespace gfx {
@@ -28,5 +29,23 @@ protected:
     std::unique_ptr<DrawScopeResource> resource;
 };
 
+// Draw scopes are looked up on every draw call, so they are keyed by a small integer. Draws that
+// don't belong to a layer use the reserved IDs below. The renderer hands out the IDs after them
+// to its layers, LayerDrawScopeCount consecutive IDs per layer, and reuses the IDs of removed
+// layers.
+using DrawScopeID = std::size_t;
+
+enum ReservedDrawScope : DrawScopeID {
+    ClippingDrawScope,
+    ImageDrawScope,
+    DebugTextOutlineDrawScope,
+    DebugTextDrawScope,
+    DebugBorderDrawScope,
+    ReservedDrawScopeCount
+};
+
+// Number of draw scopes of a layer, for layers that draw the same segments with several programs.
+constexpr DrawScopeID LayerDrawScopeCount = 3;
+
 } // namespace gfx
 } // namespace mbgl
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mbgl/gfx/types.hpp>
+
 #include <memory>
 #include <cassert>
 
@@ -15,11 +17,14 @@ public:
 
 class IndexBuffer {
 public:
-    IndexBuffer(const std::size_t elements_, std::unique_ptr<IndexBufferResource>&& resource_)
-        : elements(elements_), resource(std::move(resource_)) {
+    IndexBuffer(const std::size_t elements_,
+                std::unique_ptr<IndexBufferResource>&& resource_,
+                const IndexType type_ = IndexType::UnsignedShort)
+        : elements(elements_), type(type_), resource(std::move(resource_)) {
     }
 
     std::size_t elements;
+    IndexType type;
 
     template <typename T = IndexBufferResource>
     T& getResource() const {
@@ -1,17 +1,28 @@
 #pragma once
 
 #include <mbgl/gfx/draw_mode.hpp>
+#include <mbgl/gfx/types.hpp>
 #include <mbgl/util/ignore.hpp>
 
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
 namespace mbgl {
 namespace gfx {
 
-template <class DrawMode>
+template <class Index>
+struct IndexTypeOf;
+
+template <> struct IndexTypeOf<uint16_t> : std::integral_constant<IndexType, IndexType::UnsignedShort> {};
+template <> struct IndexTypeOf<uint32_t> : std::integral_constant<IndexType, IndexType::UnsignedInt> {};
+
+template <class DrawMode, class Index = uint16_t>
 class IndexVector {
 public:
     static constexpr std::size_t groupSize = BufferGroupSizeOf<DrawMode>::value;
+    static constexpr IndexType indexType = IndexTypeOf<Index>::value;
 
     template <class... Args>
     void emplace_back(Args&&... args) {
@@ -19,12 +30,23 @@ public:
         util::ignore({ (v.emplace_back(std::forward<Args>(args)), 0)... });
     }
 
+    // Appends `length` indices of another vector, starting at `offset`, with `base` added to each.
+    template <class OtherIndex>
+    void append(const IndexVector<DrawMode, OtherIndex>& other, std::size_t offset, std::size_t length, std::size_t base) {
+        assert(offset + length <= other.elements());
+        v.reserve(v.size() + length);
+        const OtherIndex* source = other.data() + offset;
+        for (std::size_t i = 0; i < length; ++i) {
+            v.push_back(static_cast<Index>(source[i] + base));
+        }
+    }
+
     std::size_t elements() const {
         return v.size();
     }
 
     std::size_t bytes() const {
-        return v.size() * sizeof(uint16_t);
+        return v.size() * sizeof(Index);
     }
 
     bool empty() const {
@@ -35,16 +57,16 @@ public:
         v.clear();
     }
 
-    const uint16_t* data() const {
+    const Index* data() const {
         return v.data();
     }
 
-    const std::vector<uint16_t>& vector() const {
+    const std::vector<Index>& vector() const {
         return v;
     }
 
 private:
-    std::vector<uint16_t> v;
+    std::vector<Index> v;
 };
 
 } // namespace gfx
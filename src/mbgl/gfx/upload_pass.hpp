@@ -29,6 +29,9 @@ public:
     }
 
 public:
+    // Whether index buffers may hold 32-bit indices.
+    virtual bool supportsUInt32Indices() const = 0;
+
     template <class Vertex>
     VertexBuffer<Vertex>
     createVertexBuffer(VertexVector<Vertex>&& v,
@@ -42,15 +45,16 @@ public:
         updateVertexBufferResource(buffer.getResource(), v.data(), v.bytes());
     }
 
-    template <class DrawMode>
-    IndexBuffer createIndexBuffer(IndexVector<DrawMode>&& v,
+    template <class DrawMode, class Index>
+    IndexBuffer createIndexBuffer(IndexVector<DrawMode, Index>&& v,
                                   const BufferUsageType usage = BufferUsageType::StaticDraw) {
-        return { v.elements(), createIndexBufferResource(v.data(), v.bytes(), usage) };
+        return { v.elements(), createIndexBufferResource(v.data(), v.bytes(), usage), v.indexType };
     }
 
-    template <class DrawMode>
-    void updateIndexBuffer(IndexBuffer& buffer, IndexVector<DrawMode>&& v) {
+    template <class DrawMode, class Index>
+    void updateIndexBuffer(IndexBuffer& buffer, IndexVector<DrawMode, Index>&& v) {
         assert(v.elements() == buffer.elements);
+        assert(v.indexType == buffer.type);
         updateIndexBufferResource(buffer.getResource(), v.data(), v.bytes());
     }
 
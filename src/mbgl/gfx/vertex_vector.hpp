@@ -34,6 +34,10 @@ public:
         v.clear();
     }
 
+    void reserve(std::size_t elements) {
+        v.reserve(elements);
+    }
+
     const Vertex* data() const {
         return v.data();
     }
@@ -117,6 +117,13 @@ void Context::initializeExtensions(const std::function<gl::ProcAddress(const cha
             supportsHalfFloatTextures = true;
         }
 
+#if MBGL_USE_GLES2
+        supportsUInt32Indices = strstr(extensions, "OES_element_index_uint") != nullptr;
+#else
+        // 32-bit indices are part of core desktop OpenGL.
+        supportsUInt32Indices = true;
+#endif
+
         if (!supportsVertexArrays()) {
             Log::Warning(Event::OpenGL, "Not using Vertex Array Objects");
         }
@@ -580,6 +587,7 @@ std::unique_ptr<gfx::CommandEncoder> Context::createCommandEncoder() {
 }
 
 void Context::draw(const gfx::DrawMode& drawMode,
+                   gfx::IndexType indexType,
                    std::size_t indexOffset,
                    std::size_t indexLength) {
     switch (drawMode.type) {
@@ -598,11 +606,13 @@ void Context::draw(const gfx::DrawMode& drawMode,
         break;
     }
 
+    const std::size_t indexSize = indexType == gfx::IndexType::UnsignedInt ? sizeof(uint32_t) : sizeof(uint16_t);
+
     MBGL_CHECK_ERROR(glDrawElements(
         Enum<gfx::DrawModeType>::to(drawMode.type),
         static_cast<GLsizei>(indexLength),
-        GL_UNSIGNED_SHORT,
-        reinterpret_cast<GLvoid*>(sizeof(uint16_t) * indexOffset)));
+        Enum<gfx::IndexType>::to(indexType),
+        reinterpret_cast<GLvoid*>(indexSize * indexOffset)));
 }
 
 void Context::performCleanup() {
@@ -89,6 +89,7 @@ public:
     void setCullFaceMode(const gfx::CullFaceMode&);
 
     void draw(const gfx::DrawMode&,
+              gfx::IndexType,
               std::size_t indexOffset,
               std::size_t indexLength);
 
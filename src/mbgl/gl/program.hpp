@@ -129,6 +129,7 @@ public:
                         instance.attributeLocations.toBindingArray(attributeBindings));
 
         context.draw(drawMode,
+                     indexBuffer.type,
                      indexOffset,
                      indexLength);
     }
@@ -16,6 +16,10 @@ UploadPass::UploadPass(gl::CommandEncoder& commandEncoder_, const char* name)
     : commandEncoder(commandEncoder_), debugGroup(commandEncoder.createDebugGroup(name)) {
 }
 
+bool UploadPass::supportsUInt32Indices() const {
+    return commandEncoder.context.supportsUInt32Indices;
+}
+
 std::unique_ptr<gfx::VertexBufferResource> UploadPass::createVertexBufferResource(
     const void* data, std::size_t size, const gfx::BufferUsageType usage) {
     BufferID id = 0;
@@ -22,6 +22,9 @@ private:
     void pushDebugGroup(const char* name) override;
     void popDebugGroup() override;
 
+public:
+    bool supportsUInt32Indices() const override;
+
 public:
     std::unique_ptr<gfx::VertexBufferResource> createVertexBufferResource(const void* data, std::size_t size, const gfx::BufferUsageType) override;
     void updateVertexBufferResource(gfx::VertexBufferResource&, const void* data, std::size_t size) override;
@@ -18,6 +18,12 @@ void VertexArray::bind(Context& context,
         }
         state->bindings[location] = bindings[location];
     }
+
+    // Disable attributes enabled by an earlier draw with more attributes. Draw scopes may be shared
+    // by draws with different attribute sets, e.g. when a removed layer's draw scope ID is reused.
+    for (AttributeLocation location = bindings.size(); location < state->bindings.size(); ++location) {
+        state->bindings[location] = nullopt;
+    }
 }
 
 } // namespace gl
@@ -15,6 +15,11 @@ std::unique_ptr<style::Layer> BackgroundLayerFactory::createLayer(const std::str
     return std::unique_ptr<style::Layer>(new style::BackgroundLayer(id));
 }
 
+std::unique_ptr<style::Layer> BackgroundLayerFactory::createLayer(Immutable<style::Layer::Impl> impl) noexcept {
+    assert(impl->getTypeInfo() == getTypeInfo());
+    return std::make_unique<style::BackgroundLayer>(staticImmutableCast<style::BackgroundLayer::Impl>(std::move(impl)));
+}
+
 std::unique_ptr<RenderLayer> BackgroundLayerFactory::createRenderLayer(Immutable<style::Layer::Impl> impl) noexcept {
     assert(impl->getTypeInfo() == getTypeInfo());
     return std::make_unique<RenderBackgroundLayer>(staticImmutableCast<style::BackgroundLayer::Impl>(std::move(impl)));
@@ -24,6 +24,11 @@ std::unique_ptr<style::Layer> CircleLayerFactory::createLayer(const std::string&
     return layer;
 }
 
+std::unique_ptr<style::Layer> CircleLayerFactory::createLayer(Immutable<style::Layer::Impl> impl) noexcept {
+    assert(impl->getTypeInfo() == getTypeInfo());
+    return std::make_unique<style::CircleLayer>(staticImmutableCast<style::CircleLayer::Impl>(std::move(impl)));
+}
+
 std::unique_ptr<Bucket> CircleLayerFactory::createBucket(const BucketParameters& parameters, const std::vector<Immutable<style::LayerProperties>>& layers) noexcept {
     return std::make_unique<CircleBucket>(parameters, layers);
 }
@@ -15,6 +15,11 @@ std::unique_ptr<style::Layer> CustomLayerFactory::createLayer(const std::string&
     return nullptr;
 }
 
+std::unique_ptr<style::Layer> CustomLayerFactory::createLayer(Immutable<style::Layer::Impl>) noexcept {
+    assert(false);
+    return nullptr;
+}
+
 std::unique_ptr<RenderLayer> CustomLayerFactory::createRenderLayer(Immutable<style::Layer::Impl> impl) noexcept {
     return std::make_unique<RenderCustomLayer>(staticImmutableCast<style::CustomLayer::Impl>(std::move(impl)));
 }
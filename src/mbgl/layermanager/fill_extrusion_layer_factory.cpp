@@ -24,6 +24,11 @@ std::unique_ptr<style::Layer> FillExtrusionLayerFactory::createLayer(const std::
     return layer;
 }
 
+std::unique_ptr<style::Layer> FillExtrusionLayerFactory::createLayer(Immutable<style::Layer::Impl> impl) noexcept {
+    assert(impl->getTypeInfo() == getTypeInfo());
+    return std::make_unique<style::FillExtrusionLayer>(staticImmutableCast<style::FillExtrusionLayer::Impl>(std::move(impl)));
+}
+
 std::unique_ptr<Layout> FillExtrusionLayerFactory::createLayout(const LayoutParameters& parameters,
                                                                 std::unique_ptr<GeometryTileLayer> layer,
                                                                 const std::vector<Immutable<style::LayerProperties>>& group) noexcept {
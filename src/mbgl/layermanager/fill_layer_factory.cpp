@@ -24,6 +24,11 @@ std::unique_ptr<style::Layer> FillLayerFactory::createLayer(const std::string& i
     return layer;
 }
 
+std::unique_ptr<style::Layer> FillLayerFactory::createLayer(Immutable<style::Layer::Impl> impl) noexcept {
+    assert(impl->getTypeInfo() == getTypeInfo());
+    return std::make_unique<style::FillLayer>(staticImmutableCast<style::FillLayer::Impl>(std::move(impl)));
+}
+
 std::unique_ptr<Layout>
 FillLayerFactory::createLayout(const LayoutParameters& parameters,
                                std::unique_ptr<GeometryTileLayer> layer,
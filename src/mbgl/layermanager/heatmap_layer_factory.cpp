@@ -24,6 +24,11 @@ std::unique_ptr<style::Layer> HeatmapLayerFactory::createLayer(const std::string
     return layer;
 }
 
+std::unique_ptr<style::Layer> HeatmapLayerFactory::createLayer(Immutable<style::Layer::Impl> impl) noexcept {
+    assert(impl->getTypeInfo() == getTypeInfo());
+    return std::make_unique<style::HeatmapLayer>(staticImmutableCast<style::HeatmapLayer::Impl>(std::move(impl)));
+}
+
 std::unique_ptr<Bucket> HeatmapLayerFactory::createBucket(const BucketParameters& parameters, const std::vector<Immutable<style::LayerProperties>>& layers) noexcept {
     return std::make_unique<HeatmapBucket>(parameters, layers);
 }
@@ -25,6 +25,12 @@ std::unique_ptr<style::Layer> LayerManager::createLayer(
     return nullptr;
 }
 
+std::unique_ptr<style::Layer> LayerManager::createLayer(Immutable<style::Layer::Impl> impl) noexcept {
+    LayerFactory* factory = getFactory(impl->getTypeInfo());
+    assert(factory);
+    return factory->createLayer(std::move(impl));
+}
+
 std::unique_ptr<Bucket> LayerManager::createBucket(const BucketParameters& parameters,
                                                    const std::vector<Immutable<style::LayerProperties>>& layers) noexcept {
     assert(!layers.empty());
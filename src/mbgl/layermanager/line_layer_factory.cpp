@@ -24,6 +24,11 @@ std::unique_ptr<style::Layer> LineLayerFactory::createLayer(const std::string& i
     return layer;
 }
 
+std::unique_ptr<style::Layer> LineLayerFactory::createLayer(Immutable<style::Layer::Impl> impl) noexcept {
+    assert(impl->getTypeInfo() == getTypeInfo());
+    return std::make_unique<style::LineLayer>(staticImmutableCast<style::LineLayer::Impl>(std::move(impl)));
+}
+
 std::unique_ptr<Layout> LineLayerFactory::createLayout(const LayoutParameters& parameters,
                                                        std::unique_ptr<GeometryTileLayer> layer,
                                                        const std::vector<Immutable<style::LayerProperties>>& group) noexcept {
@@ -20,6 +20,11 @@ std::unique_ptr<style::Layer> RasterLayerFactory::createLayer(const std::string&
     return layer;
 }
 
+std::unique_ptr<style::Layer> RasterLayerFactory::createLayer(Immutable<style::Layer::Impl> impl) noexcept {
+    assert(impl->getTypeInfo() == getTypeInfo());
+    return std::make_unique<style::RasterLayer>(staticImmutableCast<style::RasterLayer::Impl>(std::move(impl)));
+}
+
 std::unique_ptr<RenderLayer> RasterLayerFactory::createRenderLayer(Immutable<style::Layer::Impl> impl) noexcept {
     assert(impl->getTypeInfo() == getTypeInfo());
     return std::make_unique<RenderRasterLayer>(staticImmutableCast<style::RasterLayer::Impl>(std::move(impl)));
@@ -24,6 +24,11 @@ std::unique_ptr<style::Layer> SymbolLayerFactory::createLayer(const std::string&
     return layer;
 }
 
+std::unique_ptr<style::Layer> SymbolLayerFactory::createLayer(Immutable<style::Layer::Impl> impl) noexcept {
+    assert(impl->getTypeInfo() == getTypeInfo());
+    return std::make_unique<style::SymbolLayer>(staticImmutableCast<style::SymbolLayer::Impl>(std::move(impl)));
+}
+
 std::unique_ptr<Layout> SymbolLayerFactory::createLayout(const LayoutParameters& parameters,
                                                          std::unique_ptr<GeometryTileLayer> tileLayer,
                                                          const std::vector<Immutable<style::LayerProperties>>& group) noexcept {
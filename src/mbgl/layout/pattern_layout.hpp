@@ -102,15 +102,24 @@ public:
 
     void createBucket(const ImagePositions& patternPositions, std::unique_ptr<FeatureIndex>& featureIndex, std::unordered_map<std::string, LayerRenderData>& renderData, const bool, const bool) override {
         auto bucket = std::make_shared<BucketType>(layout, layerPropertiesMap, zoom, overscaling);
-        for (auto & patternFeature : features) {
-            const auto i = patternFeature.i;
-            std::unique_ptr<GeometryTileFeature> feature = std::move(patternFeature.feature);
-            const PatternLayerMap& patterns = patternFeature.patterns;
-            GeometryCollection geometries = feature->getGeometries();
-
-            bucket->addFeature(*feature, geometries, patternPositions, patterns);
-            featureIndex->insert(geometries, i, sourceLayerID, bucketLeaderID);
+
+        std::vector<GeometryCollection> geometries;
+        geometries.reserve(features.size());
+        for (const auto& patternFeature : features) {
+            geometries.push_back(patternFeature.feature->getGeometries());
+        }
+
+        std::vector<BucketFeature> bucketFeatures;
+        bucketFeatures.reserve(features.size());
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            bucketFeatures.push_back({ *features[i].feature, geometries[i], features[i].patterns });
+        }
+        bucket->addFeatures(bucketFeatures, patternPositions);
+
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            featureIndex->insert(geometries[i], features[i].i, sourceLayerID, bucketLeaderID);
         }
+        features.clear();
         if (bucket->hasData()) {
             for (const auto& pair : layerPropertiesMap) {
                 renderData.emplace(pair.first, LayerRenderData {bucket, pair.second});
@@ -6,6 +6,7 @@
 #include <mbgl/renderer/image_atlas.hpp>
 #include <mbgl/text/get_anchors.hpp>
 #include <mbgl/text/shaping.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/util/utf.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/string.hpp>
@@ -16,6 +17,9 @@
 
 #include <mapbox/polylabel.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace mbgl {
 
 using namespace style;
@@ -287,7 +291,7 @@ void SymbolLayout::prepareSymbols(const GlyphMap& glyphMap, const GlyphPositions
             const float spacing = util::i18n::allowsLetterSpacing(feature.formattedText->rawText()) ? layout.evaluate<TextLetterSpacing>(zoom, feature) * util::ONE_EM : 0.0f;
 
             auto applyShaping = [&] (const TaggedString& formattedText, WritingModeType writingMode, SymbolAnchorType textAnchor, TextJustifyType textJustify) {
-                const Shaping result = getShaping(
+                const Shaping result = ShapingCache::shared().getShaping(
                     /* string */ formattedText,
                     /* maxWidth: ems */ isPointPlacement ? layout.evaluate<TextMaxWidth>(zoom, feature) * util::ONE_EM : 0.0f,
                     /* ems */ lineHeight,
@@ -519,17 +523,33 @@ void SymbolLayout::addFeature(const std::size_t layoutFeatureIndex,
 }
 
 bool SymbolLayout::anchorIsTooClose(const std::u16string& text, const float repeatDistance, const Anchor& anchor) {
-    if (compareText.find(text) == compareText.end()) {
-        compareText.emplace(text, Anchors());
-    } else {
-        auto otherAnchors = compareText.find(text)->second;
-        for (const Anchor& otherAnchor : otherAnchors) {
-            if (util::dist<float>(anchor.point, otherAnchor.point) < repeatDistance) {
-                return true;
+    // Cells are a bit larger than the repeat distance, so that any anchor closer than that lies
+    // in the same cell as this one or in a neighbouring cell, regardless of rounding.
+    const double cellSize = std::max(repeatDistance * 1.01, 1.0);
+    const auto cellCoordinate = [&] (float coordinate) {
+        return static_cast<int32_t>(std::floor(coordinate / cellSize));
+    };
+    const auto cellKey = [] (int32_t x, int32_t y) {
+        return (uint64_t(uint32_t(x)) << 32) | uint32_t(y);
+    };
+
+    auto& cells = compareText[text];
+    const int32_t cellX = cellCoordinate(anchor.point.x);
+    const int32_t cellY = cellCoordinate(anchor.point.y);
+    for (int32_t x = cellX - 1; x <= cellX + 1; ++x) {
+        for (int32_t y = cellY - 1; y <= cellY + 1; ++y) {
+            const auto cell = cells.find(cellKey(x, y));
+            if (cell == cells.end()) {
+                continue;
+            }
+            for (const Point<float>& otherPoint : cell->second) {
+                if (util::dist<float>(anchor.point, otherPoint) < repeatDistance) {
+                    return true;
+                }
             }
         }
     }
-    compareText[text].push_back(anchor);
+    cells[cellKey(cellX, cellY)].push_back(anchor.point);
     return false;
 }
 
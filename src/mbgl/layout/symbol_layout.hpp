@@ -10,6 +10,7 @@
 
 #include <memory>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace mbgl {
@@ -56,7 +57,8 @@ private:
                     Point<float> textOffset);
 
     bool anchorIsTooClose(const std::u16string& text, const float repeatDistance, const Anchor&);
-    std::map<std::u16string, std::vector<Anchor>> compareText;
+    // Anchors of the labels added so far, by text, and by the grid cell they fall into.
+    std::unordered_map<std::u16string, std::unordered_map<uint64_t, std::vector<Point<float>>>> compareText;
 
     void addToDebugBuffers(SymbolBucket&);
 
@@ -6,6 +6,8 @@
 #include <mbgl/util/optional.hpp>
 #include <mbgl/util/math.hpp>
 
+#include <algorithm>
+
 namespace mbgl {
 
 	/*
@@ -93,10 +95,33 @@ namespace mbgl {
     }
 
     PointAndCameraDistance project(const Point<float>& point, const mat4& matrix) {
-        vec4 pos = {{ point.x, point.y, 0, 1 }};
-        matrix::transformMat4(pos, pos, matrix);
-        return {{ static_cast<float>(pos[0] / pos[3]), static_cast<float>(pos[1] / pos[3]) }, pos[3] };
+        // Points are on the z = 0 plane with w = 1, so only the x, y and translation
+        // columns of the matrix contribute; skip the full vec4 transform.
+        const double x = point.x;
+        const double y = point.y;
+        const double w = matrix[3] * x + matrix[7] * y + matrix[15];
+        return {{ static_cast<float>((matrix[0] * x + matrix[4] * y + matrix[12]) / w),
+                  static_cast<float>((matrix[1] * x + matrix[5] * y + matrix[13]) / w) }, w };
+    }
+
+    void resetProjectionCache(ProjectionCache& projectionCache, const PlacedSymbol& symbol) {
+        projectionCache.assign(symbol.line.size(), nullopt);
+    }
+
+    namespace {
+    // Number of line vertices projected at once, in the direction glyph placement walks the line.
+    constexpr int32_t lineVertexBatchSize = 8;
+
+    void projectLineVertices(const GeometryCoordinates& line, const int32_t index, const int16_t dir, const mat4& matrix, ProjectionCache& projectionCache) {
+        const int32_t first = dir > 0 ? index : std::max(0, index - lineVertexBatchSize + 1);
+        const int32_t last = dir > 0 ? std::min<int32_t>(line.size(), index + lineVertexBatchSize) : index + 1;
+        std::array<PointAndCameraDistance, lineVertexBatchSize> projections;
+        projectPoints(line.data() + first, last - first, matrix, projections.data());
+        for (int32_t i = first; i < last; ++i) {
+            projectionCache[i] = projections[i - first];
+        }
     }
+    } // namespace
 
     float evaluateSizeForFeature(const ZoomEvaluatedSize& zoomEvaluatedSize, const PlacedSymbol& placedSymbol) {
         if (zoomEvaluatedSize.isFeatureConstant) {
@@ -110,9 +135,9 @@ namespace mbgl {
         }
     }
 
-    bool isVisible(const vec4& anchorPos, const std::array<double, 2>& clippingBuffer) {
-        const float x = anchorPos[0] / anchorPos[3];
-        const float y = anchorPos[1] / anchorPos[3];
+    bool isVisible(const Point<float>& anchorPos, const std::array<double, 2>& clippingBuffer) {
+        const float x = anchorPos.x;
+        const float y = anchorPos.y;
         const bool inPaddedViewport = (
                 x >= -clippingBuffer[0] &&
                 x <= clippingBuffer[0] &&
@@ -156,7 +181,9 @@ namespace mbgl {
     }
 
 	optional<PlacedGlyph> placeGlyphAlongLine(const float offsetX, const float lineOffsetX, const float lineOffsetY, const bool flip,
-            const Point<float>& projectedAnchorPoint, const Point<float>& tileAnchorPoint, const uint16_t anchorSegment, const GeometryCoordinates& line, const std::vector<float>& tileDistances, const mat4& labelPlaneMatrix, const bool returnTileDistance) {
+            const Point<float>& projectedAnchorPoint, const Point<float>& tileAnchorPoint, const uint16_t anchorSegment, const GeometryCoordinates& line, const std::vector<float>& tileDistances, const mat4& labelPlaneMatrix, const bool returnTileDistance,
+            ProjectionCache& projectionCache) {
+        assert(projectionCache.size() == line.size());
 
         const float combinedOffsetX = flip ?
             offsetX - lineOffsetX :
@@ -192,7 +219,10 @@ namespace mbgl {
             }
 
             prev = current;
-            PointAndCameraDistance projection = project(convertPoint<float>(line.at(currentIndex)), labelPlaneMatrix);
+            if (!projectionCache[currentIndex]) {
+                projectLineVertices(line, currentIndex, dir, labelPlaneMatrix, projectionCache);
+            }
+            const PointAndCameraDistance& projection = *projectionCache[currentIndex];
             if (projection.second > 0) {
                 current = projection.first;
             } else {
@@ -239,7 +269,8 @@ namespace mbgl {
                                                             const Point<float>& tileAnchorPoint,
                                                             const PlacedSymbol& symbol,
                                                             const mat4& labelPlaneMatrix,
-                                                            const bool returnTileDistance) {
+                                                            const bool returnTileDistance,
+                                                            ProjectionCache& projectionCache) {
         if (symbol.glyphOffsets.empty()) {
             assert(false);
             return optional<std::pair<PlacedGlyph, PlacedGlyph>>();
@@ -248,11 +279,11 @@ namespace mbgl {
         const float firstGlyphOffset = symbol.glyphOffsets.front();
         const float lastGlyphOffset = symbol.glyphOffsets.back();;
 
-        optional<PlacedGlyph> firstPlacedGlyph = placeGlyphAlongLine(fontScale * firstGlyphOffset, lineOffsetX, lineOffsetY, flip, anchorPoint, tileAnchorPoint, symbol.segment, symbol.line, symbol.tileDistances, labelPlaneMatrix,  returnTileDistance);
+        optional<PlacedGlyph> firstPlacedGlyph = placeGlyphAlongLine(fontScale * firstGlyphOffset, lineOffsetX, lineOffsetY, flip, anchorPoint, tileAnchorPoint, symbol.segment, symbol.line, symbol.tileDistances, labelPlaneMatrix, returnTileDistance, projectionCache);
         if (!firstPlacedGlyph)
             return optional<std::pair<PlacedGlyph, PlacedGlyph>>();
 
-        optional<PlacedGlyph> lastPlacedGlyph = placeGlyphAlongLine(fontScale * lastGlyphOffset, lineOffsetX, lineOffsetY, flip, anchorPoint, tileAnchorPoint, symbol.segment, symbol.line, symbol.tileDistances, labelPlaneMatrix, returnTileDistance);
+        optional<PlacedGlyph> lastPlacedGlyph = placeGlyphAlongLine(fontScale * lastGlyphOffset, lineOffsetX, lineOffsetY, flip, anchorPoint, tileAnchorPoint, symbol.segment, symbol.line, symbol.tileDistances, labelPlaneMatrix, returnTileDistance, projectionCache);
         if (!lastPlacedGlyph)
             return optional<std::pair<PlacedGlyph, PlacedGlyph>>();
 
@@ -290,7 +321,8 @@ namespace mbgl {
                               const mat4& glCoordMatrix,
                               gfx::VertexVector<gfx::Vertex<SymbolDynamicLayoutAttributes>>& dynamicVertexArray,
                               const Point<float>& projectedAnchorPoint,
-                              const float aspectRatio) {
+                              const float aspectRatio,
+                              ProjectionCache& projectionCache) {
         const float fontScale = fontSize / util::ONE_EM;
         const float lineOffsetX = symbol.lineOffset[0] * fontScale;
         const float lineOffsetY = symbol.lineOffset[1] * fontScale;
@@ -299,7 +331,7 @@ namespace mbgl {
         if (symbol.glyphOffsets.size() > 1) {
 
             const optional<std::pair<PlacedGlyph, PlacedGlyph>> firstAndLastGlyph =
-                placeFirstAndLastGlyph(fontScale, lineOffsetX, lineOffsetY, flip, projectedAnchorPoint, symbol.anchorPoint, symbol, labelPlaneMatrix, false);
+                placeFirstAndLastGlyph(fontScale, lineOffsetX, lineOffsetY, flip, projectedAnchorPoint, symbol.anchorPoint, symbol, labelPlaneMatrix, false, projectionCache);
             if (!firstAndLastGlyph) {
                 return PlacementResult::NotEnoughRoom;
             }
@@ -318,7 +350,7 @@ namespace mbgl {
             for (size_t glyphIndex = 1; glyphIndex < symbol.glyphOffsets.size() - 1; glyphIndex++) {
                 const float glyphOffsetX = symbol.glyphOffsets[glyphIndex];
                 // Since first and last glyph fit on the line, we're sure that the rest of the glyphs can be placed
-                auto placedGlyph = placeGlyphAlongLine(glyphOffsetX * fontScale, lineOffsetX, lineOffsetY, flip, projectedAnchorPoint, symbol.anchorPoint, symbol.segment, symbol.line, symbol.tileDistances, labelPlaneMatrix, false);
+                auto placedGlyph = placeGlyphAlongLine(glyphOffsetX * fontScale, lineOffsetX, lineOffsetY, flip, projectedAnchorPoint, symbol.anchorPoint, symbol.segment, symbol.line, symbol.tileDistances, labelPlaneMatrix, false, projectionCache);
                 placedGlyphs.push_back(*placedGlyph);
             }
             placedGlyphs.push_back(firstAndLastGlyph->second);
@@ -343,7 +375,7 @@ namespace mbgl {
             }
             const float glyphOffsetX = symbol.glyphOffsets.front();
             optional<PlacedGlyph> singleGlyph = placeGlyphAlongLine(fontScale * glyphOffsetX, lineOffsetX, lineOffsetY, flip, projectedAnchorPoint, symbol.anchorPoint, symbol.segment,
-                symbol.line, symbol.tileDistances, labelPlaneMatrix, false);
+                symbol.line, symbol.tileDistances, labelPlaneMatrix, false, projectionCache);
             if (!singleGlyph)
                 return PlacementResult::NotEnoughRoom;
 
@@ -378,8 +410,21 @@ namespace mbgl {
         dynamicVertexArray.clear();
         
         bool useVertical = false;
+        ProjectionCache projectionCache;
 
-        for (auto& placedSymbol : placedSymbols) {
+        // Project the anchors of all symbols at once, both to clip space and to the label plane.
+        std::vector<Point<float>> anchors;
+        anchors.reserve(placedSymbols.size());
+        for (const auto& placedSymbol : placedSymbols) {
+            anchors.push_back(placedSymbol.anchorPoint);
+        }
+        std::vector<PointAndCameraDistance> clipSpaceAnchors(anchors.size());
+        std::vector<PointAndCameraDistance> labelPlaneAnchors(anchors.size());
+        projectPoints(anchors.data(), anchors.size(), posMatrix, clipSpaceAnchors.data());
+        projectPoints(anchors.data(), anchors.size(), labelPlaneMatrix, labelPlaneAnchors.data());
+
+        for (std::size_t i = 0; i < placedSymbols.size(); ++i) {
+            const auto& placedSymbol = placedSymbols[i];
             // Don't do calculations for vertical glyphs unless the previous symbol was horizontal
             // and we determined that vertical glyphs were necessary.
             // Also don't do calculations for symbols that are collided and fully faded out
@@ -390,16 +435,13 @@ namespace mbgl {
             // Awkward... but we're counting on the paired "vertical" symbol coming immediately after its horizontal counterpart
             useVertical = false;
             
-			vec4 anchorPos = {{ placedSymbol.anchorPoint.x, placedSymbol.anchorPoint.y, 0, 1 }};
-            matrix::transformMat4(anchorPos, anchorPos, posMatrix);
-
             // Don't bother calculating the correct point for invisible labels.
-            if (!isVisible(anchorPos, clippingBuffer)) {
+            if (!isVisible(clipSpaceAnchors[i].first, clippingBuffer)) {
                 hideGlyphs(placedSymbol.glyphOffsets.size(), dynamicVertexArray);
                 continue;
             }
 
-            const float cameraToAnchorDistance = anchorPos[3];
+            const float cameraToAnchorDistance = clipSpaceAnchors[i].second;
             const float perspectiveRatio = 0.5 + 0.5 * (cameraToAnchorDistance / state.getCameraToCenterDistance());
 
             const float fontSize = evaluateSizeForFeature(partiallyEvaluatedSize, placedSymbol);
@@ -407,15 +449,17 @@ namespace mbgl {
                 fontSize * perspectiveRatio :
                 fontSize / perspectiveRatio;
             
-            const Point<float> anchorPoint = project(placedSymbol.anchorPoint, labelPlaneMatrix).first;
+            const Point<float> anchorPoint = labelPlaneAnchors[i].first;
+            // Shared by the unflipped and flipped attempts below: both walk the same line vertices.
+            resetProjectionCache(projectionCache, placedSymbol);
 
-            PlacementResult placeUnflipped = placeGlyphsAlongLine(placedSymbol, pitchScaledFontSize, false /*unflipped*/, keepUpright, posMatrix, labelPlaneMatrix, glCoordMatrix, dynamicVertexArray, anchorPoint, state.getSize().aspectRatio());
+            PlacementResult placeUnflipped = placeGlyphsAlongLine(placedSymbol, pitchScaledFontSize, false /*unflipped*/, keepUpright, posMatrix, labelPlaneMatrix, glCoordMatrix, dynamicVertexArray, anchorPoint, state.getSize().aspectRatio(), projectionCache);
             
             useVertical = placeUnflipped == PlacementResult::UseVertical;
 
             if (placeUnflipped == PlacementResult::NotEnoughRoom || useVertical ||
                 (placeUnflipped == PlacementResult::NeedsFlipping &&
-                 placeGlyphsAlongLine(placedSymbol, pitchScaledFontSize, true /*flipped*/, keepUpright, posMatrix, labelPlaneMatrix, glCoordMatrix, dynamicVertexArray, anchorPoint, state.getSize().aspectRatio()) == PlacementResult::NotEnoughRoom)) {
+                 placeGlyphsAlongLine(placedSymbol, pitchScaledFontSize, true /*flipped*/, keepUpright, posMatrix, labelPlaneMatrix, glCoordMatrix, dynamicVertexArray, anchorPoint, state.getSize().aspectRatio(), projectionCache) == PlacementResult::NotEnoughRoom)) {
                 hideGlyphs(placedSymbol.glyphOffsets.size(), dynamicVertexArray);
             }
         }
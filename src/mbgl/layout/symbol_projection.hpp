@@ -46,6 +46,28 @@ namespace mbgl {
     using PointAndCameraDistance = std::pair<Point<float>,float>;
     PointAndCameraDistance project(const Point<float>& point, const mat4& matrix);
 
+    // Projects `count` points on the z = 0 plane at once. The matrix is read once for all of them,
+    // and the loop doesn't branch, so that the compiler can vectorize it.
+    template <class T>
+    void projectPoints(const Point<T>* points, std::size_t count, const mat4& matrix, PointAndCameraDistance* projections) {
+        const double m0 = matrix[0], m1 = matrix[1], m3 = matrix[3];
+        const double m4 = matrix[4], m5 = matrix[5], m7 = matrix[7];
+        const double m12 = matrix[12], m13 = matrix[13], m15 = matrix[15];
+        for (std::size_t i = 0; i < count; ++i) {
+            const double x = points[i].x;
+            const double y = points[i].y;
+            const double w = m3 * x + m7 * y + m15;
+            projections[i] = {{ static_cast<float>((m0 * x + m4 * y + m12) / w),
+                                static_cast<float>((m1 * x + m5 * y + m13) / w) }, static_cast<float>(w) };
+        }
+    }
+
+    // Label plane projections of a symbol's line vertices, indexed like `PlacedSymbol::line`.
+    // Filled in batches while glyphs are placed, so that each vertex is projected at most once
+    // per symbol. Must be reset with `resetProjectionCache()` before placing another symbol.
+    using ProjectionCache = std::vector<optional<PointAndCameraDistance>>;
+    void resetProjectionCache(ProjectionCache&, const PlacedSymbol&);
+
     void reprojectLineLabels(gfx::VertexVector<gfx::Vertex<SymbolDynamicLayoutAttributes>>&, const std::vector<PlacedSymbol>&,
             const mat4& posMatrix, bool pitchWithMap, bool rotateWithMap, bool keepUpright,
             const RenderTile&, const SymbolSizeBinder& sizeBinder, const TransformState&);
@@ -58,7 +80,8 @@ namespace mbgl {
                                                             const Point<float>& tileAnchorPoint,
                                                             const PlacedSymbol& symbol,
                                                             const mat4& labelPlaneMatrix,
-                                                            const bool returnTileDistance);
+                                                            const bool returnTileDistance,
+                                                            ProjectionCache&);
 
     void hideGlyphs(std::size_t numGlyphs, gfx::VertexVector<gfx::Vertex<SymbolDynamicLayoutAttributes>>& dynamicVertices);
     void addDynamicAttributes(const Point<float>& anchorPoint,
@@ -72,7 +72,7 @@ public:
               const typename PaintProperties::PossiblyEvaluated& currentProperties,
               const TextureBindings& textureBindings,
               float currentZoom,
-              const std::string& layerID) {
+              gfx::DrawScopeID drawScopeID) {
         UniformValues uniformValues = layoutUniformValues
             .concat(paintPropertyBinders.uniformValues(currentZoom, currentProperties));
 
@@ -83,11 +83,7 @@ public:
         assert(layoutVertexBuffer.elements == dynamicVertexBuffer.elements);
 
         for (auto& segment : segments) {
-            auto drawScopeIt = segment.drawScopes.find(layerID);
-
-            if (drawScopeIt == segment.drawScopes.end()) {
-                drawScopeIt = segment.drawScopes.emplace(layerID, context.createDrawScope()).first;
-            }
+            gfx::DrawScope& drawScope = segment.getDrawScope(context, drawScopeID);
 
             program->draw(
                     context,
@@ -98,7 +94,7 @@ public:
                     std::move(colorMode),
                     std::move(cullFaceMode),
                     uniformValues,
-                    drawScopeIt->second,
+                    drawScope,
                     allAttributeBindings.offset(segment.vertexOffset),
                     textureBindings,
                     indexBuffer,
@@ -158,7 +154,7 @@ public:
               const typename PaintProperties::PossiblyEvaluated& currentProperties,
               const TextureBindings& textureBindings,
               float currentZoom,
-              const std::string& layerID) {
+              gfx::DrawScopeID drawScopeID) {
         UniformValues uniformValues = layoutUniformValues
             .concat(paintPropertyBinders.uniformValues(currentZoom, currentProperties));
 
@@ -167,11 +163,7 @@ public:
             .concat(paintPropertyBinders.attributeBindings(currentProperties));
 
         for (auto& segment : segments) {
-            auto drawScopeIt = segment.drawScopes.find(layerID);
-
-            if (drawScopeIt == segment.drawScopes.end()) {
-                drawScopeIt = segment.drawScopes.emplace(layerID, context.createDrawScope()).first;
-            }
+            gfx::DrawScope& drawScope = segment.getDrawScope(context, drawScopeID);
 
             program->draw(
                     context,
@@ -182,7 +174,7 @@ public:
                     std::move(colorMode),
                     std::move(cullFaceMode),
                     uniformValues,
-                    drawScopeIt->second,
+                    drawScope,
                     allAttributeBindings.offset(segment.vertexOffset),
                     textureBindings,
                     indexBuffer,
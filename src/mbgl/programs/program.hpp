@@ -83,7 +83,7 @@ public:
               const UniformValues& uniformValues,
               const AttributeBindings& allAttributeBindings,
               const TextureBindings& textureBindings,
-              const std::string& layerID) {
+              gfx::DrawScopeID drawScopeID) {
         static_assert(Primitive == gfx::PrimitiveTypeOf<DrawMode>::value, "incompatible draw mode");
 
         if (!program) {
@@ -91,11 +91,7 @@ public:
         }
 
         for (auto& segment : segments) {
-            auto drawScopeIt = segment.drawScopes.find(layerID);
-
-            if (drawScopeIt == segment.drawScopes.end()) {
-                drawScopeIt = segment.drawScopes.emplace(layerID, context.createDrawScope()).first;
-            }
+            gfx::DrawScope& drawScope = segment.getDrawScope(context, drawScopeID);
 
             program->draw(
                 context,
@@ -106,7 +102,7 @@ public:
                 colorMode,
                 cullFaceMode,
                 uniformValues,
-                drawScopeIt->second,
+                drawScope,
                 allAttributeBindings.offset(segment.vertexOffset),
                 textureBindings,
                 indexBuffer,
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <mbgl/gfx/draw_scope.hpp>
+#include <mbgl/gfx/index_vector.hpp>
+#include <mbgl/gfx/upload_pass.hpp>
 
 #include <cstddef>
+#include <utility>
 #include <vector>
-#include <map>
 
 namespace mbgl {
 
@@ -30,14 +32,27 @@ public:
     std::size_t vertexLength;
     std::size_t indexLength;
 
-    // One DrawScope per layer ID. This minimizes rebinding in cases where
+    // Returns the draw scope with the given ID, creating it on first use.
+    template <class Context>
+    gfx::DrawScope& getDrawScope(Context& context, gfx::DrawScopeID id) const {
+        for (auto& drawScope : drawScopes) {
+            if (drawScope.first == id) {
+                return drawScope.second;
+            }
+        }
+        drawScopes.emplace_back(id, context.createDrawScope());
+        return drawScopes.back().second;
+    }
+
+    // One DrawScope per layer. This minimizes rebinding in cases where
     // several layers share buckets but have different sets of active attributes.
     // This can happen:
     //   * when two layers have the same layout properties, but differing
     //     data-driven paint properties
     //   * when two fill layers have the same layout properties, but one
     //     uses fill-color and the other uses fill-pattern
-    mutable std::map<std::string, gfx::DrawScope> drawScopes;
+    // A segment is drawn by a handful of layers at most, so a linear search is cheaper than hashing.
+    mutable std::vector<std::pair<gfx::DrawScopeID, gfx::DrawScope>> drawScopes;
 
     float sortKey;
 };
@@ -45,4 +60,42 @@ public:
 template <class AttributeList>
 using SegmentVector = std::vector<Segment<AttributeList>>;
 
+// Buckets start a new segment whenever its vertices would no longer be addressable with 16-bit
+// indices. Joins consecutive segments with the same sort key into one, rebasing their indices onto
+// the first segment's vertices, so that each group can be drawn with a single call.
+template <class AttributeList, class DrawMode>
+gfx::IndexVector<DrawMode, uint32_t> mergeSegments(SegmentVector<AttributeList>& segments,
+                                                   const gfx::IndexVector<DrawMode>& indices) {
+    gfx::IndexVector<DrawMode, uint32_t> result;
+    SegmentVector<AttributeList> merged;
+
+    for (const auto& segment : segments) {
+        if (merged.empty() || merged.back().sortKey != segment.sortKey ||
+            segment.vertexOffset < merged.back().vertexOffset) {
+            merged.emplace_back(segment.vertexOffset, result.elements(), 0, 0, segment.sortKey);
+        }
+
+        auto& target = merged.back();
+        result.append(indices, segment.indexOffset, segment.indexLength, segment.vertexOffset - target.vertexOffset);
+        target.vertexLength = segment.vertexOffset + segment.vertexLength - target.vertexOffset;
+        target.indexLength += segment.indexLength;
+    }
+
+    segments = std::move(merged);
+    return result;
+}
+
+// Uploads the indices of a bucket's segments, merging the segments first when the context can draw
+// from 32-bit index buffers.
+template <class AttributeList, class DrawMode>
+gfx::IndexBuffer uploadSegmentIndices(gfx::UploadPass& uploadPass,
+                                      gfx::IndexVector<DrawMode>&& indices,
+                                      SegmentVector<AttributeList>& segments) {
+    if (segments.size() > 1 && uploadPass.supportsUInt32Indices()) {
+        const gfx::IndexVector<DrawMode> unmerged = std::move(indices);
+        return uploadPass.createIndexBuffer(mergeSegments(segments, unmerged));
+    }
+    return uploadPass.createIndexBuffer(std::move(indices));
+}
+
 } // namespace mbgl
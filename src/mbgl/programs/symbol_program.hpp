@@ -311,17 +311,14 @@ public:
               const UniformValues& uniformValues,
               const AttributeBindings& allAttributeBindings,
               const TextureBindings& textureBindings,
-              const std::string& layerID) {
+              gfx::DrawScopeID drawScopeID) {
         static_assert(Primitive == gfx::PrimitiveTypeOf<DrawMode>::value, "incompatible draw mode");
 
         if (!program) {
             return;
         }
 
-        auto drawScopeIt = segment.drawScopes.find(layerID);
-        if (drawScopeIt == segment.drawScopes.end()) {
-            drawScopeIt = segment.drawScopes.emplace(layerID, context.createDrawScope()).first;
-        }
+        gfx::DrawScope& drawScope = segment.getDrawScope(context, drawScopeID);
 
         program->draw(
             context,
@@ -332,7 +329,7 @@ public:
             colorMode,
             cullFaceMode,
             uniformValues,
-            drawScopeIt->second,
+            drawScope,
             allAttributeBindings.offset(segment.vertexOffset),
             textureBindings,
             indexBuffer,
@@ -353,7 +350,7 @@ public:
               const UniformValues& uniformValues,
               const AttributeBindings& allAttributeBindings,
               const TextureBindings& textureBindings,
-              const std::string& layerID) {
+              gfx::DrawScopeID drawScopeID) {
         static_assert(Primitive == gfx::PrimitiveTypeOf<DrawMode>::value, "incompatible draw mode");
 
         if (!program) {
@@ -373,7 +370,7 @@ public:
                  uniformValues,
                  allAttributeBindings,
                  textureBindings,
-                 layerID);
+                 drawScopeID);
         }
     }
 };
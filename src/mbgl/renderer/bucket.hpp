@@ -3,6 +3,7 @@
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/style/image_impl.hpp>
 #include <mbgl/renderer/image_atlas.hpp>
+#include <mbgl/renderer/paint_property_binder.hpp>
 #include <mbgl/style/layer_impl.hpp>
 #include <atomic>
 
@@ -22,6 +23,14 @@ class TransformState;
 class BucketPlacementParameters;
 class RenderTile;
 
+// A feature added to a bucket, along with its geometries and the patterns it uses in each of the
+// bucket's layers.
+struct BucketFeature {
+    const GeometryTileFeature& feature;
+    const GeometryCollection& geometries;
+    const PatternLayerMap& patterns;
+};
+
 class Bucket {
 public:
     Bucket(const Bucket&) = delete;
@@ -37,6 +46,14 @@ public:
                             const ImagePositions&,
                             const PatternLayerMap&) {};
 
+    // Adds all of the features at once. Buckets with data-driven paint properties override this to
+    // evaluate the properties for all of the features together rather than feature by feature.
+    virtual void addFeatures(const std::vector<BucketFeature>& features, const ImagePositions& patternPositions) {
+        for (const auto& feature : features) {
+            addFeature(feature.feature, feature.geometries, patternPositions, feature.patterns);
+        }
+    }
+
     // As long as this bucket has a Prepare render pass, this function is getting called. Typically,
     // this only happens once when the bucket is being rendered for the first time.
     virtual void upload(gfx::UploadPass&) = 0;
@@ -65,6 +82,28 @@ public:
 
 protected:
     Bucket() = default;
+
+    // Shared by the addFeatures() overrides: adds the geometries of the features one by one with
+    // `addGeometry`, then evaluates the data-driven paint properties of all of them at once. The
+    // length of `vertices` after each feature tells where the paint attributes of the next one start.
+    template <class Vertices, class Binders, class AddGeometry>
+    static void addFeatureBatch(const std::vector<BucketFeature>& features,
+                                const ImagePositions& patternPositions,
+                                const Vertices& vertices,
+                                Binders& paintPropertyBinders,
+                                AddGeometry&& addGeometry) {
+        FeatureBatch batch;
+        batch.reserve(features.size());
+        for (const auto& feature : features) {
+            addGeometry(feature);
+            batch.add(feature.feature, vertices.elements(), feature.patterns);
+        }
+
+        for (auto& pair : paintPropertyBinders) {
+            pair.second.populateVertexVectors(batch, patternPositions, pair.first);
+        }
+    }
+
     std::atomic<bool> uploaded { false };
 };
 
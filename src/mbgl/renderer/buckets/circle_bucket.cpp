@@ -26,7 +26,7 @@ CircleBucket::~CircleBucket() = default;
 
 void CircleBucket::upload(gfx::UploadPass& uploadPass) {
     vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
-    indexBuffer = uploadPass.createIndexBuffer(std::move(triangles));
+    indexBuffer = uploadSegmentIndices(uploadPass, std::move(triangles), segments);
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(uploadPass);
@@ -43,6 +43,19 @@ void CircleBucket::addFeature(const GeometryTileFeature& feature,
                                  const GeometryCollection& geometry,
                                  const ImagePositions&,
                                  const PatternLayerMap&) {
+    addFeatureGeometry(geometry);
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(feature, vertices.elements(), {}, {});
+    }
+}
+
+void CircleBucket::addFeatures(const std::vector<BucketFeature>& features, const ImagePositions& patternPositions) {
+    addFeatureBatch(features, patternPositions, vertices, paintPropertyBinders,
+                    [&](const BucketFeature& feature) { addFeatureGeometry(feature.geometries); });
+}
+
+void CircleBucket::addFeatureGeometry(const GeometryCollection& geometry) {
     constexpr const uint16_t vertexLength = 4;
 
     for (auto& circle : geometry) {
@@ -88,10 +101,6 @@ void CircleBucket::addFeature(const GeometryTileFeature& feature,
             segment.indexLength += 6;
         }
     }
-
-    for (auto& pair : paintPropertyBinders) {
-        pair.second.populateVertexVectors(feature, vertices.elements(), {}, {});
-    }
 }
 
 template <class Property>
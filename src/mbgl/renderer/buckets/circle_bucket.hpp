@@ -22,6 +22,7 @@ public:
                     const GeometryCollection&,
                     const ImagePositions&,
                     const PatternLayerMap&) override;
+    void addFeatures(const std::vector<BucketFeature>&, const ImagePositions&) override;
 
     bool hasData() const override;
 
@@ -39,6 +40,9 @@ public:
     std::map<std::string, CircleProgram::Binders> paintPropertyBinders;
 
     const MapMode mode;
+
+private:
+    void addFeatureGeometry(const GeometryCollection&);
 };
 
 } // namespace mbgl
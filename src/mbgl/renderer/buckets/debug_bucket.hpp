@@ -42,7 +42,6 @@ public:
     SegmentVector<DebugAttributes> segments;
     optional<gfx::VertexBuffer<DebugLayoutVertex>> vertexBuffer;
     optional<gfx::IndexBuffer> indexBuffer;
-    const std::string drawScopeID;
 };
 
 } // namespace mbgl
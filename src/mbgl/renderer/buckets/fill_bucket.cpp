@@ -48,6 +48,24 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
                             const GeometryCollection& geometry,
                             const ImagePositions& patternPositions,
                             const PatternLayerMap& patternDependencies) {
+    addFeatureGeometry(geometry);
+
+    for (auto& pair : paintPropertyBinders) {
+        const auto it = patternDependencies.find(pair.first);
+        if (it != patternDependencies.end()){
+            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, it->second);
+        } else {
+            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, {});
+        }
+    }
+}
+
+void FillBucket::addFeatures(const std::vector<BucketFeature>& features, const ImagePositions& patternPositions) {
+    addFeatureBatch(features, patternPositions, vertices, paintPropertyBinders,
+                    [&](const BucketFeature& feature) { addFeatureGeometry(feature.geometries); });
+}
+
+void FillBucket::addFeatureGeometry(const GeometryCollection& geometry) {
     for (auto& polygon : classifyRings(geometry)) {
         // Optimize polygons with many interior rings for earcut tesselation.
         limitHoles(polygon, 500);
@@ -110,21 +128,12 @@ void FillBucket::addFeature(const GeometryTileFeature& feature,
         triangleSegment.vertexLength += totalVertices;
         triangleSegment.indexLength += nIndicies;
     }
-
-    for (auto& pair : paintPropertyBinders) {
-        const auto it = patternDependencies.find(pair.first);
-        if (it != patternDependencies.end()){
-            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, it->second);
-        } else {
-            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, {});
-        }
-    }
 }
 
 void FillBucket::upload(gfx::UploadPass& uploadPass) {
     vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
-    lineIndexBuffer = uploadPass.createIndexBuffer(std::move(lines));
-    triangleIndexBuffer = triangles.empty() ? optional<gfx::IndexBuffer> {} : uploadPass.createIndexBuffer(std::move(triangles));
+    lineIndexBuffer = uploadSegmentIndices(uploadPass, std::move(lines), lineSegments);
+    triangleIndexBuffer = triangles.empty() ? optional<gfx::IndexBuffer> {} : uploadSegmentIndices(uploadPass, std::move(triangles), triangleSegments);
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(uploadPass);
@@ -30,6 +30,7 @@ public:
                     const GeometryCollection&,
                     const mbgl::ImagePositions&,
                     const PatternLayerMap&) override;
+    void addFeatures(const std::vector<BucketFeature>&, const ImagePositions&) override;
 
     bool hasData() const override;
 
@@ -48,6 +49,9 @@ public:
     optional<gfx::IndexBuffer> triangleIndexBuffer;
 
     std::map<std::string, FillProgram::Binders> paintPropertyBinders;
+
+private:
+    void addFeatureGeometry(const GeometryCollection&);
 };
 
 } // namespace mbgl
@@ -54,6 +54,24 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
                                      const GeometryCollection& geometry,
                                      const ImagePositions& patternPositions,
                                      const PatternLayerMap& patternDependencies) {
+    addFeatureGeometry(geometry);
+
+    for (auto& pair : paintPropertyBinders) {
+        const auto it = patternDependencies.find(pair.first);
+        if (it != patternDependencies.end()){
+            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, it->second);
+        } else {
+            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, {});
+        }
+    }
+}
+
+void FillExtrusionBucket::addFeatures(const std::vector<BucketFeature>& features, const ImagePositions& patternPositions) {
+    addFeatureBatch(features, patternPositions, vertices, paintPropertyBinders,
+                    [&](const BucketFeature& feature) { addFeatureGeometry(feature.geometries); });
+}
+
+void FillExtrusionBucket::addFeatureGeometry(const GeometryCollection& geometry) {
     for (auto& polygon : classifyRings(geometry)) {
         // Optimize polygons with many interior rings for earcut tesselation.
         limitHoles(polygon, 500);
@@ -154,20 +172,11 @@ void FillExtrusionBucket::addFeature(const GeometryTileFeature& feature,
         triangleSegment.vertexLength += totalVertices;
         triangleSegment.indexLength += nIndices;
     }
-
-    for (auto& pair : paintPropertyBinders) {
-        const auto it = patternDependencies.find(pair.first);
-        if (it != patternDependencies.end()){
-            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, it->second);
-        } else {
-            pair.second.populateVertexVectors(feature, vertices.elements(), patternPositions, {});
-        }
-    }
 }
 
 void FillExtrusionBucket::upload(gfx::UploadPass& uploadPass) {
     vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
-    indexBuffer = uploadPass.createIndexBuffer(std::move(triangles));
+    indexBuffer = uploadSegmentIndices(uploadPass, std::move(triangles), triangleSegments);
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(uploadPass);
@@ -28,6 +28,7 @@ public:
                     const GeometryCollection&,
                     const mbgl::ImagePositions&,
                     const PatternLayerMap&) override;
+    void addFeatures(const std::vector<BucketFeature>&, const ImagePositions&) override;
 
     bool hasData() const override;
 
@@ -43,6 +44,9 @@ public:
     optional<gfx::IndexBuffer> indexBuffer;
     
     std::unordered_map<std::string, FillExtrusionProgram::Binders> paintPropertyBinders;
+
+private:
+    void addFeatureGeometry(const GeometryCollection&);
 };
 
 } // namespace mbgl
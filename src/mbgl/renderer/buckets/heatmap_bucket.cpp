@@ -43,6 +43,19 @@ void HeatmapBucket::addFeature(const GeometryTileFeature& feature,
                                const GeometryCollection& geometry,
                                const ImagePositions&,
                                const PatternLayerMap&) {
+    addFeatureGeometry(geometry);
+
+    for (auto& pair : paintPropertyBinders) {
+        pair.second.populateVertexVectors(feature, vertices.elements(), {}, {});
+    }
+}
+
+void HeatmapBucket::addFeatures(const std::vector<BucketFeature>& features, const ImagePositions& patternPositions) {
+    addFeatureBatch(features, patternPositions, vertices, paintPropertyBinders,
+                    [&](const BucketFeature& feature) { addFeatureGeometry(feature.geometries); });
+}
+
+void HeatmapBucket::addFeatureGeometry(const GeometryCollection& geometry) {
     constexpr const uint16_t vertexLength = 4;
 
     for (auto& points : geometry) {
@@ -87,10 +100,6 @@ void HeatmapBucket::addFeature(const GeometryTileFeature& feature,
             segment.indexLength += 6;
         }
     }
-
-    for (auto& pair : paintPropertyBinders) {
-        pair.second.populateVertexVectors(feature, vertices.elements(), {}, {});
-    }
 }
 
 float HeatmapBucket::getQueryRadius(const RenderLayer& layer) const {
@@ -22,6 +22,7 @@ public:
                             const GeometryCollection&,
                             const ImagePositions&,
                             const PatternLayerMap&) override;
+    void addFeatures(const std::vector<BucketFeature>&, const ImagePositions&) override;
     bool hasData() const override;
 
     void upload(gfx::UploadPass&) override;
@@ -38,6 +39,9 @@ public:
     std::map<std::string, HeatmapProgram::Binders> paintPropertyBinders;
 
     const MapMode mode;
+
+private:
+    void addFeatureGeometry(const GeometryCollection&);
 };
 
 } // namespace mbgl
@@ -34,9 +34,7 @@ void LineBucket::addFeature(const GeometryTileFeature& feature,
                             const GeometryCollection& geometryCollection,
                             const ImagePositions& patternPositions,
                             const PatternLayerMap& patternDependencies) {
-    for (auto& line : geometryCollection) {
-        addGeometry(line, feature);
-    }
+    addFeatureGeometry(feature, geometryCollection);
 
     for (auto& pair : paintPropertyBinders) {
         const auto it = patternDependencies.find(pair.first);
@@ -48,6 +46,17 @@ void LineBucket::addFeature(const GeometryTileFeature& feature,
     }
 }
 
+void LineBucket::addFeatures(const std::vector<BucketFeature>& features, const ImagePositions& patternPositions) {
+    addFeatureBatch(features, patternPositions, vertices, paintPropertyBinders,
+                    [&](const BucketFeature& feature) { addFeatureGeometry(feature.feature, feature.geometries); });
+}
+
+void LineBucket::addFeatureGeometry(const GeometryTileFeature& feature, const GeometryCollection& geometryCollection) {
+    for (auto& line : geometryCollection) {
+        addGeometry(line, feature);
+    }
+}
+
 
 /*
  * Sharp corners cause dashed lines to tilt because the distance along the line
@@ -510,7 +519,7 @@ void LineBucket::addPieSliceVertex(const GeometryCoordinate& currentVertex,
 
 void LineBucket::upload(gfx::UploadPass& uploadPass) {
     vertexBuffer = uploadPass.createVertexBuffer(std::move(vertices));
-    indexBuffer = uploadPass.createIndexBuffer(std::move(triangles));
+    indexBuffer = uploadSegmentIndices(uploadPass, std::move(triangles), segments);
 
     for (auto& pair : paintPropertyBinders) {
         pair.second.upload(uploadPass);
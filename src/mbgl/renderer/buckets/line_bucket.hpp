@@ -30,6 +30,7 @@ public:
                     const GeometryCollection&,
                     const mbgl::ImagePositions& patternPositions,
                     const PatternLayerMap&) override;
+    void addFeatures(const std::vector<BucketFeature>&, const ImagePositions&) override;
 
     bool hasData() const override;
 
@@ -49,6 +50,7 @@ public:
     std::map<std::string, LineProgram::Binders> paintPropertyBinders;
 
 private:
+    void addFeatureGeometry(const GeometryTileFeature&, const GeometryCollection&);
     void addGeometry(const GeometryCoordinates&, const GeometryTileFeature&);
 
     struct TriangleElement {
@@ -114,7 +114,7 @@ void RenderCircleLayer::render(PaintParameters& parameters) {
             allUniformValues,
             allAttributeBindings,
             CircleProgram::TextureBindings{},
-            getID()
+            drawScopeID
         );
     }
 }
@@ -20,6 +20,14 @@ namespace mbgl {
 
 using namespace style;
 
+namespace {
+
+// Extrusions are drawn in a depth pass and a color pass, each with a draw scope of its own.
+// Their values are offsets from the layer's first draw scope ID.
+enum class FillExtrusionDrawPass : uint8_t { Depth, Color };
+
+} // namespace
+
 inline const FillExtrusionLayer::Impl& impl(const Immutable<style::Layer::Impl>& impl) {
     return static_cast<const FillExtrusionLayer::Impl&>(*impl);
 }
@@ -84,7 +92,7 @@ void RenderFillExtrusionLayer::render(PaintParameters& parameters) {
                     const optional<ImagePosition>& patternPositionA,
                     const optional<ImagePosition>& patternPositionB,
                     const auto& textureBindings,
-                    const std::string& uniqueName) {
+                    FillExtrusionDrawPass pass) {
         const auto& paintPropertyBinders = tileBucket.paintPropertyBinders.at(getID());
         paintPropertyBinders.setPatternParameters(patternPositionA, patternPositionB, crossfade_);
 
@@ -115,12 +123,12 @@ void RenderFillExtrusionLayer::render(PaintParameters& parameters) {
             allUniformValues,
             allAttributeBindings,
             textureBindings,
-            getID() + "/" + uniqueName);
+            drawScopeID + static_cast<uint8_t>(pass));
     };
 
     if (unevaluated.get<FillExtrusionPattern>().isUndefined()) {
         // Draw solid color extrusions
-        auto drawTiles = [&](const gfx::StencilMode& stencilMode_, const gfx::ColorMode& colorMode_, const std::string& name) {
+        auto drawTiles = [&](const gfx::StencilMode& stencilMode_, const gfx::ColorMode& colorMode_, FillExtrusionDrawPass pass) {
             for (const RenderTile& tile : *renderTiles) {
                 const LayerRenderData* renderData = getRenderDataForPass(tile, parameters.pass);
                 if (!renderData) {
@@ -146,28 +154,28 @@ void RenderFillExtrusionLayer::render(PaintParameters& parameters) {
                     {},
                     {},
                     FillExtrusionProgram::TextureBindings{},
-                    name
+                    pass
                 );
             }
         };
 
         if (evaluated.get<FillExtrusionOpacity>() == 1) {
             // Draw opaque extrusions
-            drawTiles(gfx::StencilMode::disabled(), parameters.colorModeForRenderPass(), "color");
+            drawTiles(gfx::StencilMode::disabled(), parameters.colorModeForRenderPass(), FillExtrusionDrawPass::Color);
         } else {
             // Draw transparent buildings in two passes so that only the closest surface is drawn.
             // First draw all the extrusions into only the depth buffer. No colors are drawn.
-            drawTiles(gfx::StencilMode::disabled(), gfx::ColorMode::disabled(), "depth");
+            drawTiles(gfx::StencilMode::disabled(), gfx::ColorMode::disabled(), FillExtrusionDrawPass::Depth);
 
             // Then draw all the extrusions a second time, only coloring fragments if they have the
             // same depth value as the closest fragment in the previous pass. Use the stencil buffer
             // to prevent the second draw in cases where we have coincident polygons.
-            drawTiles(parameters.stencilModeFor3D(), parameters.colorModeForRenderPass(), "color");
+            drawTiles(parameters.stencilModeFor3D(), parameters.colorModeForRenderPass(), FillExtrusionDrawPass::Color);
         }
     } else {
         // Draw textured extrusions
         const auto fillPatternValue = evaluated.get<FillExtrusionPattern>().constantOr(mbgl::Faded<std::basic_string<char> >{"", ""});
-        auto drawTiles = [&](const gfx::StencilMode& stencilMode_, const gfx::ColorMode& colorMode_, const std::string& name) {
+        auto drawTiles = [&](const gfx::StencilMode& stencilMode_, const gfx::ColorMode& colorMode_, FillExtrusionDrawPass pass) {
             for (const RenderTile& tile : *renderTiles) {
                 const LayerRenderData* renderData = getRenderDataForPass(tile, parameters.pass);
                 if (!renderData) {
@@ -203,19 +211,19 @@ void RenderFillExtrusionLayer::render(PaintParameters& parameters) {
                     FillExtrusionPatternProgram::TextureBindings{
                         textures::image::Value{ tile.getIconAtlasTexture().getResource(), gfx::TextureFilterType::Linear },
                     },
-                    name
+                    pass
                 );
             }
         };
 
         // Draw transparent buildings in two passes so that only the closest surface is drawn.
         // First draw all the extrusions into only the depth buffer. No colors are drawn.
-        drawTiles(gfx::StencilMode::disabled(), gfx::ColorMode::disabled(), "depth");
+        drawTiles(gfx::StencilMode::disabled(), gfx::ColorMode::disabled(), FillExtrusionDrawPass::Depth);
 
         // Then draw all the extrusions a second time, only coloring fragments if they have the
         // same depth value as the closest fragment in the previous pass. Use the stencil buffer
         // to prevent the second draw in cases where we have coincident polygons.
-        drawTiles(parameters.stencilModeFor3D(), parameters.colorModeForRenderPass(), "color");
+        drawTiles(parameters.stencilModeFor3D(), parameters.colorModeForRenderPass(), FillExtrusionDrawPass::Color);
     }
 }
 
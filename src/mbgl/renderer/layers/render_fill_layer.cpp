@@ -126,7 +126,7 @@ void RenderFillLayer::render(PaintParameters& parameters) {
                     allUniformValues,
                     allAttributeBindings,
                     std::move(textureBindings),
-                    getID()
+                    drawScopeID
                 );
             };
 
@@ -221,7 +221,7 @@ void RenderFillLayer::render(PaintParameters& parameters) {
                     allUniformValues,
                     allAttributeBindings,
                     std::move(textureBindings),
-                    getID()
+                    drawScopeID
                 );
             };
 
@@ -139,7 +139,7 @@ void RenderHeatmapLayer::render(PaintParameters& parameters) {
                 allUniformValues,
                 allAttributeBindings,
                 HeatmapProgram::TextureBindings{},
-                getID()
+                drawScopeID
             );
         }
 
@@ -188,7 +188,7 @@ void RenderHeatmapLayer::render(PaintParameters& parameters) {
                 textures::image::Value{ renderTexture->getTexture().getResource(), gfx::TextureFilterType::Linear },
                 textures::color_ramp::Value{ colorRampTexture->getResource(), gfx::TextureFilterType::Linear },
             },
-            getID()
+            drawScopeID
         );
     }
 }
@@ -119,7 +119,7 @@ void RenderHillshadeLayer::render(PaintParameters& parameters) {
             allUniformValues,
             allAttributeBindings,
             textureBindings,
-            getID() + "/" + util::toString(id)
+            drawScopeID
         );
     };
 
@@ -186,7 +186,8 @@ void RenderHillshadeLayer::render(PaintParameters& parameters) {
                 HillshadePrepareProgram::TextureBindings{
                     textures::image::Value{ bucket.dem->getResource() },
                 },
-                getID() + "/p/" + util::toString(tile.id)
+                // The prepare pass draws with another program, and keeps a draw scope of its own.
+                drawScopeID + 1
             );
             bucket.texture = std::move(view->getTexture());
             bucket.setPrepared(true);
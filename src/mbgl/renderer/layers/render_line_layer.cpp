@@ -136,7 +136,7 @@ void RenderLineLayer::render(PaintParameters& parameters) {
                 allUniformValues,
                 allAttributeBindings,
                 std::move(textureBindings),
-                getID()
+                drawScopeID
             );
         };
 
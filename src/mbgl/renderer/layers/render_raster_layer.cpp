@@ -90,8 +90,7 @@ void RenderRasterLayer::render(PaintParameters& parameters) {
                      const auto& vertexBuffer,
                      const auto& indexBuffer,
                      const auto& segments,
-                     const auto& textureBindings,
-                     const std::string& drawScopeID) {
+                     const auto& textureBindings) {
         auto& programInstance = parameters.programs.getRasterLayerPrograms().raster;
 
         const auto allUniformValues = programInstance.computeAllUniformValues(
@@ -133,7 +132,7 @@ void RenderRasterLayer::render(PaintParameters& parameters) {
             allUniformValues,
             allAttributeBindings,
             textureBindings,
-            getID() + "/" + drawScopeID
+            drawScopeID
         );
     };
 
@@ -143,7 +142,6 @@ void RenderRasterLayer::render(PaintParameters& parameters) {
         RasterBucket& bucket = *imageData->bucket;
         assert(bucket.texture);
 
-        size_t i = 0;
         for (const auto& matrix_ : imageData->matrices) {
             draw(matrix_,
                 *bucket.vertexBuffer,
@@ -152,8 +150,7 @@ void RenderRasterLayer::render(PaintParameters& parameters) {
                 RasterProgram::TextureBindings{
                     textures::image0::Value{ bucket.texture->getResource(), filter },
                     textures::image1::Value{ bucket.texture->getResource(), filter },
-                },
-                bucket.drawScopeID + std::to_string(i++));
+                });
         }
     } else if (renderTiles) {
         for (const RenderTile& tile : *renderTiles) {
@@ -176,8 +173,7 @@ void RenderRasterLayer::render(PaintParameters& parameters) {
                      RasterProgram::TextureBindings{
                          textures::image0::Value{ bucket.texture->getResource(), filter },
                          textures::image1::Value{ bucket.texture->getResource(), filter },
-                     },
-                     bucket.drawScopeID);
+                     });
             } else {
                 // Draw the full tile.
                 draw(parameters.matrixForTile(tile.id, true),
@@ -187,8 +183,7 @@ void RenderRasterLayer::render(PaintParameters& parameters) {
                      RasterProgram::TextureBindings{
                          textures::image0::Value{ bucket.texture->getResource(), filter },
                          textures::image1::Value{ bucket.texture->getResource(), filter },
-                     },
-                     bucket.drawScopeID);
+                     });
             }
         }
     }
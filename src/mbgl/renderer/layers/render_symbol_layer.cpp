@@ -28,6 +28,11 @@ namespace mbgl {
 using namespace style;
 namespace {
 
+// The halo and fill passes draw the same segments with different programs and attribute sets, so
+// each of them gets a draw scope of its own. Their values are offsets from the layer's first draw
+// scope ID.
+enum class SymbolDrawPass : uint8_t { Halo, Fill, Icon };
+
 style::SymbolPropertyValues iconPropertyValues(const style::SymbolPaintProperties::PossiblyEvaluated& evaluated_,
                                                const style::SymbolLayoutProperties::PossiblyEvaluated& layout_) {
     return style::SymbolPropertyValues {
@@ -144,7 +149,7 @@ void drawIcon(const DrawFn& draw,
                 SymbolSDFIconProgram::TextureBindings{
                     textureBinding
                 },
-                "halo");
+                SymbolDrawPass::Halo);
         }
 
         if (values.hasFill) {
@@ -158,7 +163,7 @@ void drawIcon(const DrawFn& draw,
                 SymbolSDFIconProgram::TextureBindings{
                     textureBinding
                 },
-                "fill");
+                SymbolDrawPass::Fill);
         }
     } else {
         draw(parameters.programs.getSymbolLayerPrograms().symbolIcon,
@@ -171,7 +176,7 @@ void drawIcon(const DrawFn& draw,
             SymbolIconProgram::TextureBindings{
                 textureBinding
             },
-            "icon");
+            SymbolDrawPass::Icon);
     }
 }
 
@@ -208,7 +213,7 @@ void drawText(const DrawFn& draw,
             SymbolSDFTextProgram::TextureBindings{
                 textureBinding
             },
-            "halo");
+            SymbolDrawPass::Halo);
     }
 
     if (values.hasFill) {
@@ -222,7 +227,7 @@ void drawText(const DrawFn& draw,
             SymbolSDFTextProgram::TextureBindings{
                 textureBinding
             },
-            "fill");
+            SymbolDrawPass::Fill);
     }
 }
 
@@ -292,7 +297,9 @@ void RenderSymbolLayer::render(PaintParameters& parameters) {
                                            const auto& binders,
                                            const auto& paintProperties,
                                            const auto& textureBindings,
-                                           const std::string& suffix) {
+                                           SymbolDrawPass pass) {
+        const gfx::DrawScopeID passDrawScopeID = this->drawScopeID + static_cast<uint8_t>(pass);
+
         const auto allUniformValues = programInstance.computeAllUniformValues(
             uniformValues,
             *symbolSizeBinder,
@@ -326,7 +333,7 @@ void RenderSymbolLayer::render(PaintParameters& parameters) {
                     allUniformValues,
                     allAttributeBindings,
                     textureBindings,
-                    this->getID() + "/" + suffix
+                    passDrawScopeID
                 );
             },
             [&](const std::reference_wrapper<SegmentVector<SymbolTextAttributes>>& segmentVector) {
@@ -343,7 +350,7 @@ void RenderSymbolLayer::render(PaintParameters& parameters) {
                     allUniformValues,
                     allAttributeBindings,
                     textureBindings,
-                    this->getID() + "/" + suffix
+                    passDrawScopeID
                 );
             }
         );
@@ -413,7 +420,7 @@ void RenderSymbolLayer::render(PaintParameters& parameters) {
                 properties,
                 CollisionBoxProgram::TextureBindings{},
                 parameters.state.getZoom(),
-                getID()
+                drawScopeID
             );
         }
 
@@ -451,7 +458,7 @@ void RenderSymbolLayer::render(PaintParameters& parameters) {
                 properties,
                 CollisionCircleProgram::TextureBindings{},
                 parameters.state.getZoom(),
-                getID()
+                drawScopeID
             );
         }
     }
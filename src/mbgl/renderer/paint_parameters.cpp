@@ -160,7 +160,7 @@ void PaintParameters::renderTileClippingMasks(const RenderTiles& renderTiles) {
                 properties
             ),
             ClippingMaskProgram::TextureBindings{},
-            "clipping/" + util::toString(stencilID)
+            gfx::ClippingDrawScope
         );
     }
 }
@@ -66,6 +66,56 @@ std::array<float, N*2> zoomInterpolatedAttributeValue(const std::array<float, N>
     return result;
 }
 
+/*
+   FeatureBatch holds the features added to a bucket at once as columns, so that data-driven
+   paint properties can be evaluated for all of them together instead of feature by feature.
+*/
+class FeatureBatch {
+public:
+    void reserve(std::size_t size) {
+        features.reserve(size);
+        lengths.reserve(size);
+        featurePatterns.reserve(size);
+    }
+
+    // The length is the number of vertices the bucket holds once the feature has been added.
+    void add(const GeometryTileFeature& feature, std::size_t length, const PatternLayerMap& patterns) {
+        features.push_back(&feature);
+        lengths.push_back(length);
+        featurePatterns.push_back(&patterns);
+        hasPatterns = hasPatterns || !patterns.empty();
+    }
+
+    std::size_t size() const {
+        return features.size();
+    }
+
+    bool empty() const {
+        return features.empty();
+    }
+
+    // The patterns each of the features uses in the given layer, or an empty vector if none of the
+    // features uses any pattern.
+    std::vector<optional<PatternDependency>> patternDependencies(const std::string& layerID) const {
+        std::vector<optional<PatternDependency>> result;
+        if (hasPatterns) {
+            result.reserve(featurePatterns.size());
+            for (const PatternLayerMap* patterns : featurePatterns) {
+                const auto it = patterns->find(layerID);
+                result.push_back(it != patterns->end() ? optional<PatternDependency>(it->second) : nullopt);
+            }
+        }
+        return result;
+    }
+
+    std::vector<const GeometryTileFeature*> features;
+    std::vector<std::size_t> lengths;
+
+private:
+    std::vector<const PatternLayerMap*> featurePatterns;
+    bool hasPatterns = false;
+};
+
 /*
    PaintPropertyBinder is an abstract class serving as the interface definition for
    the strategy used for constructing, uploading, and binding paint property data as
@@ -100,6 +150,15 @@ public:
                                       std::size_t length, const ImagePositions&,
                                       const optional<PatternDependency>&,
                                       const style::expression::Value&) = 0;
+    // Same as populating the vertex vector for each of the features in turn. The pattern
+    // dependencies are either empty or hold the patterns of each of the features.
+    virtual void populateVertexVectors(const FeatureBatch& batch, const ImagePositions& patternPositions,
+                                       const std::vector<optional<PatternDependency>>& patternDependencies) {
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            populateVertexVector(*batch.features[i], batch.lengths[i], patternPositions,
+                                 patternDependencies.empty() ? optional<PatternDependency>() : patternDependencies[i], {});
+        }
+    }
     virtual void upload(gfx::UploadPass&) = 0;
     virtual void setPatternParameters(const optional<ImagePosition>&, const optional<ImagePosition>&, const CrossfadeParameters&) = 0;
     virtual std::tuple<ExpandToType<As, optional<gfx::AttributeBinding>>...> attributeBinding(const PossiblyEvaluatedType& currentValue) const = 0;
@@ -119,6 +178,7 @@ public:
     }
 
     void populateVertexVector(const GeometryTileFeature&, std::size_t, const ImagePositions&, const optional<PatternDependency>&, const style::expression::Value&) override {}
+    void populateVertexVectors(const FeatureBatch&, const ImagePositions&, const std::vector<optional<PatternDependency>>&) override {}
     void upload(gfx::UploadPass&) override {}
     void setPatternParameters(const optional<ImagePosition>&, const optional<ImagePosition>&, const CrossfadeParameters&) override {};
 
@@ -146,6 +206,7 @@ public:
     }
 
     void populateVertexVector(const GeometryTileFeature&, std::size_t, const ImagePositions&, const optional<PatternDependency>&, const style::expression::Value&) override {}
+    void populateVertexVectors(const FeatureBatch&, const ImagePositions&, const std::vector<optional<PatternDependency>>&) override {}
     void upload(gfx::UploadPass&) override {}
 
     void setPatternParameters(const optional<ImagePosition>& posA, const optional<ImagePosition>& posB, const CrossfadeParameters&) override {
@@ -197,6 +258,22 @@ public:
         }
     }
 
+    void populateVertexVectors(const FeatureBatch& batch, const ImagePositions&, const std::vector<optional<PatternDependency>>&) override {
+        if (batch.empty()) {
+            return;
+        }
+        // Evaluate the property for all of the features first, then fill the vertex vector in one pass.
+        const std::vector<T> evaluated = expression.evaluate(nullopt, batch.features, defaultValue);
+        vertexVector.reserve(batch.lengths.back());
+        for (std::size_t i = 0; i < evaluated.size(); ++i) {
+            this->statistics.add(evaluated[i]);
+            auto value = attributeValue(evaluated[i]);
+            for (std::size_t j = vertexVector.elements(); j < batch.lengths[i]; ++j) {
+                vertexVector.emplace_back(BaseVertex { value });
+            }
+        }
+    }
+
     void upload(gfx::UploadPass& uploadPass) override {
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertexVector));
     }
@@ -261,6 +338,27 @@ public:
         }
     }
 
+    void populateVertexVectors(const FeatureBatch& batch, const ImagePositions&, const std::vector<optional<PatternDependency>>&) override {
+        if (batch.empty()) {
+            return;
+        }
+        // Evaluate the property for all of the features at either end of the zoom range first, then
+        // fill the vertex vector in one pass.
+        const std::vector<T> min = expression.evaluate(zoomRange.min, batch.features, defaultValue);
+        const std::vector<T> max = expression.evaluate(zoomRange.max, batch.features, defaultValue);
+        vertexVector.reserve(batch.lengths.back());
+        for (std::size_t i = 0; i < min.size(); ++i) {
+            this->statistics.add(min[i]);
+            this->statistics.add(max[i]);
+            AttributeValue value = zoomInterpolatedAttributeValue(
+                attributeValue(min[i]),
+                attributeValue(max[i]));
+            for (std::size_t j = vertexVector.elements(); j < batch.lengths[i]; ++j) {
+                vertexVector.emplace_back(Vertex { value });
+            }
+        }
+    }
+
     void upload(gfx::UploadPass& uploadPass) override {
         vertexBuffer = uploadPass.createVertexBuffer(std::move(vertexVector));
     }
@@ -497,6 +595,13 @@ public:
         });
     }
 
+    void populateVertexVectors(const FeatureBatch& batch, const ImagePositions& patternPositions, const std::string& layerID) {
+        const std::vector<optional<PatternDependency>> patternDependencies = batch.patternDependencies(layerID);
+        util::ignore({
+            (binders.template get<Ps>()->populateVertexVectors(batch, patternPositions, patternDependencies), 0)...
+        });
+    }
+
     void setPatternParameters(const optional<ImagePosition>& posA, const optional<ImagePosition>& posB, const CrossfadeParameters& crossfade) const {
         util::ignore({
             (binders.template get<Ps>()->setPatternParameters(posA, posB, crossfade), 0)...
@@ -1,4 +1,5 @@
 #pragma once
+#include <mbgl/gfx/draw_scope.hpp>
 #include <mbgl/layout/layout.hpp>
 #include <mbgl/renderer/render_pass.hpp>
 #include <mbgl/renderer/render_source.hpp>
@@ -74,6 +75,9 @@ public:
 
     const std::string& getID() const;
 
+    gfx::DrawScopeID getDrawScopeID() const { return drawScopeID; }
+    void setDrawScopeID(gfx::DrawScopeID drawScopeID_) { drawScopeID = drawScopeID_; }
+
     // Checks whether this layer needs to be rendered in the given render pass.
     bool hasRenderPass(RenderPass) const;
 
@@ -131,6 +135,9 @@ protected:
 
     std::vector<LayerPlacementData> placementData;
 
+    // First of this layer's gfx::LayerDrawScopeCount draw scope IDs, assigned by the renderer.
+    gfx::DrawScopeID drawScopeID = gfx::ReservedDrawScopeCount;
+
 private:
     // Some layers may not render correctly on some hardware when the vertex attribute limit of
     // that GPU is exceeded. More attributes are used when adding many data driven paint properties
@@ -23,6 +23,7 @@
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/tile/tile.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/math.hpp>
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/logging.hpp>
@@ -101,7 +102,7 @@ RenderOrchestrator::RenderOrchestrator(
     , sourceImpls(makeMutable<std::vector<Immutable<style::Source::Impl>>>())
     , layerImpls(makeMutable<std::vector<Immutable<style::Layer::Impl>>>())
     , renderLight(makeMutable<Light::Impl>())
-    , placement(std::make_unique<Placement>(TransformState{}, MapMode::Static, TransitionOptions{}, true))
+    , placement(std::make_shared<Placement>(TransformState{}, MapMode::Static, TransitionOptions{}, true))
     , backgroundLayerAsColor(backgroundLayerAsColor_) {
     glyphManager->setObserver(this);
     imageManager->setObserver(this);
@@ -210,12 +211,21 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(const UpdatePar
 
     // Remove render layers for removed layers.
     for (const auto& entry : layerDiff.removed) {
-        renderLayers.erase(entry.first);
+        auto it = renderLayers.find(entry.first);
+        freeDrawScopeIDs.push_back(it->second->getDrawScopeID());
+        renderLayers.erase(it);
     }
 
     // Create render layers for newly added layers.
     for (const auto& entry : layerDiff.added) {
         auto renderLayer = LayerManager::get()->createRenderLayer(entry.second);
+        if (!freeDrawScopeIDs.empty()) {
+            renderLayer->setDrawScopeID(freeDrawScopeIDs.back());
+            freeDrawScopeIDs.pop_back();
+        } else {
+            renderLayer->setDrawScopeID(nextDrawScopeID);
+            nextDrawScopeID += gfx::LayerDrawScopeCount;
+        }
         renderLayer->transition(transitionParameters);
         renderLayers.emplace(entry.first, std::move(renderLayer));
     }
@@ -362,33 +372,67 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(const UpdatePar
         }
 
         bool symbolBucketsChanged = false;
-        const bool placementChanged = !placement->stillRecent(updateParameters.timePoint);
         std::set<std::string> usedSymbolLayers;
-        if (placementChanged) {
-            placement = std::make_unique<Placement>(
-                updateParameters.transformState, updateParameters.mode,
-                updateParameters.transitionOptions, updateParameters.crossSourceCollisions,
-                std::move(placement));
-        }
-
         for (auto it = layersNeedPlacement.rbegin(); it != layersNeedPlacement.rend(); ++it) {
             const RenderLayer& layer = *it;
             if (crossTileSymbolIndex.addLayer(layer, updateParameters.transformState.getLatLng().longitude())) symbolBucketsChanged = true;
+            usedSymbolLayers.insert(layer.getID());
+        }
+
+        if (symbolBucketsChanged) {
+            symbolBucketsChangedSincePlacement = true;
+        }
 
-            if (placementChanged) {
-                usedSymbolLayers.insert(layer.getID());
-                placement->placeLayer(layer, renderTreeParameters->transformParams.projMatrix, updateParameters.debugOptions & MapDebugOptions::Collision);
+        const bool showCollisionBoxes = updateParameters.debugOptions & MapDebugOptions::Collision;
+        if (pauseablePlacement &&
+            !pauseablePlacement->canContinue(updateParameters.transitionOptions, updateParameters.crossSourceCollisions,
+                                             layersNeedPlacement, showCollisionBoxes)) {
+            // Symbol layers or placement options changed while placement was paused. Placement
+            // starts over. Camera and tile changes don't stop it: it goes on for the view it was
+            // started with, and the next placement catches up with them.
+            pauseablePlacement.reset();
+            symbolBucketsChangedSincePlacement = true;
+        }
+
+        // The committed placement is kept as long as placing symbols again would yield the same
+        // result, e.g. while the camera moves by sub-pixel amounts over the same buckets.
+        const bool placementOutdated = symbolBucketsChangedSincePlacement ||
+            !placement->canBeReused(updateParameters.transformState, updateParameters.transitionOptions,
+                                    updateParameters.crossSourceCollisions, layersNeedPlacement, showCollisionBoxes);
+
+        if (!pauseablePlacement && placementOutdated && !placement->stillRecent(updateParameters.timePoint)) {
+            pauseablePlacement = std::make_unique<PauseablePlacement>(
+                updateParameters.transformState, updateParameters.mode,
+                updateParameters.transitionOptions, updateParameters.crossSourceCollisions,
+                placement, layersNeedPlacement, renderTreeParameters->transformParams.projMatrix,
+                showCollisionBoxes);
+            symbolBucketsChangedSincePlacement = false;
+        }
+
+        bool placementChanged = false;
+        if (pauseablePlacement) {
+            // In continuous mode, the previous placement stays committed until the
+            // new one is complete, so placement may be spread over several frames.
+            optional<TimePoint> deadline;
+            if (isMapModeContinuous) {
+                deadline = Clock::now() + util::SYMBOL_PLACEMENT_TIME_BUDGET;
+            }
+            pauseablePlacement->continuePlacement(layersNeedPlacement, deadline);
+            if (pauseablePlacement->isDone()) {
+                layerPlacementTimes = pauseablePlacement->getLayerPlacementTimes();
+                placement = pauseablePlacement->commit(updateParameters.timePoint);
+                pauseablePlacement.reset();
+                placementChanged = true;
             }
         }
 
         if (placementChanged) {
-            placement->commit(updateParameters.timePoint);
             crossTileSymbolIndex.pruneUnusedLayers(usedSymbolLayers);
             for (const auto& entry : renderSources) {
                 entry.second->updateFadingTiles();
             }
         } else {
-            placement->setStale();
+            placement->setStale(placementOutdated || pauseablePlacement);
         }
 
         for (auto it = layersNeedPlacement.rbegin(); it != layersNeedPlacement.rend(); ++it) {
@@ -571,6 +615,11 @@ void RenderOrchestrator::dumpDebugLogs() {
     }
 
     imageManager->dumpDebugLogs();
+
+    for (const auto& entry : layerPlacementTimes) {
+        Log::Info(Event::Timing, "Placement of layer %s: %.3f ms", entry.first.c_str(),
+                  std::chrono::duration<double, std::milli>(entry.second).count());
+    }
 }
 
 RenderLayer* RenderOrchestrator::getRenderLayer(const std::string& id) {
@@ -599,7 +648,7 @@ bool RenderOrchestrator::hasTransitions(TimePoint timePoint) const {
         }
     }
 
-    if (placement->hasTransitions(timePoint)) {
+    if (placement->hasTransitions(timePoint) || pauseablePlacement) {
         return true;
     }
 
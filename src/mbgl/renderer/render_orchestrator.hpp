@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mbgl/gfx/draw_scope.hpp>
 #include <mbgl/renderer/renderer.hpp>
 #include <mbgl/renderer/render_source_observer.hpp>
 #include <mbgl/renderer/render_light.hpp>
@@ -13,6 +14,7 @@
 #include <mbgl/renderer/image_manager_observer.hpp>
 #include <mbgl/text/placement.hpp>
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -110,10 +112,20 @@ private:
 
     std::unordered_map<std::string, std::unique_ptr<RenderSource>> renderSources;
     std::unordered_map<std::string, std::unique_ptr<RenderLayer>> renderLayers;
+    // Draw scope IDs of removed layers, handed out again to new layers, so that segments' draw
+    // scopes stay few and dense however often layers are added and removed.
+    std::vector<gfx::DrawScopeID> freeDrawScopeIDs;
+    gfx::DrawScopeID nextDrawScopeID = gfx::ReservedDrawScopeCount;
     RenderLight renderLight;
 
     CrossTileSymbolIndex crossTileSymbolIndex;
-    std::unique_ptr<Placement> placement;
+    std::shared_ptr<Placement> placement;
+    // Placement in progress; spread over several frames in continuous mode.
+    std::unique_ptr<PauseablePlacement> pauseablePlacement;
+    // Whether symbol buckets were added or removed since the last placement was started.
+    bool symbolBucketsChangedSincePlacement = true;
+    // Per-layer placement cost of the last committed placement.
+    std::map<std::string, Duration> layerPlacementTimes;
 
     const bool backgroundLayerAsColor;
     bool contextLost = false;
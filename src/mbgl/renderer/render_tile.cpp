@@ -167,7 +167,7 @@ void RenderTile::finishRender(PaintParameters& parameters) const {
             ),
             allAttributeBindings,
             DebugProgram::TextureBindings{},
-            "__debug/" + debugBucket->drawScopeID + "/text-outline"
+            gfx::DebugTextOutlineDrawScope
         );
 
         program.draw(
@@ -191,7 +191,7 @@ void RenderTile::finishRender(PaintParameters& parameters) const {
             ),
             allAttributeBindings,
             DebugProgram::TextureBindings{},
-            "__debug/" + debugBucket->drawScopeID + "/text"
+            gfx::DebugTextDrawScope
         );
     }
 
@@ -222,7 +222,7 @@ void RenderTile::finishRender(PaintParameters& parameters) const {
                 properties
             ),
             DebugProgram::TextureBindings{},
-            "__debug/" + debugBucket->drawScopeID
+            gfx::DebugBorderDrawScope
         );
     }
 }
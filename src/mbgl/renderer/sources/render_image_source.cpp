@@ -61,7 +61,7 @@ void ImageSourceRenderData::render(PaintParameters& parameters) const {
                 properties
             ),
             DebugProgram::TextureBindings{},
-            "image"
+            gfx::ImageDrawScope
         );
     }
 }
@@ -5,6 +5,7 @@
 #include <mbgl/renderer/query.hpp>
 #include <mbgl/map/transform.hpp>
 #include <mbgl/math/clamp.hpp>
+#include <mbgl/util/tile_coordinate.hpp>
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/tile_range.hpp>
 #include <mbgl/util/enum.hpp>
@@ -119,8 +120,24 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
     // we're actively using, e.g. as a replacement for tile that aren't loaded yet.
     std::set<OverscaledTileID> retain;
 
+    // Tiles at the ideal zoom level are requested before prefetched ones, and tiles near the centre
+    // of the viewport before those near its edges. Ranks are refreshed on every update, so requests
+    // still pending after the viewport moved are reordered.
+    const TileCoordinate center = TileCoordinate::fromLatLng(0, parameters.transformState.getLatLng());
+    auto requestRankFn = [&](const OverscaledTileID& tileID) -> uint32_t {
+        const double scale = std::pow(2.0, tileID.canonical.z);
+        const TileCoordinatePoint point = center.zoomTo(tileID.canonical.z).p;
+        const double dx = tileID.canonical.x + tileID.wrap * scale + 0.5 - point.x;
+        const double dy = tileID.canonical.y + 0.5 - point.y;
+        // Distance from the center in 1/16 tile units; zoom distance weighs more than any distance.
+        const auto distance = uint32_t(std::min(std::sqrt(dx * dx + dy * dy) * 16, 1023.0));
+        return uint32_t(std::abs(int32_t(tileID.overscaledZ) - tileZoom)) * 1024 + distance;
+    };
+
     auto retainTileFn = [&](Tile& tile, TileNecessity necessity) -> void {
         if (retain.emplace(tile.id).second) {
+            // Rank first, so that a network request made for a required tile starts out ranked.
+            tile.setRequestRank(requestRankFn(tile.id));
             tile.setNecessity(necessity);
         }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/http_connection_options.hpp>
 
 namespace mbgl {
 
@@ -11,6 +12,9 @@ public:
 
     std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
 
+    // Applies to requests started after this call.
+    void setConnectionOptions(const HTTPConnectionOptions&);
+
     class Impl;
 
 private:
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+namespace util {
+template <typename T> class Thread;
+} // namespace util
+
+// Serves tiles and TileJSON read directly from an MBTiles file. A source URL of the form
+// mbtiles:///path/to/file.mbtiles resolves to a TileJSON document built from the metadata
+// table; the tile URLs it lists resolve to the tile_data of the matching row in the tiles table.
+//
+// Requests are spread over a small pool of reader threads, each of which keeps a read-only
+// connection and a prepared tile statement per file open. A non-zero mmapSize lets SQLite
+// memory-map up to that many bytes of each file instead of reading pages through its cache.
+class MBTilesFileSource : public FileSource {
+public:
+    explicit MBTilesFileSource(std::size_t readerCount = 2, uint64_t mmapSize = 0);
+    ~MBTilesFileSource() override;
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+
+    // Applies to the files already open as well as to those opened later.
+    void setMmapSize(uint64_t);
+
+    static bool acceptsURL(const std::string& url);
+
+private:
+    class Impl;
+
+    std::vector<std::unique_ptr<util::Thread<Impl>>> readers;
+    std::size_t nextReader = 0;
+};
+
+} // namespace mbgl
@@ -0,0 +1,769 @@
+#include <mbgl/style/expression/compiled_expression.hpp>
+#include <mbgl/style/expression/compound_expression.hpp>
+#include <mbgl/style/expression/interpolate.hpp>
+#include <mbgl/style/expression/is_constant.hpp>
+#include <mbgl/style/expression/literal.hpp>
+#include <mbgl/style/expression/step.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/math/log2.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace mbgl {
+namespace style {
+namespace expression {
+
+namespace {
+
+std::vector<const Expression*> childrenOf(const Expression& expression) {
+    std::vector<const Expression*> children;
+    expression.eachChild([&](const Expression& child) {
+        children.push_back(&child);
+    });
+    return children;
+}
+
+bool isTyped(const Expression& expression) {
+    const type::Type type = expression.getType();
+    return type == type::Number || type == type::Boolean;
+}
+
+const Literal* asLiteral(const Expression& expression) {
+    return expression.getKind() == Kind::Literal ? static_cast<const Literal*>(&expression) : nullptr;
+}
+
+optional<std::string> asString(const Expression& expression) {
+    const Literal* literal = asLiteral(expression);
+    if (!literal || !literal->getValue().is<std::string>()) {
+        return {};
+    }
+    return literal->getValue().get<std::string>();
+}
+
+// The key of a ["get", key] expression reading a feature property.
+optional<std::string> asFeatureGet(const Expression& expression) {
+    if (expression.getKind() != Kind::CompoundExpression || expression.getOperator() != "get") {
+        return {};
+    }
+    const auto children = childrenOf(expression);
+    return children.size() == 1 ? asString(*children[0]) : optional<std::string>();
+}
+
+bool containsVar(const Expression& expression) {
+    bool result = expression.getKind() == Kind::Var;
+    expression.eachChild([&](const Expression& child) {
+        result = result || containsVar(child);
+    });
+    return result;
+}
+
+// Whether the expression yields the same result in every evaluation context. Variables are
+// excluded, since they don't expose the expression they're bound to as a child.
+bool isConstant(const Expression& expression) {
+    static const std::array<std::string, 3> globalProperties {{ "zoom", "heatmap-density", "line-progress" }};
+    return isFeatureConstant(expression) &&
+           isGlobalPropertyConstant(expression, globalProperties) &&
+           !containsVar(expression);
+}
+
+optional<double> asDouble(const mbgl::Value& value) {
+    return value.match(
+        [](double number) { return optional<double>(number); },
+        [](uint64_t number) { return optional<double>(static_cast<double>(number)); },
+        [](int64_t number) { return optional<double>(static_cast<double>(number)); },
+        [](const auto&) { return optional<double>(); }
+    );
+}
+
+// Same as comparing the property converted with toExpressionValue(), without converting
+// strings and numbers.
+bool propertyEquals(const mbgl::Value& property, const Value& value) {
+    return value.match(
+        [&](const std::string& string) {
+            return property.is<std::string>() && property.get<std::string>() == string;
+        },
+        [&](double number) {
+            const optional<double> propertyNumber = asDouble(property);
+            return propertyNumber && *propertyNumber == number;
+        },
+        [&](bool boolean) {
+            return property.is<bool>() && property.get<bool>() == boolean;
+        },
+        [&](const auto&) {
+            return toExpressionValue(property) == value;
+        }
+    );
+}
+
+} // namespace
+
+class CompiledExpression::Compiler {
+public:
+    explicit Compiler(CompiledExpression& compiled_) : compiled(compiled_) {}
+
+    // Returns the index of the instruction evaluating the expression, or nullopt if the expression
+    // evaluates to neither a number nor a boolean.
+    optional<std::size_t> compile(const Expression& expression) {
+        if (!isTyped(expression)) {
+            return {};
+        }
+
+        if (isConstant(expression)) {
+            const EvaluationResult result = expression.evaluate(EvaluationContext());
+            if (result && (result->is<double>() || result->is<bool>())) {
+                Instruction instruction { Op::Constant };
+                instruction.constant = result->is<double>() ? result->get<double>() : result->get<bool>();
+                return emit(instruction);
+            }
+        }
+
+        optional<std::size_t> index;
+        switch (expression.getKind()) {
+        case Kind::CompoundExpression:
+            index = compileCompound(expression);
+            break;
+        case Kind::Assertion:
+        case Kind::Coercion:
+            index = compileConversion(expression);
+            break;
+        case Kind::Comparison:
+            index = compileComparison(expression);
+            break;
+        case Kind::Any:
+            index = compileArguments(Op::Any, childrenOf(expression));
+            break;
+        case Kind::All:
+            index = compileArguments(Op::All, childrenOf(expression));
+            break;
+        case Kind::Case:
+            index = compileArguments(Op::Case, childrenOf(expression));
+            break;
+        case Kind::Coalesce: {
+            // Typed arguments never evaluate to null, so the first one decides the result.
+            const auto children = childrenOf(expression);
+            if (!children.empty() && isTyped(*children.front())) {
+                index = compile(*children.front());
+            }
+            break;
+        }
+        case Kind::Interpolate:
+            if (expression.getType() == type::Number) {
+                index = compileCurve(Op::Interpolate, expression, static_cast<const Interpolate&>(expression).getInput(),
+                                     [&](auto visit) { static_cast<const Interpolate&>(expression).eachStop(visit); });
+            }
+            break;
+        case Kind::Step:
+            index = compileCurve(Op::Step, expression, static_cast<const Step&>(expression).getInput(),
+                                 [&](auto visit) { static_cast<const Step&>(expression).eachStop(visit); });
+            break;
+        default:
+            break;
+        }
+
+        if (index) {
+            return index;
+        }
+
+        Instruction instruction { Op::Tree };
+        instruction.expression = &expression;
+        return emit(instruction);
+    }
+
+private:
+    std::size_t emit(const Instruction& instruction) {
+        compiled.code.push_back(instruction);
+        return compiled.code.size() - 1;
+    }
+
+    std::size_t addKey(std::string key) {
+        compiled.keys.push_back(std::move(key));
+        return compiled.keys.size() - 1;
+    }
+
+    std::size_t addValue(Value value) {
+        compiled.values.push_back(std::move(value));
+        return compiled.values.size() - 1;
+    }
+
+    std::size_t emitArguments(Instruction instruction, const std::vector<std::size_t>& arguments) {
+        instruction.operand = compiled.arguments.size();
+        instruction.count = arguments.size();
+        compiled.arguments.insert(compiled.arguments.end(), arguments.begin(), arguments.end());
+        return emit(instruction);
+    }
+
+    optional<std::size_t> compileArguments(Op op, const std::vector<const Expression*>& children) {
+        std::vector<std::size_t> arguments;
+        for (const Expression* child : children) {
+            const optional<std::size_t> argument = compile(*child);
+            if (!argument) {
+                return {};
+            }
+            arguments.push_back(*argument);
+        }
+        return emitArguments(Instruction { op }, arguments);
+    }
+
+    optional<std::size_t> compileCompound(const Expression& expression) {
+        static const std::unordered_map<std::string, Op> unaryOps {
+            { "-", Op::Negate }, { "sqrt", Op::Sqrt }, { "log10", Op::Log10 }, { "ln", Op::Ln },
+            { "log2", Op::Log2 }, { "sin", Op::Sin }, { "cos", Op::Cos }, { "tan", Op::Tan },
+            { "asin", Op::Asin }, { "acos", Op::Acos }, { "atan", Op::Atan }, { "round", Op::Round },
+            { "floor", Op::Floor }, { "ceil", Op::Ceil }, { "abs", Op::Abs }, { "!", Op::Not },
+        };
+        static const std::unordered_map<std::string, Op> binaryOps {
+            { "-", Op::Subtract }, { "/", Op::Divide }, { "%", Op::Mod }, { "^", Op::Pow },
+        };
+        static const std::unordered_map<std::string, Op> variadicOps {
+            { "+", Op::Add }, { "*", Op::Multiply }, { "min", Op::Min }, { "max", Op::Max },
+        };
+
+        const std::string name = expression.getOperator();
+        const auto children = childrenOf(expression);
+
+        if (name == "zoom") {
+            return emit(Instruction { Op::Zoom });
+        } else if (name == "heatmap-density" || name == "line-progress") {
+            return emit(Instruction { Op::ColorRampParameter });
+        } else if (name == "has" || name == "filter-has") {
+            const optional<std::string> key = children.size() == 1 ? asString(*children[0]) : optional<std::string>();
+            if (!key) {
+                return {};
+            }
+            Instruction instruction { name == "has" ? Op::Has : Op::FilterHas };
+            instruction.operand = addKey(*key);
+            return emit(instruction);
+        } else if (name == "filter-==" || name == "filter-in") {
+            const optional<std::string> key = !children.empty() ? asString(*children[0]) : optional<std::string>();
+            if (!key || (name == "filter-==" && children.size() != 2)) {
+                return {};
+            }
+            Instruction instruction { name == "filter-==" ? Op::FilterEquals : Op::FilterIn };
+            instruction.operand = addKey(*key);
+            instruction.value = compiled.values.size();
+            for (std::size_t i = 1; i < children.size(); ++i) {
+                const Literal* literal = asLiteral(*children[i]);
+                if (!literal) {
+                    return {};
+                }
+                addValue(literal->getValue());
+            }
+            instruction.count = compiled.values.size() - instruction.value;
+            return emit(instruction);
+        }
+
+        const auto& ops = children.size() == 1 ? unaryOps : children.size() == 2 ? binaryOps : variadicOps;
+        auto it = ops.find(name);
+        if (it == ops.end()) {
+            it = variadicOps.find(name);
+            if (it == variadicOps.end()) {
+                return {};
+            }
+        }
+        return compileArguments(it->second, children);
+    }
+
+    optional<std::size_t> compileConversion(const Expression& expression) {
+        const auto children = childrenOf(expression);
+        if (children.size() != 1) {
+            return {};
+        }
+
+        const Expression& input = *children[0];
+        if (const optional<std::string> key = asFeatureGet(input)) {
+            Instruction instruction { Op::Tree };
+            if (expression.getKind() == Kind::Coercion) {
+                if (expression.getType() == type::Number) {
+                    instruction.op = Op::ToNumber;
+                }
+            } else {
+                instruction.op = expression.getType() == type::Number ? Op::GetNumber : Op::GetBoolean;
+            }
+            if (instruction.op == Op::Tree) {
+                return {};
+            }
+            instruction.operand = addKey(*key);
+            return emit(instruction);
+        }
+
+        // An assertion of a type the input is already known to have always holds.
+        if (expression.getKind() == Kind::Assertion && input.getType() == expression.getType()) {
+            return compile(input);
+        }
+
+        return {};
+    }
+
+    optional<std::size_t> compileComparison(const Expression& expression) {
+        static const std::unordered_map<std::string, Op> ops {
+            { "==", Op::Equal }, { "!=", Op::NotEqual }, { "<", Op::Less },
+            { "<=", Op::LessEqual }, { ">", Op::Greater }, { ">=", Op::GreaterEqual },
+        };
+        // The operation with swapped operands.
+        static const std::unordered_map<std::string, Op> swappedOps {
+            { "==", Op::Equal }, { "!=", Op::NotEqual }, { "<", Op::Greater },
+            { "<=", Op::GreaterEqual }, { ">", Op::Less }, { ">=", Op::LessEqual },
+        };
+
+        const auto children = childrenOf(expression);
+        const auto it = ops.find(expression.getOperator());
+        if (children.size() != 2 || it == ops.end()) {
+            // Comparisons using a collator aren't compiled.
+            return {};
+        }
+
+        const Expression& lhs = *children[0];
+        const Expression& rhs = *children[1];
+        const type::Type lhsType = lhs.getType();
+        if (lhsType == rhs.getType() &&
+            (lhsType == type::Number || (lhsType == type::Boolean && (it->second == Op::Equal || it->second == Op::NotEqual)))) {
+            return compileArguments(it->second, children);
+        }
+
+        // Comparisons of a feature property with a literal, e.g. ["==", ["get", "class"], "street"].
+        optional<std::string> key = asFeatureGet(lhs);
+        const Literal* literal = asLiteral(rhs);
+        Op comparison = it->second;
+        if (!key || !literal) {
+            key = asFeatureGet(rhs);
+            literal = asLiteral(lhs);
+            comparison = swappedOps.at(expression.getOperator());
+        }
+        if (!key || !literal) {
+            return {};
+        }
+
+        Instruction instruction { Op::CompareProperty };
+        instruction.operand = addKey(*key);
+        instruction.value = addValue(literal->getValue());
+        instruction.comparison = comparison;
+        return emit(instruction);
+    }
+
+    template <class EachStop>
+    optional<std::size_t> compileCurve(Op op, const Expression& expression, const std::unique_ptr<Expression>& input, EachStop eachStop) {
+        std::vector<std::size_t> arguments;
+        const optional<std::size_t> inputIndex = compile(*input);
+        if (!inputIndex) {
+            return {};
+        }
+        arguments.push_back(*inputIndex);
+
+        Instruction instruction { op };
+        instruction.expression = &expression;
+        instruction.value = compiled.stopInputs.size();
+        bool typed = true;
+        eachStop([&](double stopInput, const Expression& output) {
+            const optional<std::size_t> outputIndex = typed ? compile(output) : optional<std::size_t>();
+            if (!outputIndex) {
+                typed = false;
+                return;
+            }
+            compiled.stopInputs.push_back(stopInput);
+            arguments.push_back(*outputIndex);
+        });
+        if (!typed) {
+            return {};
+        }
+        return emitArguments(instruction, arguments);
+    }
+
+    CompiledExpression& compiled;
+};
+
+CompiledExpression::CompiledExpression(std::shared_ptr<const Expression> expression_)
+    : expression(std::move(expression_)) {
+}
+
+std::shared_ptr<const CompiledExpression> CompiledExpression::compile(std::shared_ptr<const Expression> expression_) {
+    if (!expression_ || !isTyped(*expression_)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<CompiledExpression> compiled(new CompiledExpression(std::move(expression_)));
+    Compiler compiler(*compiled);
+    const optional<std::size_t> root = compiler.compile(*compiled->expression);
+    assert(root);
+
+    // Evaluation starts at the last instruction emitted.
+    if (!root || *root != compiled->code.size() - 1 || compiled->code.back().op == Op::Tree) {
+        return nullptr;
+    }
+    return std::move(compiled);
+}
+
+optional<double> CompiledExpression::evaluateNumber(const EvaluationContext& params) const {
+    assert(expression->getType() == type::Number);
+    double result = 0;
+    return evaluate(code.size() - 1, params, result) ? optional<double>(result) : optional<double>();
+}
+
+optional<bool> CompiledExpression::evaluateBoolean(const EvaluationContext& params) const {
+    assert(expression->getType() == type::Boolean);
+    double result = 0;
+    return evaluate(code.size() - 1, params, result) ? optional<bool>(result != 0) : optional<bool>();
+}
+
+std::vector<optional<double>> CompiledExpression::evaluateNumbers(optional<float> zoom, const std::vector<const GeometryTileFeature*>& features) const {
+    assert(expression->getType() == type::Number);
+    std::vector<optional<double>> results;
+    results.reserve(features.size());
+
+    const Op op = code.back().op;
+    if (op == Op::Interpolate || op == Op::Step) {
+        evaluateCurve(zoom, features, results);
+    } else {
+        for (const GeometryTileFeature* feature : features) {
+            results.push_back(evaluateNumber(EvaluationContext(zoom, feature, nullopt)));
+        }
+    }
+    return results;
+}
+
+void CompiledExpression::evaluateCurve(optional<float> zoom, const std::vector<const GeometryTileFeature*>& features, std::vector<optional<double>>& results) const {
+    const Instruction& curve = code.back();
+    const auto arg = [&](std::size_t i) { return arguments[curve.operand + i]; };
+    const std::size_t stopCount = curve.count - 1;
+    const double* inputs = stopInputs.data() + curve.value;
+
+    // Reads the output of the stop at the given index, without evaluating constant outputs.
+    const auto output = [&](std::size_t stop, const EvaluationContext& params, double& result) {
+        const Instruction& instruction = code[arg(stop + 1)];
+        if (instruction.op == Op::Constant) {
+            result = instruction.constant;
+            return true;
+        }
+        return evaluate(arg(stop + 1), params, result);
+    };
+
+    // The stop the previous input fell into. Inputs often repeat from one feature to the next, e.g.
+    // for composite functions of the zoom level or for categorical properties.
+    optional<float> previous;
+    std::size_t upper = 0;
+    float t = 0.0f;
+
+    for (const GeometryTileFeature* feature : features) {
+        const EvaluationContext params(zoom, feature, nullopt);
+        double input = 0;
+        if (stopCount == 0 || !evaluate(arg(0), params, input) || std::isnan(static_cast<float>(input))) {
+            results.emplace_back();
+            continue;
+        }
+
+        const float x = input;
+        if (!previous || *previous != x) {
+            previous = x;
+            upper = std::upper_bound(inputs, inputs + stopCount, x) - inputs;
+            t = 0.0f;
+            if (curve.op == Op::Interpolate && upper != 0 && upper != stopCount) {
+                const auto& interpolate = static_cast<const Interpolate&>(*curve.expression);
+                t = interpolate.interpolationFactor({ inputs[upper - 1], inputs[upper] }, x);
+            }
+        }
+
+        double lhs = 0;
+        double rhs = 0;
+        bool evaluated = false;
+        if (upper == stopCount) {
+            evaluated = output(stopCount - 1, params, lhs);
+        } else if (upper == 0) {
+            evaluated = output(0, params, lhs);
+        } else if (curve.op == Op::Step || t == 0.0f) {
+            evaluated = output(upper - 1, params, lhs);
+        } else if (t == 1.0f) {
+            evaluated = output(upper, params, lhs);
+        } else if (output(upper - 1, params, lhs) && output(upper, params, rhs)) {
+            lhs = lhs * (1.0 - t) + rhs * t;
+            evaluated = true;
+        }
+        results.push_back(evaluated ? optional<double>(lhs) : optional<double>());
+    }
+}
+
+bool CompiledExpression::evaluate(std::size_t index, const EvaluationContext& params, double& result) const {
+    const Instruction& instruction = code[index];
+    const auto arg = [&](std::size_t i) { return arguments[instruction.operand + i]; };
+    double lhs = 0;
+    double rhs = 0;
+
+    switch (instruction.op) {
+    case Op::Constant:
+        result = instruction.constant;
+        return true;
+
+    case Op::Zoom:
+        if (!params.zoom) return false;
+        result = *params.zoom;
+        return true;
+
+    case Op::ColorRampParameter:
+        if (!params.colorRampParameter) return false;
+        result = *params.colorRampParameter;
+        return true;
+
+    case Op::GetNumber:
+    case Op::GetBoolean:
+    case Op::ToNumber:
+    case Op::Has:
+    case Op::FilterHas:
+    case Op::FilterEquals:
+    case Op::FilterIn:
+    case Op::CompareProperty:
+        if (!params.feature) return false;
+        return evaluateProperty(instruction, params.feature->getValue(keys[instruction.operand]), result);
+
+    case Op::Add:
+        result = 0;
+        for (std::size_t i = 0; i < instruction.count; ++i) {
+            if (!evaluate(arg(i), params, lhs)) return false;
+            result += lhs;
+        }
+        return true;
+
+    case Op::Multiply:
+        result = 1;
+        for (std::size_t i = 0; i < instruction.count; ++i) {
+            if (!evaluate(arg(i), params, lhs)) return false;
+            result *= lhs;
+        }
+        return true;
+
+    case Op::Min:
+        result = std::numeric_limits<double>::infinity();
+        for (std::size_t i = 0; i < instruction.count; ++i) {
+            if (!evaluate(arg(i), params, lhs)) return false;
+            result = std::fmin(lhs, result);
+        }
+        return true;
+
+    case Op::Max:
+        result = -std::numeric_limits<double>::infinity();
+        for (std::size_t i = 0; i < instruction.count; ++i) {
+            if (!evaluate(arg(i), params, lhs)) return false;
+            result = std::fmax(lhs, result);
+        }
+        return true;
+
+    case Op::Subtract:
+    case Op::Divide:
+    case Op::Mod:
+    case Op::Pow:
+    case Op::Equal:
+    case Op::NotEqual:
+    case Op::Less:
+    case Op::LessEqual:
+    case Op::Greater:
+    case Op::GreaterEqual:
+        if (!evaluate(arg(0), params, lhs) || !evaluate(arg(1), params, rhs)) return false;
+        switch (instruction.op) {
+        case Op::Subtract: result = lhs - rhs; break;
+        case Op::Divide: result = lhs / rhs; break;
+        case Op::Mod: result = std::fmod(lhs, rhs); break;
+        case Op::Pow: result = std::pow(lhs, rhs); break;
+        default: result = compare(instruction.op, lhs, rhs); break;
+        }
+        return true;
+
+    case Op::Negate:
+    case Op::Sqrt:
+    case Op::Log10:
+    case Op::Ln:
+    case Op::Log2:
+    case Op::Sin:
+    case Op::Cos:
+    case Op::Tan:
+    case Op::Asin:
+    case Op::Acos:
+    case Op::Atan:
+    case Op::Round:
+    case Op::Floor:
+    case Op::Ceil:
+    case Op::Abs:
+    case Op::Not:
+        if (!evaluate(arg(0), params, lhs)) return false;
+        switch (instruction.op) {
+        case Op::Negate: result = -lhs; break;
+        case Op::Sqrt: result = std::sqrt(lhs); break;
+        case Op::Log10: result = std::log10(lhs); break;
+        case Op::Ln: result = std::log(lhs); break;
+        case Op::Log2: result = util::log2(lhs); break;
+        case Op::Sin: result = std::sin(lhs); break;
+        case Op::Cos: result = std::cos(lhs); break;
+        case Op::Tan: result = std::tan(lhs); break;
+        case Op::Asin: result = std::asin(lhs); break;
+        case Op::Acos: result = std::acos(lhs); break;
+        case Op::Atan: result = std::atan(lhs); break;
+        case Op::Round: result = ::round(lhs); break;
+        case Op::Floor: result = std::floor(lhs); break;
+        case Op::Ceil: result = std::ceil(lhs); break;
+        case Op::Abs: result = std::abs(lhs); break;
+        default: result = lhs == 0; break; // Op::Not
+        }
+        return true;
+
+    case Op::Any:
+    case Op::All: {
+        const bool any = instruction.op == Op::Any;
+        for (std::size_t i = 0; i < instruction.count; ++i) {
+            if (!evaluate(arg(i), params, lhs)) return false;
+            if ((lhs != 0) == any) {
+                result = any;
+                return true;
+            }
+        }
+        result = !any;
+        return true;
+    }
+
+    case Op::Case:
+        // Arguments are pairs of conditions and outputs, followed by the fallback output.
+        for (std::size_t i = 0; i + 1 < instruction.count; i += 2) {
+            if (!evaluate(arg(i), params, lhs)) return false;
+            if (lhs != 0) {
+                return evaluate(arg(i + 1), params, result);
+            }
+        }
+        return evaluate(arg(instruction.count - 1), params, result);
+
+    case Op::Interpolate:
+    case Op::Step: {
+        // Arguments are the input followed by the stop outputs.
+        if (!evaluate(arg(0), params, lhs)) return false;
+        const float x = lhs;
+        const std::size_t stopCount = instruction.count - 1;
+        if (std::isnan(x) || stopCount == 0) return false;
+
+        const double* inputs = stopInputs.data() + instruction.value;
+        const std::size_t upper = std::upper_bound(inputs, inputs + stopCount, x) - inputs;
+        if (upper == stopCount) {
+            return evaluate(arg(stopCount), params, result);
+        } else if (upper == 0) {
+            return evaluate(arg(1), params, result);
+        } else if (instruction.op == Op::Step) {
+            return evaluate(arg(upper), params, result);
+        }
+
+        const auto& interpolate = static_cast<const Interpolate&>(*instruction.expression);
+        const float t = interpolate.interpolationFactor({ inputs[upper - 1], inputs[upper] }, x);
+        if (t == 0.0f) {
+            return evaluate(arg(upper), params, result);
+        }
+        if (t == 1.0f) {
+            return evaluate(arg(upper + 1), params, result);
+        }
+        if (!evaluate(arg(upper), params, lhs) || !evaluate(arg(upper + 1), params, rhs)) return false;
+        result = lhs * (1.0 - t) + rhs * t;
+        return true;
+    }
+
+    case Op::Tree: {
+        const EvaluationResult evaluated = instruction.expression->evaluate(params);
+        if (!evaluated) return false;
+        if (evaluated->is<double>()) {
+            result = evaluated->get<double>();
+            return true;
+        } else if (evaluated->is<bool>()) {
+            result = evaluated->get<bool>();
+            return true;
+        }
+        return false;
+    }
+    }
+
+    assert(false);
+    return false;
+}
+
+bool CompiledExpression::evaluateProperty(const Instruction& instruction, const optional<mbgl::Value>& property, double& result) const {
+    switch (instruction.op) {
+    case Op::GetNumber: {
+        const optional<double> number = property ? asDouble(*property) : optional<double>();
+        if (!number) return false;
+        result = *number;
+        return true;
+    }
+    case Op::GetBoolean:
+        if (!property || !property->is<bool>()) return false;
+        result = property->get<bool>();
+        return true;
+    case Op::ToNumber: {
+        if (!property || property->is<NullValue>()) {
+            result = 0;
+            return true;
+        }
+        if (property->is<std::string>()) {
+            try {
+                result = util::stof(property->get<std::string>());
+                return true;
+            } catch (...) {
+                return false;
+            }
+        }
+        const optional<double> number = asDouble(*property);
+        if (!number) return false;
+        result = *number;
+        return true;
+    }
+    case Op::Has:
+    case Op::FilterHas:
+        result = bool(property);
+        return true;
+    case Op::FilterEquals:
+        result = property && propertyEquals(*property, values[instruction.value]);
+        return true;
+    case Op::FilterIn: {
+        const auto begin = values.begin() + instruction.value;
+        result = property && std::any_of(begin, begin + instruction.count, [&](const Value& value) {
+            return propertyEquals(*property, value);
+        });
+        return true;
+    }
+    default: { // Op::CompareProperty
+        const Value& value = values[instruction.value];
+        if (instruction.comparison == Op::Equal || instruction.comparison == Op::NotEqual) {
+            // A missing property compares as null.
+            const bool equal = property ? propertyEquals(*property, value) : value.is<NullValue>();
+            result = equal == (instruction.comparison == Op::Equal);
+            return true;
+        }
+        // Ordering requires both operands to be strings or both to be numbers.
+        if (!property) return false;
+        if (value.is<std::string>()) {
+            if (!property->is<std::string>()) return false;
+            const int order = property->get<std::string>().compare(value.get<std::string>());
+            result = compare(instruction.comparison, order, 0);
+            return true;
+        }
+        const optional<double> number = asDouble(*property);
+        if (!value.is<double>() || !number) return false;
+        result = compare(instruction.comparison, *number, value.get<double>());
+        return true;
+    }
+    }
+
+    assert(false);
+    return false;
+}
+
+bool CompiledExpression::compare(Op op, double lhs, double rhs) {
+    switch (op) {
+    case Op::Equal: return lhs == rhs;
+    case Op::NotEqual: return lhs != rhs;
+    case Op::Less: return lhs < rhs;
+    case Op::LessEqual: return lhs <= rhs;
+    case Op::Greater: return lhs > rhs;
+    case Op::GreaterEqual: return lhs >= rhs;
+    default:
+        assert(false);
+        return false;
+    }
+}
+
+} // namespace expression
+} // namespace style
+} // namespace mbgl
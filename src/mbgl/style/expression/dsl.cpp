@@ -90,6 +90,11 @@ std::unique_ptr<Expression> toColor(std::unique_ptr<Expression> value,
     return coercion(type::Color, std::move(value), std::move(def));
 }
 
+std::unique_ptr<Expression> toNumber(std::unique_ptr<Expression> value,
+                                     std::unique_ptr<Expression> def) {
+    return coercion(type::Number, std::move(value), std::move(def));
+}
+
 std::unique_ptr<Expression> toString(std::unique_ptr<Expression> value,
                                      std::unique_ptr<Expression> def) {
     return coercion(type::String, std::move(value), std::move(def));
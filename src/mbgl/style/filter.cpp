@@ -1,13 +1,28 @@
 #include <mbgl/style/filter.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 
 namespace mbgl {
 namespace style {
 
+Filter::Filter(expression::ParseResult _expression, optional<mbgl::Value> _filter)
+    : expression(std::move(*_expression)),
+      legacyFilter(std::move(_filter)) {
+    assert(!expression || *expression != nullptr);
+    if (expression && (**expression).getType() == expression::type::Boolean) {
+        compiled = expression::CompiledExpression::compile(*expression);
+    }
+}
+
 bool Filter::operator()(const expression::EvaluationContext &context) const {
     
     if (!this->expression) return true;
     
+    if (compiled) {
+        const optional<bool> result = compiled->evaluateBoolean(context);
+        return result ? *result : false;
+    }
+
     const expression::EvaluationResult result = (*this->expression)->evaluate(context);
     if (result) {
         const optional<bool> typed = expression::fromExpressionValue<bool>(*result);
@@ -0,0 +1,84 @@
+#include <mbgl/style/parse_cache.hpp>
+#include <mbgl/style/layer_impl.hpp>
+
+namespace mbgl {
+namespace style {
+
+template <class T>
+optional<T> ParseCache::Entries<T>::get(const std::string& json) {
+    const auto it = slots.find(json);
+    if (it == slots.end()) {
+        return {};
+    }
+    recent.splice(recent.begin(), recent, it->second.position);
+    return it->second.value;
+}
+
+template <class T>
+void ParseCache::Entries<T>::put(const std::string& json, T value) {
+    if (maxSize == 0) {
+        return;
+    }
+
+    const auto it = slots.find(json);
+    if (it != slots.end()) {
+        // Another Map parsed the same JSON meanwhile.
+        it->second.value = std::move(value);
+        recent.splice(recent.begin(), recent, it->second.position);
+        return;
+    }
+
+    while (slots.size() >= maxSize) {
+        slots.erase(*recent.back());
+        recent.pop_back();
+    }
+
+    const auto inserted = slots.emplace(json, Slot { std::move(value), {} }).first;
+    recent.push_front(&inserted->first);
+    inserted->second.position = recent.begin();
+}
+
+template <class T>
+void ParseCache::Entries<T>::clear() {
+    slots.clear();
+    recent.clear();
+}
+
+ParseCache::ParseCache(std::size_t maxStyles, std::size_t maxLayers)
+    : styles(maxStyles),
+      layers(maxLayers) {
+}
+
+ParseCache& ParseCache::shared() {
+    static ParseCache cache(8, 4096);
+    return cache;
+}
+
+std::shared_ptr<const ParseCache::Style> ParseCache::getStyle(const std::string& json) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return styles.get(json).value_or(nullptr);
+}
+
+void ParseCache::putStyle(const std::string& json, std::shared_ptr<const Style> style) {
+    std::lock_guard<std::mutex> lock(mutex);
+    styles.put(json, std::move(style));
+}
+
+optional<Immutable<Layer::Impl>> ParseCache::getLayer(const std::string& json) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return layers.get(json);
+}
+
+void ParseCache::putLayer(const std::string& json, Immutable<Layer::Impl> layer) {
+    std::lock_guard<std::mutex> lock(mutex);
+    layers.put(json, std::move(layer));
+}
+
+void ParseCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    styles.clear();
+    layers.clear();
+}
+
+} // namespace style
+} // namespace mbgl
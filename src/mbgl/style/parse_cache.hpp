@@ -0,0 +1,91 @@
+#pragma once
+
+#include <mbgl/style/layer.hpp>
+#include <mbgl/style/light.hpp>
+#include <mbgl/style/transition_options.hpp>
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/immutable.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mbgl {
+namespace style {
+
+/*
+    ParseCache holds the results of recently parsed styles, and of the layers in them, for all
+    Maps in the process. Parsing a style converts every expression of every layer, which is
+    costly for large styles that are loaded over and over, e.g. by render workers, or switched
+    between variants that differ in a few layers only.
+
+    Styles are looked up by their JSON. Layers are looked up by the JSON of their definition, so
+    that the layers a style shares with a previously parsed one share their `Immutable<Impl>`,
+    which lets the renderer keep them as they are. Sources aren't cached: they hold loading
+    state, so only their definitions are kept, to be converted again.
+*/
+class ParseCache {
+public:
+    struct Style {
+        std::string spriteURL;
+        std::string glyphURL;
+        std::string name;
+        LatLng latLng;
+        double zoom = 0;
+        double bearing = 0;
+        double pitch = 0;
+        TransitionOptions transition;
+        Light light;
+
+        // Source IDs and their JSON definitions.
+        std::vector<std::pair<std::string, std::string>> sources;
+        std::vector<Immutable<Layer::Impl>> layers;
+    };
+
+    ParseCache(std::size_t maxStyles, std::size_t maxLayers);
+
+    // The cache shared by all styles in the process.
+    static ParseCache& shared();
+
+    std::shared_ptr<const Style> getStyle(const std::string& json);
+    void putStyle(const std::string& json, std::shared_ptr<const Style>);
+
+    optional<Immutable<Layer::Impl>> getLayer(const std::string& json);
+    void putLayer(const std::string& json, Immutable<Layer::Impl>);
+
+    void clear();
+
+private:
+    // Least recently used entries are evicted first.
+    template <class T>
+    class Entries {
+    public:
+        explicit Entries(std::size_t maxSize_) : maxSize(maxSize_) {}
+
+        optional<T> get(const std::string& json);
+        void put(const std::string& json, T);
+        void clear();
+
+    private:
+        struct Slot {
+            T value;
+            typename std::list<const std::string*>::iterator position;
+        };
+
+        const std::size_t maxSize;
+        std::unordered_map<std::string, Slot> slots;
+        std::list<const std::string*> recent;
+    };
+
+    std::mutex mutex;
+    Entries<std::shared_ptr<const Style>> styles;
+    Entries<Immutable<Layer::Impl>> layers;
+};
+
+} // namespace style
+} // namespace mbgl
@@ -1,5 +1,6 @@
 #include <mbgl/style/parser.hpp>
 #include <mbgl/style/layer_impl.hpp>
+#include <mbgl/layermanager/layer_manager.hpp>
 #include <mbgl/style/rapidjson_conversion.hpp>
 #include <mbgl/style/conversion/coordinate.hpp>
 #include <mbgl/style/conversion/source.hpp>
@@ -15,6 +16,8 @@
 
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
 
 #include <algorithm>
 #include <set>
@@ -22,9 +25,26 @@
 namespace mbgl {
 namespace style {
 
+namespace {
+
+std::string stringify(const JSValue& value) {
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    value.Accept(writer);
+    return { buffer.GetString(), buffer.GetSize() };
+}
+
+} // namespace
+
 Parser::~Parser() = default;
 
 StyleParseResult Parser::parse(const std::string& json) {
+    if (std::shared_ptr<const ParseCache::Style> cached = ParseCache::shared().getStyle(json)) {
+        restore(*cached);
+        fontStacks();
+        return nullptr;
+    }
+
     rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::CrtAllocator> document;
     document.Parse<0>(json.c_str());
 
@@ -40,7 +60,7 @@ StyleParseResult Parser::parse(const std::string& json) {
         const JSValue& versionValue = document["version"];
         const int version = versionValue.IsNumber() ? versionValue.GetInt() : 0;
         if (version != 8) {
-            Log::Warning(Event::ParseStyle, "current renderer implementation only supports style spec version 8; using an outdated style will cause rendering errors");
+            warning("current renderer implementation only supports style spec version 8; using an outdated style will cause rendering errors");
         }
     }
 
@@ -58,7 +78,7 @@ StyleParseResult Parser::parse(const std::string& json) {
         if (convertedLatLng) {
             latLng = *convertedLatLng;
         } else {
-            Log::Warning(Event::ParseStyle, "center coordinate must be a longitude, latitude pair");
+            warning("center coordinate must be a longitude, latitude pair");
         }
     }
 
@@ -116,14 +136,66 @@ StyleParseResult Parser::parse(const std::string& json) {
     // Call for side effect of logging warnings for invalid values.
     fontStacks();
 
+    if (cacheable) {
+        ParseCache::shared().putStyle(json, snapshot());
+    }
     return nullptr;
 }
 
+void Parser::restore(const ParseCache::Style& style) {
+    spriteURL = style.spriteURL;
+    glyphURL = style.glyphURL;
+    name = style.name;
+    latLng = style.latLng;
+    zoom = style.zoom;
+    bearing = style.bearing;
+    pitch = style.pitch;
+    transition = style.transition;
+    light = style.light;
+
+    for (const auto& source : style.sources) {
+        JSDocument document;
+        document.Parse<0>(source.second.c_str());
+        parseSource(source.first, document, source.second);
+    }
+
+    layers.reserve(style.layers.size());
+    for (const auto& impl : style.layers) {
+        if (std::unique_ptr<Layer> layer = LayerManager::get()->createLayer(impl)) {
+            layers.emplace_back(std::move(layer));
+        }
+    }
+}
+
+std::shared_ptr<const ParseCache::Style> Parser::snapshot() const {
+    auto style = std::make_shared<ParseCache::Style>();
+    style->spriteURL = spriteURL;
+    style->glyphURL = glyphURL;
+    style->name = name;
+    style->latLng = latLng;
+    style->zoom = zoom;
+    style->bearing = bearing;
+    style->pitch = pitch;
+    style->transition = transition;
+    style->light = light;
+
+    style->sources.reserve(sources.size());
+    for (const auto& source : sources) {
+        style->sources.emplace_back(source->getID(), sourceDefinitions.at(source->getID()));
+    }
+
+    style->layers.reserve(layers.size());
+    for (const auto& layer : layers) {
+        style->layers.emplace_back(layer->baseImpl);
+    }
+    return style;
+}
+
 void Parser::parseTransition(const JSValue& value) {
     conversion::Error error;
     optional<TransitionOptions> converted = conversion::convert<TransitionOptions>(value, error);
     if (!converted) {
-        Log::Warning(Event::ParseStyle, error.message);
+        warning(error.message);
         return;
     }
 
@@ -134,7 +206,7 @@ void Parser::parseLight(const JSValue& value) {
     conversion::Error error;
     optional<Light> converted = conversion::convert<Light>(value, error);
     if (!converted) {
-        Log::Warning(Event::ParseStyle, error.message);
+        warning(error.message);
         return;
     }
 
@@ -143,54 +215,58 @@ void Parser::parseLight(const JSValue& value) {
 
 void Parser::parseSources(const JSValue& value) {
     if (!value.IsObject()) {
-        Log::Warning(Event::ParseStyle, "sources must be an object");
+        warning("sources must be an object");
         return;
     }
 
     for (const auto& property : value.GetObject()) {
         std::string id { property.name.GetString(), property.name.GetStringLength() };
+        parseSource(id, property.value, stringify(property.value));
+    }
+}
 
-        conversion::Error error;
-        optional<std::unique_ptr<Source>> source =
-            conversion::convert<std::unique_ptr<Source>>(property.value, error, id);
-        if (!source) {
-            Log::Warning(Event::ParseStyle, error.message);
-            continue;
-        }
-
-        sourcesMap.emplace(id, (*source).get());
-        sources.emplace_back(std::move(*source));
+void Parser::parseSource(const std::string& id, const JSValue& value, std::string definition) {
+    conversion::Error error;
+    optional<std::unique_ptr<Source>> source =
+        conversion::convert<std::unique_ptr<Source>>(value, error, id);
+    if (!source) {
+        warning(error.message);
+        return;
     }
+
+    sourcesMap.emplace(id, (*source).get());
+    sourceDefinitions.emplace(id, std::move(definition));
+    sources.emplace_back(std::move(*source));
 }
 
 void Parser::parseLayers(const JSValue& value) {
     std::vector<std::string> ids;
 
     if (!value.IsArray()) {
-        Log::Warning(Event::ParseStyle, "layers must be an array");
+        warning("layers must be an array");
         return;
     }
 
     for (auto& layerValue : value.GetArray()) {
         if (!layerValue.IsObject()) {
-            Log::Warning(Event::ParseStyle, "layer must be an object");
+            warning("layer must be an object");
             continue;
         }
 
         if (!layerValue.HasMember("id")) {
-            Log::Warning(Event::ParseStyle, "layer must have an id");
+            warning("layer must have an id");
             continue;
         }
 
         const JSValue& id = layerValue["id"];
         if (!id.IsString()) {
-            Log::Warning(Event::ParseStyle, "layer id must be a string");
+            warning("layer id must be a string");
             continue;
         }
 
         const std::string layerID = { id.GetString(), id.GetStringLength() };
         if (layersMap.find(layerID) != layersMap.end()) {
-            Log::Warning(Event::ParseStyle, "duplicate layer id %s", layerID.c_str());
+            warning("duplicate layer id %s", layerID.c_str());
             continue;
         }
 
@@ -223,7 +299,7 @@ void Parser::parseLayer(const std::string& id, const JSValue& value, std::unique
 
     // Make sure we have not previously attempted to parse this layer.
     if (std::find(stack.begin(), stack.end(), id) != stack.end()) {
-        Log::Warning(Event::ParseStyle, "layer reference of '%s' is circular", id.c_str());
+        warning("layer reference of '%s' is circular", id.c_str());
         return;
     }
 
@@ -231,14 +307,14 @@ void Parser::parseLayer(const std::string& id, const JSValue& value, std::unique
         // This layer is referencing another layer. Recursively parse that layer.
         const JSValue& refVal = value["ref"];
         if (!refVal.IsString()) {
-            Log::Warning(Event::ParseStyle, "layer ref of '%s' must be a string", id.c_str());
+            warning("layer ref of '%s' must be a string", id.c_str());
             return;
         }
 
         const std::string ref { refVal.GetString(), refVal.GetStringLength() };
         auto it = layersMap.find(ref);
         if (it == layersMap.end()) {
-            Log::Warning(Event::ParseStyle, "layer '%s' references unknown layer %s", id.c_str(), ref.c_str());
+            warning("layer '%s' references unknown layer %s", id.c_str(), ref.c_str());
             return;
         }
 
@@ -257,13 +333,21 @@ void Parser::parseLayer(const std::string& id, const JSValue& value, std::unique
         layer = reference->cloneRef(id);
         conversion::setPaintProperties(*layer, conversion::Convertible(&value));
     } else {
+        // Layers that were parsed before, by this or another style, share their implementation.
+        const std::string definition = stringify(value);
+        if (optional<Immutable<Layer::Impl>> cached = ParseCache::shared().getLayer(definition)) {
+            layer = LayerManager::get()->createLayer(std::move(*cached));
+            return;
+        }
+
         conversion::Error error;
         optional<std::unique_ptr<Layer>> converted = conversion::convert<std::unique_ptr<Layer>>(value, error);
         if (!converted) {
-            Log::Warning(Event::ParseStyle, error.message);
+            warning(error.message);
             return;
         }
         layer = std::move(*converted);
+        ParseCache::shared().putLayer(definition, layer->baseImpl);
     }
 }
 
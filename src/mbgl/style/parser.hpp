@@ -3,11 +3,13 @@
 #include <mbgl/style/layer.hpp>
 #include <mbgl/style/source.hpp>
 #include <mbgl/style/light.hpp>
+#include <mbgl/style/parse_cache.hpp>
 
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/rapidjson.hpp>
 #include <mbgl/util/font_stack.hpp>
 #include <mbgl/util/geo.hpp>
+#include <mbgl/util/logging.hpp>
 
 #include <vector>
 #include <memory>
@@ -27,10 +29,16 @@ public:
 
     StyleParseResult parse(const std::string&);
 
+    // A parsed style is cached as a snapshot, and restored from it when parsed again.
+    std::shared_ptr<const ParseCache::Style> snapshot() const;
+    void restore(const ParseCache::Style&);
+
     std::string spriteURL;
     std::string glyphURL;
 
     std::vector<std::unique_ptr<Source>> sources;
+    // The JSON definition of each source, by source ID.
+    std::unordered_map<std::string, std::string> sourceDefinitions;
     std::vector<std::unique_ptr<Layer>> layers;
 
     TransitionOptions transition { { util::DEFAULT_TRANSITION_DURATION } };
@@ -49,9 +57,19 @@ private:
     void parseTransition(const JSValue&);
     void parseLight(const JSValue&);
     void parseSources(const JSValue&);
+    void parseSource(const std::string& id, const JSValue&, std::string definition);
     void parseLayers(const JSValue&);
     void parseLayer(const std::string& id, const JSValue&, std::unique_ptr<Layer>&);
 
+    // Styles with warnings aren't cached, as restoring them wouldn't log the warnings again.
+    template <typename... Args>
+    void warning(Args&&... args) {
+        cacheable = false;
+        Log::Warning(Event::ParseStyle, std::forward<Args>(args)...);
+    }
+
+    bool cacheable = true;
+
     std::unordered_map<std::string, const Source*> sourcesMap;
     std::unordered_map<std::string, std::pair<const JSValue&, std::unique_ptr<Layer>>> layersMap;
 
@@ -0,0 +1,24 @@
+#include <mbgl/style/parser_worker.hpp>
+#include <mbgl/style/parser.hpp>
+#include <mbgl/style/style_impl.hpp>
+
+namespace mbgl {
+namespace style {
+
+ParserWorker::ParserWorker(ActorRef<ParserWorker>, ActorRef<Style::Impl> parent_)
+    : parent(std::move(parent_)) {
+}
+
+void ParserWorker::parse(std::shared_ptr<const std::string> json) {
+    auto parser = std::make_unique<Parser>();
+
+    if (StyleParseResult error = parser->parse(*json)) {
+        parent.invoke(&Style::Impl::onParseError, error);
+        return;
+    }
+
+    parent.invoke(&Style::Impl::onParsed, std::move(json), std::move(parser));
+}
+
+} // namespace style
+} // namespace mbgl
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/style/style.hpp>
+
+#include <memory>
+#include <string>
+
+namespace mbgl {
+namespace style {
+
+// Parses styles loaded from a URL on a background thread, and hands the parser with the
+// converted sources and layers over to the style. Until then, nothing else refers to them.
+class ParserWorker {
+public:
+    ParserWorker(ActorRef<ParserWorker>, ActorRef<Style::Impl>);
+
+    void parse(std::shared_ptr<const std::string> json);
+
+private:
+    ActorRef<Style::Impl> parent;
+};
+
+} // namespace style
+} // namespace mbgl
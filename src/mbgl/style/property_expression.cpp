@@ -1,4 +1,5 @@
 #include <mbgl/style/property_expression.hpp>
+#include <mbgl/style/expression/compiled_expression.hpp>
 
 namespace mbgl {
 namespace style {
@@ -8,6 +9,9 @@ PropertyExpressionBase::PropertyExpressionBase(std::unique_ptr<expression::Expre
       zoomCurve(expression::findZoomCurveChecked(expression.get())) {
     isZoomConstant_ = expression::isZoomConstant(*expression);
     isFeatureConstant_ = expression::isFeatureConstant(*expression);
+    if (expression->getType() == expression::type::Number) {
+        compiled = expression::CompiledExpression::compile(expression);
+    }
 }
 
 bool PropertyExpressionBase::isZoomConstant() const noexcept {
@@ -60,6 +64,22 @@ Range<float> PropertyExpressionBase::getCoveringStops(const float lower, const f
     );
 }
 
+optional<float> PropertyExpressionBase::evaluateCompiled(const expression::EvaluationContext& context) const {
+    assert(compiled);
+    const optional<double> result = compiled->evaluateNumber(context);
+    return result ? optional<float>(*result) : nullopt;
+}
+
+std::vector<optional<float>> PropertyExpressionBase::evaluateCompiled(optional<float> zoom, const std::vector<const GeometryTileFeature*>& features) const {
+    assert(compiled);
+    std::vector<optional<float>> results;
+    results.reserve(features.size());
+    for (const optional<double>& result : compiled->evaluateNumbers(zoom, features)) {
+        results.push_back(result ? optional<float>(*result) : nullopt);
+    }
+    return results;
+}
+
 const expression::Expression& PropertyExpressionBase::getExpression() const noexcept {
     return *expression;
 }
@@ -13,6 +13,7 @@
 #include <mbgl/style/layers/hillshade_layer.hpp>
 #include <mbgl/style/layer_impl.hpp>
 #include <mbgl/style/parser.hpp>
+#include <mbgl/style/parser_worker.hpp>
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/sprite/sprite_loader.hpp>
 #include <mbgl/util/exception.hpp>
@@ -21,6 +22,9 @@
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/actor/actor.hpp>
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/actor/scheduler.hpp>
 
 namespace mbgl {
 namespace style {
@@ -43,6 +47,9 @@ void Style::Impl::loadJSON(const std::string& json_) {
     observer->onStyleLoading();
 
     url.clear();
+    styleRequest.reset();
+    parserWorker.reset();
+    mailbox.reset();
     parse(json_);
 }
 
@@ -53,6 +60,12 @@ void Style::Impl::loadURL(const std::string& url_) {
     loaded = false;
     url = url_;
 
+    // Large styles take a while to parse, which happens on a background thread rather than
+    // blocking this one.
+    parserWorker.reset();
+    mailbox = std::make_shared<Mailbox>(*Scheduler::GetCurrent());
+    parserWorker = std::make_unique<Actor<ParserWorker>>(Scheduler::GetBackground(), ActorRef<Style::Impl>(*this, mailbox));
+
     styleRequest = fileSource.request(Resource::style(url), [this](Response res) {
         // Don't allow a loaded, mutated style to be overwritten with a new version.
         if (mutated && loaded) {
@@ -67,7 +80,7 @@ void Style::Impl::loadURL(const std::string& url_) {
         } else if (res.notModified || res.noContent) {
             return;
         } else {
-            parse(*res.data);
+            parserWorker->self().invoke(&ParserWorker::parse, res.data);
         }
     });
 }
@@ -76,25 +89,64 @@ void Style::Impl::parse(const std::string& json_) {
     Parser parser;
 
     if (auto error = parser.parse(json_)) {
-        std::string message = "Failed to parse style: " + util::toString(error);
-        Log::Error(Event::ParseStyle, message.c_str());
-        observer->onStyleError(std::make_exception_ptr(util::StyleParseException(message)));
-        observer->onResourceError(error);
+        onParseError(error);
+        return;
+    }
+
+    load(json_, parser);
+}
+
+void Style::Impl::onParsed(std::shared_ptr<const std::string> json_, std::unique_ptr<Parser> parser) {
+    // Don't allow a style that was loaded and mutated while parsing to be overwritten.
+    if (mutated && loaded) {
         return;
     }
 
+    load(*json_, *parser);
+}
+
+void Style::Impl::onParseError(std::exception_ptr error) {
+    std::string message = "Failed to parse style: " + util::toString(error);
+    Log::Error(Event::ParseStyle, message.c_str());
+    observer->onStyleError(std::make_exception_ptr(util::StyleParseException(message)));
+    observer->onResourceError(error);
+}
+
+void Style::Impl::load(const std::string& json_, Parser& parser) {
+
+    // A style that wasn't changed through the API still matches the JSON it was parsed from, so
+    // the sources and sprite it has in common with the new JSON can be kept as they are. Unchanged
+    // layers come out of the parser sharing their implementation with the current ones, which lets
+    // the renderer keep their tiles.
+    const bool incremental = !mutated && !json.empty();
+
     mutated = false;
     loaded = false;
     json = json_;
 
-    sources.clear();
     layers.clear();
-    images.clear();
+
+    if (incremental) {
+        for (Source* source : sources.getWrappers()) {
+            const std::string id = source->getID();
+            const auto previous = sourceDefinitions.find(id);
+            const auto next = parser.sourceDefinitions.find(id);
+            if (previous == sourceDefinitions.end() || next == parser.sourceDefinitions.end() ||
+                previous->second != next->second) {
+                sources.remove(id);
+            }
+        }
+    } else {
+        sources.clear();
+    }
+    sourceDefinitions = std::move(parser.sourceDefinitions);
 
     transitionOptions = parser.transition;
 
     for (auto& source : parser.sources) {
-        addSource(std::move(source));
+        if (!sources.get(source->getID())) {
+            addSource(std::move(source));
+        }
     }
 
     for (auto& layer : parser.layers) {
@@ -109,8 +161,22 @@ void Style::Impl::parse(const std::string& json_) {
 
     setLight(std::make_unique<Light>(parser.light));
 
-    spriteLoaded = false;
-    spriteLoader->load(parser.spriteURL, fileSource);
+    if (!incremental || parser.spriteURL != spriteURL) {
+        images.clear();
+        spriteImageIDs.clear();
+        spriteURL = parser.spriteURL;
+        spriteLoaded = false;
+        spriteLoader->load(spriteURL, fileSource);
+    } else {
+        // Images added alongside the previous style, such as annotation images, are added
+        // anew for this one.
+        for (Image* image : images.getWrappers()) {
+            const std::string id = image->getID();
+            if (!spriteImageIDs.count(id)) {
+                images.remove(id);
+            }
+        }
+    }
     glyphURL = parser.glyphURL;
 
     loaded = true;
@@ -251,12 +317,14 @@ bool Style::Impl::isLoaded() const {
 }
 
 void Style::Impl::addImage(std::unique_ptr<style::Image> image) {
+    spriteImageIDs.erase(image->getID());
     images.remove(image->getID()); // We permit using addImage to update.
     images.add(std::move(image));
     observer->onUpdate();
 }
 
 void Style::Impl::removeImage(const std::string& id) {
+    spriteImageIDs.erase(id);
     images.remove(id);
 }
 
@@ -298,7 +366,9 @@ void Style::Impl::onSourceDescriptionChanged(Source& source) {
 
 void Style::Impl::onSpriteLoaded(std::vector<std::unique_ptr<Image>>&& images_) {
     for (auto& image : images_) {
+        const std::string id = image->getID();
         addImage(std::move(image));
+        spriteImageIDs.insert(id);
     }
     spriteLoaded = true;
     observer->onUpdate(); // For *-pattern properties.
@@ -22,15 +22,21 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace mbgl {
 
 class FileSource;
 class AsyncRequest;
 class SpriteLoader;
+class Mailbox;
+template <class> class Actor;
 
 namespace style {
 
+class Parser;
+class ParserWorker;
+
 class Style::Impl : public SpriteLoaderObserver,
                     public SourceObserver,
                     public LayerObserver,
@@ -96,6 +102,12 @@ public:
 
 private:
     void parse(const std::string&);
+    void load(const std::string& json, Parser&);
+
+    // Invoked by ParserWorker
+    friend class ParserWorker;
+    void onParsed(std::shared_ptr<const std::string> json, std::unique_ptr<Parser>);
+    void onParseError(std::exception_ptr);
 
     FileSource& fileSource;
 
@@ -105,9 +117,14 @@ private:
     std::unique_ptr<AsyncRequest> styleRequest;
     std::unique_ptr<SpriteLoader> spriteLoader;
 
+    std::string spriteURL;
     std::string glyphURL;
     Collection<style::Image> images;
+    // The images that came from the sprite, which an incremental reload keeps.
+    std::unordered_set<std::string> spriteImageIDs;
     Collection<Source> sources;
+    // The JSON definitions of the sources the style was parsed with, by source ID.
+    std::unordered_map<std::string, std::string> sourceDefinitions;
     Collection<Layer> layers;
     TransitionOptions transitionOptions;
     std::unique_ptr<Light> light;
@@ -136,6 +153,11 @@ private:
     Observer* observer = &nullObserver;
 
     std::exception_ptr lastError;
+
+    // Parses styles loaded from a URL. Replaced on every load, which drops the results of the
+    // previous one.
+    std::shared_ptr<Mailbox> mailbox;
+    std::unique_ptr<Actor<ParserWorker>> parserWorker;
 };
 
 } // namespace style
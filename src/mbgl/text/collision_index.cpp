@@ -91,7 +91,7 @@ std::pair<bool,bool> CollisionIndex::placeFeature(CollisionFeature& feature,
                                       const bool pitchWithMap,
                                       const bool collisionDebug,
                                       const optional<CollisionTileBoundaries>& avoidEdges,
-                                      const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate) {
+                                      const optional<CollisionGroupPredicate>& collisionGroupPredicate) {
     if (!feature.alongLine) {
         CollisionBox& box = feature.boxes.front();
         const auto projectedPoint = projectAndGetPerspectiveRatio(posMatrix, box.anchor);
@@ -104,7 +104,7 @@ std::pair<bool,bool> CollisionIndex::placeFeature(CollisionFeature& feature,
 
         if ((avoidEdges && !isInsideTile(box, *avoidEdges)) ||
             !isInsideGrid(box) ||
-            (!allowOverlap && collisionGrid.hitTest({{ box.px1, box.py1 }, { box.px2, box.py2 }}, collisionGroupPredicate))) {
+            (!allowOverlap && hitTest(CollisionGrid::BBox {{ box.px1, box.py1 }, { box.px2, box.py2 }}, collisionGroupPredicate))) {
             return { false, false };
         }
 
@@ -125,7 +125,7 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
                                       const bool pitchWithMap,
                                       const bool collisionDebug,
                                       const optional<CollisionTileBoundaries>& avoidEdges,
-                                      const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate) {
+                                      const optional<CollisionGroupPredicate>& collisionGroupPredicate) {
 
     const auto tileUnitAnchorPoint = symbol.anchorPoint;
     const auto projectedAnchor = projectAnchor(posMatrix, tileUnitAnchorPoint);
@@ -136,6 +136,7 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
 
     const auto labelPlaneAnchorPoint = project(tileUnitAnchorPoint, labelPlaneMatrix).first;
 
+    resetProjectionCache(projectionCache, symbol);
     const auto firstAndLastGlyph = placeFirstAndLastGlyph(
         fontScale,
         lineOffsetX,
@@ -145,7 +146,8 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
         tileUnitAnchorPoint,
         symbol,
         labelPlaneMatrix,
-        /*return tile distance*/ true);
+        /*return tile distance*/ true,
+        projectionCache);
 
     bool collisionDetected = false;
     bool inGrid = false;
@@ -225,7 +227,7 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
         inGrid |= isInsideGrid(circle);
 
         if ((avoidEdges && !isInsideTile(circle, *avoidEdges)) ||
-            (!allowOverlap && collisionGrid.hitTest({{circle.px, circle.py}, circle.radius}, collisionGroupPredicate))) {
+            (!allowOverlap && hitTest(CollisionGrid::BCircle {{ circle.px, circle.py }, circle.radius}, collisionGroupPredicate))) {
             if (!collisionDebug) {
                 return {false, false};
             } else {
@@ -240,6 +242,12 @@ std::pair<bool,bool> CollisionIndex::placeLineFeature(CollisionFeature& feature,
 }
 
 
+template <class Geometry>
+bool CollisionIndex::hitTest(const Geometry& geometry, const optional<CollisionGroupPredicate>& collisionGroupPredicate) const {
+    return collisionGroupPredicate ? collisionGrid.hitTest(geometry, *collisionGroupPredicate)
+                                   : collisionGrid.hitTest(geometry);
+}
+
 void CollisionIndex::insertFeature(CollisionFeature& feature, bool ignorePlacement, uint32_t bucketInstanceId, uint16_t collisionGroupId) {
     if (feature.alongLine) {
         for (auto& circle : feature.boxes) {
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/layout/symbol_projection.hpp>
 #include <mbgl/text/collision_feature.hpp>
 #include <mbgl/util/grid_index.hpp>
 #include <mbgl/util/optional.hpp>
@@ -11,11 +12,23 @@
 namespace mbgl {
 
 class PlacedSymbol;
-
-struct TileDistance;
     
 using CollisionTileBoundaries = std::array<float,4>;
 
+// Matches the features of one collision group. A concrete type rather than a std::function, so
+// that the grid can inline it into its cell walk.
+class CollisionGroupPredicate {
+public:
+    explicit CollisionGroupPredicate(uint16_t groupID_) : groupID(groupID_) {}
+
+    bool operator()(const IndexedSubfeature& feature) const {
+        return feature.collisionGroupId == groupID;
+    }
+
+private:
+    uint16_t groupID;
+};
+
 class CollisionIndex {
 public:
     using CollisionGrid = GridIndex<IndexedSubfeature>;
@@ -34,7 +47,7 @@ public:
                                       const bool pitchWithMap,
                                       const bool collisionDebug,
                                       const optional<CollisionTileBoundaries>& avoidEdges,
-                                      const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate);
+                                      const optional<CollisionGroupPredicate>& collisionGroupPredicate);
 
     void insertFeature(CollisionFeature& feature, bool ignorePlacement, uint32_t bucketInstanceId, uint16_t collisionGroupId);
 
@@ -60,8 +73,11 @@ private:
                                   const bool pitchWithMap,
                                   const bool collisionDebug,
                                   const optional<CollisionTileBoundaries>& avoidEdges,
-                                  const optional<std::function<bool(const IndexedSubfeature&)>> collisionGroupPredicate);
+                                  const optional<CollisionGroupPredicate>& collisionGroupPredicate);
     
+    template <class Geometry>
+    bool hitTest(const Geometry&, const optional<CollisionGroupPredicate>&) const;
+
     float approximateTileDistance(const TileDistance& tileDistance, const float lastSegmentAngle, const float pixelsToTileUnits, const float cameraToAnchorDistance, const bool pitchWithMap);
     
     std::pair<float,float> projectAnchor(const mat4& posMatrix, const Point<float>& point) const;
@@ -79,6 +95,10 @@ private:
     const float gridBottomBoundary;
     
     const float pitchFactor;
+
+    // Line vertex projections of the symbol being placed. Kept across calls so that
+    // placing a line label doesn't allocate once the cache has grown large enough.
+    ProjectionCache projectionCache;
 };
 
 } // namespace mbgl
@@ -46,9 +46,7 @@ const CollisionGroups::CollisionGroup& CollisionGroups::get(const std::string& s
             uint16_t nextGroupID = ++maxGroupID;
             collisionGroups.emplace(sourceID, CollisionGroup(
                 nextGroupID,
-                optional<Predicate>([nextGroupID](const IndexedSubfeature& feature) -> bool {
-                    return feature.collisionGroupId == nextGroupID;
-                })
+                optional<CollisionGroupPredicate>(CollisionGroupPredicate(nextGroupID))
             ));
         }
         return collisionGroups[sourceID];
@@ -58,11 +56,12 @@ const CollisionGroups::CollisionGroup& CollisionGroups::get(const std::string& s
     }
 }
 
-Placement::Placement(const TransformState& state_, MapMode mapMode_, style::TransitionOptions transitionOptions_, const bool crossSourceCollisions, std::unique_ptr<Placement> prevPlacement_)
+Placement::Placement(const TransformState& state_, MapMode mapMode_, style::TransitionOptions transitionOptions_, const bool crossSourceCollisions_, std::shared_ptr<Placement> prevPlacement_)
     : collisionIndex(state_)
     , mapMode(mapMode_)
     , transitionOptions(std::move(transitionOptions_))
-    , collisionGroups(crossSourceCollisions)
+    , crossSourceCollisions(crossSourceCollisions_)
+    , collisionGroups(crossSourceCollisions_)
     , prevPlacement(std::move(prevPlacement_))
 {
     if (prevPlacement) {
@@ -73,17 +72,26 @@ Placement::Placement(const TransformState& state_, MapMode mapMode_, style::Tran
 void Placement::placeLayer(const RenderLayer& layer, const mat4& projMatrix, bool showCollisionBoxes) {
     std::set<uint32_t> seenCrossTileIDs;
     for (const auto& item : layer.getPlacementData()) {
-        Bucket& bucket = item.bucket;
-        BucketPlacementParameters params{
-                item.tile,
-                projMatrix,
-                layer.baseImpl->source,
-                item.featureIndex,
-                showCollisionBoxes};
-        bucket.place(*this, params, seenCrossTileIDs);
+        placeLayerBucket(layer, item, projMatrix, showCollisionBoxes, seenCrossTileIDs);
     }
 }
 
+void Placement::placeLayerBucket(
+        const RenderLayer& layer,
+        const LayerPlacementData& item,
+        const mat4& projMatrix,
+        bool showCollisionBoxes,
+        std::set<uint32_t>& seenCrossTileIDs) {
+    Bucket& bucket = item.bucket;
+    BucketPlacementParameters params{
+            item.tile,
+            projMatrix,
+            layer.baseImpl->source,
+            item.featureIndex,
+            showCollisionBoxes};
+    bucket.place(*this, params, seenCrossTileIDs);
+}
+
 namespace {
 Point<float> calculateVariableLayoutOffset(style::SymbolAnchorType anchor, float width, float height, float radialOffset, float textBoxScale) {
     AnchorAlignment alignment = AnchorAlignment::getAnchorAlignment(anchor);
@@ -713,14 +721,119 @@ bool Placement::stillRecent(TimePoint now) const {
         commitTime + std::max(util::DEFAULT_TRANSITION_DURATION, transitionOptions.duration.value_or(util::DEFAULT_TRANSITION_DURATION)) > now;
 }
 
-void Placement::setStale() {
-    stale = true;
+void Placement::setStale(bool stale_) {
+    stale = stale_;
+}
+
+bool Placement::hasSameLayers(const Layers& layers) const {
+    if (layers.size() != layerIDs.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < layers.size(); ++i) {
+        if (layers[i].get().getID() != layerIDs[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Placement::hasSameOptions(const style::TransitionOptions& transitionOptions_, bool crossSourceCollisions_,
+                               bool showCollisionBoxes) const {
+    // Whether symbols of different sources collide decides what is placed, and the transition
+    // options decide how placed symbols fade in and out.
+    return showCollisionBoxes == placedCollisionBoxes && crossSourceCollisions_ == crossSourceCollisions &&
+           transitionOptions_.enablePlacementTransitions == transitionOptions.enablePlacementTransitions &&
+           transitionOptions_.duration == transitionOptions.duration;
+}
+
+bool Placement::canBeReused(const TransformState& state, const style::TransitionOptions& transitionOptions_,
+                            bool crossSourceCollisions_, const Layers& layers, bool showCollisionBoxes) const {
+    const TransformState& placedState = collisionIndex.getTransformState();
+    if (mapMode != MapMode::Continuous || state.getSize() != placedState.getSize() || !hasSameLayers(layers) ||
+        !hasSameOptions(transitionOptions_, crossSourceCollisions_, showCollisionBoxes)) {
+        return false;
+    }
+
+    // Panning moves all symbols alike, while zooming, rotating and pitching move
+    // them the most at the edges of the viewport.
+    const double width = state.getSize().width;
+    const double height = state.getSize().height;
+    for (const ScreenCoordinate& point : { ScreenCoordinate { width / 2, height / 2 },
+                                           ScreenCoordinate { 0, 0 }, ScreenCoordinate { width, 0 },
+                                           ScreenCoordinate { 0, height }, ScreenCoordinate { width, height } }) {
+        const ScreenCoordinate placedPoint = placedState.latLngToScreenCoordinate(state.screenCoordinateToLatLng(point));
+        if (util::dist<double>(point, placedPoint) > util::SYMBOL_PLACEMENT_REUSE_TOLERANCE) {
+            return false;
+        }
+    }
+    return true;
 }
 
 const CollisionIndex& Placement::getCollisionIndex() const {
     return collisionIndex;
 }
     
+PauseablePlacement::PauseablePlacement(const TransformState& state,
+                                       MapMode mapMode,
+                                       style::TransitionOptions transitionOptions,
+                                       const bool crossSourceCollisions,
+                                       std::shared_ptr<Placement> prevPlacement,
+                                       const Layers& layers,
+                                       const mat4& projMatrix_,
+                                       bool showCollisionBoxes)
+    : placement(std::make_shared<Placement>(state, mapMode, std::move(transitionOptions), crossSourceCollisions, std::move(prevPlacement)))
+    , projMatrix(projMatrix_) {
+    placement->layerIDs.reserve(layers.size());
+    for (const RenderLayer& layer : layers) {
+        placement->layerIDs.push_back(layer.getID());
+    }
+    placement->placedCollisionBoxes = showCollisionBoxes;
+}
+
+bool PauseablePlacement::canContinue(const style::TransitionOptions& transitionOptions, bool crossSourceCollisions,
+                                     const Layers& layers, bool showCollisionBoxes) const {
+    return placement->hasSameLayers(layers) &&
+           placement->hasSameOptions(transitionOptions, crossSourceCollisions, showCollisionBoxes);
+}
+
+void PauseablePlacement::continuePlacement(const Layers& layers, optional<TimePoint> deadline) {
+    assert(!done);
+    assert(placement->hasSameLayers(layers));
+    // Always place at least one bucket per call, so that placement finishes
+    // eventually even if a single bucket exceeds the time budget.
+    bool placedAnyBucket = false;
+
+    // Layers are placed in the reverse of their render order, starting from the top-most one.
+    for (; currentLayerIndex < layers.size(); ++currentLayerIndex) {
+        const RenderLayer& layer = layers[layers.size() - 1 - currentLayerIndex];
+        const TimePoint layerStart = Clock::now();
+        for (const auto& item : layer.getPlacementData()) {
+            const OverscaledTileID& tileID = item.tile.get().getOverscaledTileID();
+            if (placedTiles.count(tileID)) {
+                continue;
+            }
+            if (deadline && placedAnyBucket && Clock::now() >= *deadline) {
+                layerPlacementTimes[layer.getID()] += Clock::now() - layerStart;
+                return;
+            }
+            placement->placeLayerBucket(layer, item, projMatrix, placement->placedCollisionBoxes, seenCrossTileIDs);
+            placedTiles.insert(tileID);
+            placedAnyBucket = true;
+        }
+        layerPlacementTimes[layer.getID()] += Clock::now() - layerStart;
+        placedTiles.clear();
+        seenCrossTileIDs.clear();
+    }
+
+    done = true;
+}
+
+std::shared_ptr<Placement> PauseablePlacement::commit(TimePoint now) {
+    assert(done);
+    placement->commit(now);
+    return std::move(placement);
+}
+
 const RetainedQueryData& Placement::getQueryData(uint32_t bucketInstanceId) const {
     auto it = retainedQueryData.find(bucketInstanceId);
     if (it == retainedQueryData.end()) {
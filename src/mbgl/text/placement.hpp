@@ -7,11 +7,18 @@
 #include <mbgl/layout/symbol_projection.hpp>
 #include <mbgl/style/transition_options.hpp>
 #include <unordered_set>
+#include <functional>
+#include <map>
+#include <set>
+#include <vector>
 
 namespace mbgl {
 
+class Bucket;
 class SymbolBucket;
 class SymbolInstance;
+class RenderLayer;
+class LayerPlacementData;
 
 class OpacityState {
 public:
@@ -72,8 +79,7 @@ struct RetainedQueryData {
     
 class CollisionGroups {
 public:
-    using Predicate = std::function<bool(const IndexedSubfeature&)>;
-    using CollisionGroup = std::pair<uint16_t, optional<Predicate>>;
+    using CollisionGroup = std::pair<uint16_t, optional<CollisionGroupPredicate>>;
     
     CollisionGroups(const bool crossSourceCollisions_)
         : maxGroupID(0)
@@ -99,7 +105,9 @@ public:
     
 class Placement {
 public:
-    Placement(const TransformState&, MapMode, style::TransitionOptions, const bool crossSourceCollisions, std::unique_ptr<Placement> prevPlacementOrNull = nullptr);
+    using Layers = std::vector<std::reference_wrapper<RenderLayer>>;
+
+    Placement(const TransformState&, MapMode, style::TransitionOptions, const bool crossSourceCollisions, std::shared_ptr<Placement> prevPlacementOrNull = nullptr);
     void placeLayer(const RenderLayer&, const mat4&, bool showCollisionBoxes);
     void commit(TimePoint);
     void updateLayerBuckets(const RenderLayer&, const TransformState&,  bool updateOpacities);
@@ -110,11 +118,29 @@ public:
 
     bool stillRecent(TimePoint now) const;
     void setRecent(TimePoint now);
-    void setStale();
+    void setStale(bool stale_ = true);
+
+    // Returns `true` if symbols were placed for the given layers, in the same order.
+    bool hasSameLayers(const Layers&) const;
+    // Returns `true` if this placement is still valid for the given view and options, so that placing
+    // the same layers and buckets again would be wasted work: the options are the same, the viewport
+    // has the same size, and no point in it moved by more than SYMBOL_PLACEMENT_REUSE_TOLERANCE since
+    // symbols were placed.
+    bool canBeReused(const TransformState&, const style::TransitionOptions&, bool crossSourceCollisions,
+                     const Layers&, bool showCollisionBoxes) const;
+    // Returns `true` if symbols were placed with the given options.
+    bool hasSameOptions(const style::TransitionOptions&, bool crossSourceCollisions, bool showCollisionBoxes) const;
     
     const RetainedQueryData& getQueryData(uint32_t bucketInstanceId) const;
 private:
     friend SymbolBucket;
+    friend class PauseablePlacement;
+    void placeLayerBucket(
+            const RenderLayer&,
+            const LayerPlacementData&,
+            const mat4& projMatrix,
+            bool showCollisionBoxes,
+            std::set<uint32_t>& seenCrossTileIDs);
     void placeBucket(
             SymbolBucket&,
             const BucketPlacementParameters&,
@@ -128,6 +154,7 @@ private:
 
     MapMode mapMode;
     style::TransitionOptions transitionOptions;
+    bool crossSourceCollisions;
 
     TimePoint fadeStartTime;
     TimePoint commitTime;
@@ -137,10 +164,59 @@ private:
     std::unordered_map<uint32_t, VariableOffset> variableOffsets;
 
     bool stale = false;
+
+    // Placed layers, in render order, and whether collision boxes were placed along.
+    std::vector<std::string> layerIDs;
+    bool placedCollisionBoxes = false;
     
     std::unordered_map<uint32_t, RetainedQueryData> retainedQueryData;
     CollisionGroups collisionGroups;
-    std::unique_ptr<Placement> prevPlacement;
+    std::shared_ptr<Placement> prevPlacement;
+};
+
+// Runs a symbol placement that can be spread over several frames. Placement
+// pauses between buckets once the time budget of the current frame is used up,
+// and resumes with the buckets not placed yet on the next call. The previous
+// placement stays committed, and is used for rendering, until this one is done.
+//
+// All buckets are placed for the view and projection placement was started with,
+// even if the camera moved since. Buckets of tiles loaded while placement was
+// paused are placed along, unless their tile was placed already, and tiles
+// unloaded meanwhile are skipped. The next placement catches up with both.
+class PauseablePlacement {
+public:
+    using Layers = Placement::Layers;
+
+    PauseablePlacement(const TransformState&, MapMode, style::TransitionOptions, const bool crossSourceCollisions,
+                       std::shared_ptr<Placement> prevPlacement, const Layers&, const mat4& projMatrix, bool showCollisionBoxes);
+
+    // Places the given layers, starting from the top-most one, until all of them
+    // are placed or the deadline has passed. Without a deadline, placement is never paused.
+    void continuePlacement(const Layers&, optional<TimePoint> deadline);
+
+    bool isDone() const { return done; }
+    // Returns `true` if placement may be continued: it was started for the same layers,
+    // in the same order, and with the same options.
+    bool canContinue(const style::TransitionOptions&, bool crossSourceCollisions,
+                     const Layers&, bool showCollisionBoxes) const;
+
+    // Commits the finished placement and hands it over to the caller.
+    std::shared_ptr<Placement> commit(TimePoint now);
+
+    // Accumulated time spent placing each layer, across all frames this placement took.
+    const std::map<std::string, Duration>& getLayerPlacementTimes() const { return layerPlacementTimes; }
+
+private:
+    std::shared_ptr<Placement> placement;
+    const mat4 projMatrix;
+
+    std::size_t currentLayerIndex = 0;
+    // Tiles of the current layer whose bucket was placed already. Placement data is
+    // collected anew for every frame, so buckets are kept track of by tile.
+    std::set<OverscaledTileID> placedTiles;
+    std::set<uint32_t> seenCrossTileIDs;
+    std::map<std::string, Duration> layerPlacementTimes;
+    bool done = false;
 };
 
 } // namespace mbgl
@@ -6,8 +6,8 @@
 #include <mbgl/text/bidi.hpp>
 
 #include <algorithm>
-#include <list>
 #include <cmath>
+#include <limits>
 
 namespace {
     // Zero width space that is used to suggest break points for Japanese labels.
@@ -189,45 +189,70 @@ float calculatePenalty(char16_t codePoint, char16_t nextCodePoint, bool penaliza
     return penalty;
 }
 
+constexpr std::size_t noPriorBreak = std::numeric_limits<std::size_t>::max();
+
 struct PotentialBreak {
-    PotentialBreak(const std::size_t p_index, const float p_x, const PotentialBreak* p_priorBreak, const float p_badness)
-    : index(p_index), x(p_x), priorBreak(p_priorBreak), badness(p_badness)
-    {}
-    
-    const std::size_t index;
-    const float x;
-    const PotentialBreak* priorBreak;
-    const float badness;
+    std::size_t index;
+    float x;
+    // Position of the best prior break in the list of potential breaks, or noPriorBreak if the
+    // line is best started at the beginning of the text.
+    std::size_t priorBreak;
+    float badness;
 };
 
+/*
+    Potential breaks are kept in a flat vector, of which only a suffix is evaluated as prior breaks.
+
+    The badness of breaking at x after a prior break p is (x - p.x - targetWidth)² + p.badness,
+    up to a term that is the same for all prior breaks. For two prior breaks p < q, the difference
+    of their badnesses grows with x. So once q is at least as good as p for some break, it remains
+    so for all later breaks, and ties are resolved in favor of the later break anyway. Therefore
+    all breaks before the best prior break of a break can be skipped from then on, which keeps
+    evaluation linear in the number of breaks that fit about a line, instead of quadratic in the
+    length of the text. This relies on x never decreasing, i.e. on non-negative letter spacing.
+
+    The last break uses a different badness, so it is evaluated against all potential breaks.
+*/
+struct PotentialBreaks {
+    std::vector<PotentialBreak> breaks;
+    // The first of the potential breaks that may still be the best prior break of a later break.
+    std::size_t firstCandidate = 0;
+    // Whether starting the line at the beginning of the text may still be best.
+    bool startIsCandidate = true;
+};
 
-PotentialBreak evaluateBreak(const std::size_t breakIndex, const float breakX, const float targetWidth, const std::list<PotentialBreak>& potentialBreaks, const float penalty, const bool isLastBreak) {
+PotentialBreak evaluateBreak(const std::size_t breakIndex, const float breakX, const float targetWidth,
+                             const std::vector<PotentialBreak>& potentialBreaks, const std::size_t firstCandidate,
+                             const bool startIsCandidate, const float penalty, const bool isLastBreak) {
     // We could skip evaluating breaks where the line length (breakX - priorBreak.x) > maxWidth
     //  ...but in fact we allow lines longer than maxWidth (if there's no break points)
     //  ...and when targetWidth and maxWidth are close, strictly enforcing maxWidth can give
     //     more lopsided results.
     
-    const PotentialBreak* bestPriorBreak = nullptr;
-    float bestBreakBadness = calculateBadness(breakX, targetWidth, penalty, isLastBreak);
-    for (const auto& potentialBreak : potentialBreaks) {
+    std::size_t bestPriorBreak = noPriorBreak;
+    float bestBreakBadness = startIsCandidate ? calculateBadness(breakX, targetWidth, penalty, isLastBreak)
+                                              : std::numeric_limits<float>::infinity();
+    for (std::size_t i = firstCandidate; i < potentialBreaks.size(); ++i) {
+        const PotentialBreak& potentialBreak = potentialBreaks[i];
         const float lineWidth = breakX - potentialBreak.x;
         float breakBadness =
         calculateBadness(lineWidth, targetWidth, penalty, isLastBreak) + potentialBreak.badness;
         if (breakBadness <= bestBreakBadness) {
-            bestPriorBreak = &potentialBreak;
+            bestPriorBreak = i;
             bestBreakBadness = breakBadness;
         }
     }
     
-    return PotentialBreak(breakIndex, breakX, bestPriorBreak, bestBreakBadness);
+    return PotentialBreak { breakIndex, breakX, bestPriorBreak, bestBreakBadness };
 }
 
-std::set<std::size_t> leastBadBreaks(const PotentialBreak& lastLineBreak) {
+std::set<std::size_t> leastBadBreaks(const PotentialBreak& lastLineBreak, const std::vector<PotentialBreak>& potentialBreaks) {
     std::set<std::size_t> leastBadBreaks = { lastLineBreak.index };
-    const PotentialBreak* priorBreak = lastLineBreak.priorBreak;
-    while (priorBreak) {
-        leastBadBreaks.insert(priorBreak->index);
-        priorBreak = priorBreak->priorBreak;
+    std::size_t priorBreak = lastLineBreak.priorBreak;
+    while (priorBreak != noPriorBreak) {
+        // Prior breaks come in decreasing order.
+        leastBadBreaks.insert(leastBadBreaks.begin(), potentialBreaks[priorBreak].index);
+        priorBreak = potentialBreaks[priorBreak].priorBreak;
     }
     return leastBadBreaks;
 }
@@ -250,7 +275,9 @@ std::set<std::size_t> determineLineBreaks(const TaggedString& logicalInput,
     
     const float targetWidth = determineAverageLineWidth(logicalInput, spacing, maxWidth, glyphMap);
     
-    std::list<PotentialBreak> potentialBreaks;
+    PotentialBreaks potentialBreaks;
+    potentialBreaks.breaks.reserve(logicalInput.length());
+    const bool skipDominatedBreaks = spacing >= 0;
     float currentX = 0;
     // Find first occurance of zero width space (ZWSP) character.
     const bool hasServerSuggestedBreaks = logicalInput.rawText().find_first_of(ZWSP) !=  std::string::npos;
@@ -274,14 +301,21 @@ std::set<std::size_t> determineLineBreaks(const TaggedString& logicalInput,
             if (allowsIdeographicBreak || util::i18n::allowsWordBreaking(codePoint)) {
                 const bool penalizableIdeographicBreak = allowsIdeographicBreak && hasServerSuggestedBreaks;
                 const std::size_t nextIndex = i + 1;
-                potentialBreaks.push_back(evaluateBreak(nextIndex, currentX, targetWidth, potentialBreaks,
-                                                        calculatePenalty(codePoint, logicalInput.getCharCodeAt(nextIndex), penalizableIdeographicBreak),
-                                                        false));
+                const PotentialBreak potentialBreak = evaluateBreak(nextIndex, currentX, targetWidth, potentialBreaks.breaks,
+                                                                    potentialBreaks.firstCandidate, potentialBreaks.startIsCandidate,
+                                                                    calculatePenalty(codePoint, logicalInput.getCharCodeAt(nextIndex), penalizableIdeographicBreak),
+                                                                    false);
+                if (skipDominatedBreaks && potentialBreak.priorBreak != noPriorBreak) {
+                    potentialBreaks.firstCandidate = potentialBreak.priorBreak;
+                    potentialBreaks.startIsCandidate = false;
+                }
+                potentialBreaks.breaks.push_back(potentialBreak);
             }
         }
     }
     
-    return leastBadBreaks(evaluateBreak(logicalInput.length(), currentX, targetWidth, potentialBreaks, 0, true));
+    const PotentialBreak lastBreak = evaluateBreak(logicalInput.length(), currentX, targetWidth, potentialBreaks.breaks, 0, true, 0, true);
+    return leastBadBreaks(lastBreak, potentialBreaks.breaks);
 }
 
 void shapeLines(Shaping& shaping,
@@ -0,0 +1,152 @@
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/util/hash.hpp>
+
+#include <algorithm>
+#include <tuple>
+
+namespace mbgl {
+
+namespace {
+
+optional<GlyphMetrics> findMetrics(const GlyphMap& glyphMap, FontStackHash font, GlyphID id) {
+    const auto glyphs = glyphMap.find(font);
+    if (glyphs == glyphMap.end()) {
+        return {};
+    }
+    const auto it = glyphs->second.find(id);
+    if (it == glyphs->second.end() || !it->second) {
+        return {};
+    }
+    return (*it->second)->metrics;
+}
+
+} // namespace
+
+bool ShapingCache::Key::operator==(const Key& other) const {
+    return std::tie(text, sectionIndices, sections, maxWidth, lineHeight, textAnchor, textJustify, spacing, translate, writingMode) ==
+           std::tie(other.text, other.sectionIndices, other.sections, other.maxWidth, other.lineHeight, other.textAnchor,
+                    other.textJustify, other.spacing, other.translate, other.writingMode);
+}
+
+std::size_t ShapingCache::KeyHash::operator()(const Key& key) const {
+    std::size_t seed = util::hash(key.text, key.maxWidth, key.lineHeight, static_cast<uint8_t>(key.textAnchor),
+                                  static_cast<uint8_t>(key.textJustify), key.spacing, key.translate.x, key.translate.y,
+                                  static_cast<uint8_t>(key.writingMode));
+    // Section indices are left out: texts with several sections are rare, and compared in full anyway.
+    for (const auto& section : key.sections) {
+        util::hash_combine(seed, section.first);
+        util::hash_combine(seed, section.second);
+    }
+    return seed;
+}
+
+ShapingCache::ShapingCache(std::size_t maxSize_)
+    : maxSize(maxSize_) {
+}
+
+ShapingCache& ShapingCache::shared() {
+    static ShapingCache cache(4096);
+    return cache;
+}
+
+Shaping ShapingCache::getShaping(const TaggedString& string,
+                                 const float maxWidth,
+                                 const float lineHeight,
+                                 const style::SymbolAnchorType textAnchor,
+                                 const style::TextJustifyType textJustify,
+                                 const float spacing,
+                                 const Point<float>& translate,
+                                 const WritingModeType writingMode,
+                                 BiDi& bidi,
+                                 const GlyphMap& glyphMap) {
+    Key key { string.rawText(), string.getStyledText().second, {}, maxWidth, lineHeight,
+              textAnchor, textJustify, spacing, translate, writingMode };
+    key.sections.reserve(string.sectionCount());
+    for (const auto& section : string.getSections()) {
+        key.sections.emplace_back(section.fontStackHash, section.scale);
+    }
+
+    if (std::shared_ptr<const Entry> entry = find(key)) {
+        if (hasGlyphs(*entry, glyphMap)) {
+            return entry->shaping;
+        }
+    }
+
+    auto entry = std::make_shared<Entry>();
+    entry->shaping = mbgl::getShaping(string, maxWidth, lineHeight, textAnchor, textJustify, spacing,
+                                      translate, writingMode, bidi, glyphMap);
+    entry->glyphs = glyphDependencies(string, glyphMap);
+    Shaping shaping = entry->shaping;
+    insert(std::move(key), std::move(entry));
+    return shaping;
+}
+
+std::size_t ShapingCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return slots.size();
+}
+
+void ShapingCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    slots.clear();
+    recent.clear();
+}
+
+std::vector<ShapingCache::GlyphDependency> ShapingCache::glyphDependencies(const TaggedString& string, const GlyphMap& glyphMap) {
+    std::vector<std::pair<FontStackHash, GlyphID>> ids;
+    ids.reserve(string.length());
+    for (std::size_t i = 0; i < string.length(); ++i) {
+        ids.emplace_back(string.getSection(i).fontStackHash, string.getCharCodeAt(i));
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    std::vector<GlyphDependency> dependencies;
+    dependencies.reserve(ids.size());
+    for (const auto& id : ids) {
+        dependencies.push_back({ id.first, id.second, findMetrics(glyphMap, id.first, id.second) });
+    }
+    return dependencies;
+}
+
+bool ShapingCache::hasGlyphs(const Entry& entry, const GlyphMap& glyphMap) {
+    return std::all_of(entry.glyphs.begin(), entry.glyphs.end(), [&](const GlyphDependency& dependency) {
+        return findMetrics(glyphMap, dependency.font, dependency.id) == dependency.metrics;
+    });
+}
+
+std::shared_ptr<const ShapingCache::Entry> ShapingCache::find(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const auto it = slots.find(key);
+    if (it == slots.end()) {
+        return nullptr;
+    }
+    recent.splice(recent.begin(), recent, it->second.position);
+    return it->second.entry;
+}
+
+void ShapingCache::insert(Key key, std::shared_ptr<const Entry> entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (maxSize == 0) {
+        return;
+    }
+
+    const auto it = slots.find(key);
+    if (it != slots.end()) {
+        // Another worker shaped the same text meanwhile, or the glyphs have changed.
+        it->second.entry = std::move(entry);
+        recent.splice(recent.begin(), recent, it->second.position);
+        return;
+    }
+
+    while (slots.size() >= maxSize) {
+        slots.erase(*recent.back());
+        recent.pop_back();
+    }
+
+    const auto inserted = slots.emplace(std::move(key), Slot { std::move(entry), {} }).first;
+    recent.push_front(&inserted->first);
+    inserted->second.position = recent.begin();
+}
+
+} // namespace mbgl
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <mbgl/text/shaping.hpp>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+/*
+    ShapingCache holds the shapings of recently shaped texts. The same label, e.g. a street name
+    crossing a dozen tiles, is shaped again for every tile and zoom level it appears in, so a
+    single cache is shared by all tile workers.
+
+    Shapings are keyed by the text, its sections and the shaping parameters. Since they also
+    depend on glyph metrics, every shaping remembers the metrics of the glyphs it was made with and
+    is reused only as long as the glyph map at hand has the same metrics. Only the metrics are kept,
+    so that the cache doesn't hold on to glyph bitmaps.
+*/
+class ShapingCache {
+public:
+    explicit ShapingCache(std::size_t maxSize);
+
+    // The cache shared by tile workers.
+    static ShapingCache& shared();
+
+    // Same as mbgl::getShaping(), but returns the cached shaping if there is one.
+    Shaping getShaping(const TaggedString&,
+                       float maxWidth,
+                       float lineHeight,
+                       style::SymbolAnchorType,
+                       style::TextJustifyType,
+                       float spacing,
+                       const Point<float>& translate,
+                       WritingModeType,
+                       BiDi&,
+                       const GlyphMap&);
+
+    std::size_t size() const;
+    void clear();
+
+private:
+    struct Key {
+        std::u16string text;
+        std::vector<uint8_t> sectionIndices;
+        std::vector<std::pair<FontStackHash, double>> sections;
+        float maxWidth;
+        float lineHeight;
+        style::SymbolAnchorType textAnchor;
+        style::TextJustifyType textJustify;
+        float spacing;
+        Point<float> translate;
+        WritingModeType writingMode;
+
+        bool operator==(const Key&) const;
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key&) const;
+    };
+
+    struct GlyphDependency {
+        FontStackHash font;
+        GlyphID id;
+        optional<GlyphMetrics> metrics;
+    };
+
+    struct Entry {
+        Shaping shaping;
+        std::vector<GlyphDependency> glyphs;
+    };
+
+    struct Slot {
+        std::shared_ptr<const Entry> entry;
+        std::list<const Key*>::iterator position;
+    };
+
+    static std::vector<GlyphDependency> glyphDependencies(const TaggedString&, const GlyphMap&);
+    static bool hasGlyphs(const Entry&, const GlyphMap&);
+
+    std::shared_ptr<const Entry> find(const Key&);
+    void insert(Key, std::shared_ptr<const Entry>);
+
+    const std::size_t maxSize;
+
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Slot, KeyHash> slots;
+    // Keys of the cached shapings, most recently used first.
+    std::list<const Key*> recent;
+};
+
+} // namespace mbgl
@@ -376,15 +376,32 @@ void GeometryTileWorker::parse() {
             const std::string& sourceLayerID = leaderImpl.sourceLayer;
             std::shared_ptr<Bucket> bucket = LayerManager::get()->createBucket(parameters, group);
 
+            // Features are added to the bucket all at once, so that their data-driven paint
+            // properties are evaluated together.
+            std::vector<std::size_t> indices;
+            std::vector<std::unique_ptr<GeometryTileFeature>> features;
+            std::vector<GeometryCollection> geometries;
             for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
                 std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
 
                 if (!filter(expression::EvaluationContext { static_cast<float>(this->id.overscaledZ), feature.get() }))
                     continue;
 
-                GeometryCollection geometries = feature->getGeometries();
-                bucket->addFeature(*feature, geometries, {}, PatternLayerMap ());
-                featureIndex->insert(geometries, i, sourceLayerID, leaderImpl.id);
+                geometries.push_back(feature->getGeometries());
+                features.push_back(std::move(feature));
+                indices.push_back(i);
+            }
+
+            const PatternLayerMap patterns;
+            std::vector<BucketFeature> bucketFeatures;
+            bucketFeatures.reserve(features.size());
+            for (std::size_t i = 0; i < features.size(); i++) {
+                bucketFeatures.push_back({ *features[i], geometries[i], patterns });
+            }
+            bucket->addFeatures(bucketFeatures, {});
+
+            for (std::size_t i = 0; i < features.size(); i++) {
+                featureIndex->insert(geometries[i], indices[i], sourceLayerID, leaderImpl.id);
             }
 
             if (!bucket->hasData()) {
@@ -120,4 +120,8 @@ void RasterDEMTile::setNecessity(TileNecessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void RasterDEMTile::setRequestRank(uint32_t rank) {
+    loader.setRank(rank);
+}
+
 } // namespace mbgl
@@ -77,4 +77,8 @@ void RasterTile::setNecessity(TileNecessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void RasterTile::setRequestRank(uint32_t rank) {
+    loader.setRank(rank);
+}
+
 } // namespace mbgl
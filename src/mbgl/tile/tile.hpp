@@ -52,6 +52,10 @@ public:
 
     virtual void setNecessity(TileNecessity) {}
 
+    // Orders this tile's resource requests relative to those of other tiles; lower ranks are
+    // loaded first. See Resource::setRank().
+    virtual void setRequestRank(uint32_t) {}
+
     // Mark this tile as no longer needed and cancel any pending work.
     virtual void cancel();
 
@@ -33,6 +33,11 @@ public:
         }
     }
 
+    // Updates the rank of the tile resource, including requests that are already in flight.
+    void setRank(uint32_t rank) {
+        resource.setRank(rank);
+    }
+
 private:
     // called when the tile is one of the ideal tiles that we want to show definitely. the tile source
     // should try to make every effort (e.g. fetch from internet, or revalidate existing resources).
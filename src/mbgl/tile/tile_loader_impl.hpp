@@ -98,6 +98,7 @@ void TileLoader<T>::loadedData(const Response& res) {
         tile.setError(std::make_exception_ptr(std::runtime_error(res.error->message)));
     } else if (res.notModified) {
         resource.priorExpires = res.expires;
+        resource.priorUsable = true;
         // Do not notify the tile; when we get this message, it already has the current
         // version of the data.
         tile.setMetadata(res.modified, res.expires);
@@ -105,6 +106,7 @@ void TileLoader<T>::loadedData(const Response& res) {
         resource.priorModified = res.modified;
         resource.priorExpires = res.expires;
         resource.priorEtag = res.etag;
+        resource.priorUsable = true;
         tile.setMetadata(res.modified, res.expires);
         tile.setData(res.noContent ? nullptr : res.data);
     }
@@ -16,6 +16,10 @@ void VectorTile::setNecessity(TileNecessity necessity) {
     loader.setNecessity(necessity);
 }
 
+void VectorTile::setRequestRank(uint32_t rank) {
+    loader.setRank(rank);
+}
+
 void VectorTile::setMetadata(optional<Timestamp> modified_, optional<Timestamp> expires_) {
     modified = modified_;
     expires = expires_;
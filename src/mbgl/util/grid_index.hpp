@@ -2,12 +2,13 @@
 
 #include <mapbox/geometry/point.hpp>
 #include <mapbox/geometry/box.hpp>
-#include <mbgl/util/optional.hpp>
+#include <mbgl/math/minmax.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstddef>
 #include <vector>
-#include <functional>
 
 namespace mbgl {
 
@@ -67,26 +68,77 @@ public:
     
     std::vector<T> query(const BBox&) const;
     std::vector<std::pair<T,BBox>> queryWithBoxes(const BBox&) const;
-    
-    bool hitTest(const BBox&, optional<std::function<bool(const T&)>> predicate = nullopt) const;
-    bool hitTest(const BCircle&, optional<std::function<bool(const T&)>> predicate = nullopt) const;
-    
+
+    // Returns `true` if the geometry collides with any element, or with any element the predicate
+    // accepts. Predicates are template parameters, so that they are inlined into the cell walk.
+    bool hitTest(const BBox& bbox) const { return hitTest(bbox, AnyElement()); }
+    bool hitTest(const BCircle& circle) const { return hitTest(circle, AnyElement()); }
+    template <class Predicate>
+    bool hitTest(const BBox&, Predicate&&) const;
+    template <class Predicate>
+    bool hitTest(const BCircle&, Predicate&&) const;
+
     bool empty() const;
 
 private:
+    struct AnyElement {
+        bool operator()(const T&) const { return true; }
+    };
+
+    struct CellRange {
+        int16_t x1, y1, x2, y2;
+    };
+
+    // An element registered in a cell. The entries of all cells are kept in one flat array, and
+    // those of a cell are chained in insertion order, so that inserting an element doesn't
+    // allocate per cell and queries read the geometry to test from the entry itself.
+    template <class Geometry>
+    struct CellEntry {
+        Geometry geometry;
+        CellRange range;
+        uint32_t element;
+        int32_t next;
+    };
+
+    // First and last entry of a cell; -1 for empty cells.
+    struct Cell {
+        int32_t first = -1;
+        int32_t last = -1;
+    };
+
     bool noIntersection(const BBox& queryBBox) const;
     bool completeIntersection(const BBox& queryBBox) const;
-    BBox convertToBox(const BCircle& circle) const;
+    static BBox convertToBox(const BCircle& circle);
 
-    void query(const BBox&, std::function<bool (const T&, const BBox&)>) const;
-    void query(const BCircle&, std::function<bool (const T&, const BBox&)>) const;
+    template <class ResultFn>
+    void query(const BBox&, ResultFn&&) const;
+    template <class ResultFn>
+    void query(const BCircle&, ResultFn&&) const;
+    // Calls `resultFn` with the elements registered in the cells of `queryRange`, each one once,
+    // until it returns `true`. Returns whether it did.
+    template <class Geometry, class ResultFn>
+    static bool walkCells(const std::vector<Cell>&, const std::vector<CellEntry<Geometry>>&, const CellRange& queryRange,
+                          int16_t xCellCount, ResultFn&&);
+    template <class Geometry>
+    void addToCells(std::vector<Cell>&, std::vector<CellEntry<Geometry>>&, const Geometry&, const CellRange&, uint32_t element);
+
+    CellRange cellRange(const BBox&) const;
+    CellRange cellRange(const BCircle& bcircle) const { return cellRange(convertToBox(bcircle)); }
+    // Elements are registered in every cell they overlap. While walking the cells of a
+    // query, an element is only visited in the first cell it shares with the query, which
+    // avoids keeping a set of already seen elements for each query.
+    static bool isFirstSharedCell(const CellRange& element, const CellRange& query, int16_t x, int16_t y) {
+        // Cells are visited column by column, so the first shared cell is the top left
+        // corner of the intersection of both ranges.
+        return x == std::max(element.x1, query.x1) && y == std::max(element.y1, query.y1);
+    }
 
     int16_t convertToXCellCoord(const float x) const;
     int16_t convertToYCellCoord(const float y) const;
     
-    bool boxesCollide(const BBox&, const BBox&) const;
-    bool circlesCollide(const BCircle&, const BCircle&) const;
-    bool circleAndBoxCollide(const BCircle&, const BBox&) const;
+    static bool boxesCollide(const BBox&, const BBox&);
+    static bool circlesCollide(const BCircle&, const BCircle&);
+    static bool circleAndBoxCollide(const BCircle&, const BBox&);
 
     const float width;
     const float height;
@@ -99,9 +151,187 @@ private:
     std::vector<std::pair<T, BBox>> boxElements;
     std::vector<std::pair<T, BCircle>> circleElements;
     
-    std::vector<std::vector<size_t>> boxCells;
-    std::vector<std::vector<size_t>> circleCells;
-
+    std::vector<Cell> boxCells;
+    std::vector<Cell> circleCells;
+    std::vector<CellEntry<BBox>> boxEntries;
+    std::vector<CellEntry<BCircle>> circleEntries;
 };
 
+template <class T>
+inline typename GridIndex<T>::BBox GridIndex<T>::convertToBox(const BCircle& circle) {
+    return BBox{{circle.center.x - circle.radius, circle.center.y - circle.radius},
+                {circle.center.x + circle.radius, circle.center.y + circle.radius}};
+}
+
+template <class T>
+inline typename GridIndex<T>::CellRange GridIndex<T>::cellRange(const BBox& bbox) const {
+    return { convertToXCellCoord(bbox.min.x), convertToYCellCoord(bbox.min.y),
+             convertToXCellCoord(bbox.max.x), convertToYCellCoord(bbox.max.y) };
+}
+
+template <class T>
+inline int16_t GridIndex<T>::convertToXCellCoord(const float x) const {
+    return util::max(0.0, util::min(xCellCount - 1.0, std::floor(x * xScale)));
+}
+
+template <class T>
+inline int16_t GridIndex<T>::convertToYCellCoord(const float y) const {
+    return util::max(0.0, util::min(yCellCount - 1.0, std::floor(y * yScale)));
+}
+
+template <class T>
+inline bool GridIndex<T>::noIntersection(const BBox& queryBBox) const {
+    return queryBBox.max.x < 0 || queryBBox.min.x >= width || queryBBox.max.y < 0 || queryBBox.min.y >= height;
+}
+
+template <class T>
+inline bool GridIndex<T>::completeIntersection(const BBox& queryBBox) const {
+    return queryBBox.min.x <= 0 && queryBBox.min.y <= 0 && width <= queryBBox.max.x && height <= queryBBox.max.y;
+}
+
+template <class T>
+inline bool GridIndex<T>::boxesCollide(const BBox& first, const BBox& second) {
+    return first.min.x <= second.max.x &&
+           first.min.y <= second.max.y &&
+           first.max.x >= second.min.x &&
+           first.max.y >= second.min.y;
+}
+
+template <class T>
+inline bool GridIndex<T>::circlesCollide(const BCircle& first, const BCircle& second) {
+    auto dx = second.center.x - first.center.x;
+    auto dy = second.center.y - first.center.y;
+    auto bothRadii = first.radius + second.radius;
+    return (bothRadii * bothRadii) > (dx * dx + dy * dy);
+}
+
+template <class T>
+inline bool GridIndex<T>::circleAndBoxCollide(const BCircle& circle, const BBox& box) {
+    auto halfRectWidth = (box.max.x - box.min.x) / 2;
+    auto distX = std::abs(circle.center.x - (box.min.x + halfRectWidth));
+    if (distX > (halfRectWidth + circle.radius)) {
+        return false;
+    }
+
+    auto halfRectHeight = (box.max.y - box.min.y) / 2;
+    auto distY = std::abs(circle.center.y - (box.min.y + halfRectHeight));
+    if (distY > (halfRectHeight + circle.radius)) {
+        return false;
+    }
+
+    if (distX <= halfRectWidth || distY <= halfRectHeight) {
+        return true;
+    }
+
+    auto dx = distX - halfRectWidth;
+    auto dy = distY - halfRectHeight;
+    return (dx * dx + dy * dy) <= (circle.radius * circle.radius);
+}
+
+template <class T>
+template <class Geometry, class ResultFn>
+bool GridIndex<T>::walkCells(const std::vector<Cell>& cells, const std::vector<CellEntry<Geometry>>& entries,
+                             const CellRange& queryRange, int16_t xCellCount, ResultFn&& resultFn) {
+    for (int16_t x = queryRange.x1; x <= queryRange.x2; ++x) {
+        for (int16_t y = queryRange.y1; y <= queryRange.y2; ++y) {
+            for (int32_t i = cells[int32_t(xCellCount) * y + x].first; i != -1; i = entries[i].next) {
+                const CellEntry<Geometry>& entry = entries[i];
+                if (isFirstSharedCell(entry.range, queryRange, x, y) && resultFn(entry)) {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+template <class T>
+template <class ResultFn>
+void GridIndex<T>::query(const BBox& queryBBox, ResultFn&& resultFn) const {
+    if (noIntersection(queryBBox)) {
+        return;
+    } else if (completeIntersection(queryBBox)) {
+        for (auto& element : boxElements) {
+            if (resultFn(element.first, element.second)) {
+                return;
+            }
+        }
+        for (auto& element : circleElements) {
+            if (resultFn(element.first, convertToBox(element.second))) {
+                return;
+            }
+        }
+        return;
+    }
+
+    const CellRange queryRange = cellRange(queryBBox);
+    // Look up other boxes
+    if (walkCells(boxCells, boxEntries, queryRange, xCellCount, [&](const CellEntry<BBox>& entry) {
+            return boxesCollide(queryBBox, entry.geometry) && resultFn(boxElements[entry.element].first, entry.geometry);
+        })) {
+        return;
+    }
+    // Look up circles
+    walkCells(circleCells, circleEntries, queryRange, xCellCount, [&](const CellEntry<BCircle>& entry) {
+        return circleAndBoxCollide(entry.geometry, queryBBox) &&
+               resultFn(circleElements[entry.element].first, convertToBox(entry.geometry));
+    });
+}
+
+template <class T>
+template <class ResultFn>
+void GridIndex<T>::query(const BCircle& queryBCircle, ResultFn&& resultFn) const {
+    BBox queryBBox = convertToBox(queryBCircle);
+    if (noIntersection(queryBBox)) {
+        return;
+    } else if (completeIntersection(queryBBox)) {
+        for (auto& element : boxElements) {
+            if (resultFn(element.first, element.second)) {
+                return;
+            }
+        }
+        for (auto& element : circleElements) {
+            if (resultFn(element.first, convertToBox(element.second))) {
+                return;
+            }
+        }
+        return;
+    }
+
+    const CellRange queryRange = cellRange(queryBBox);
+    // Look up boxes
+    if (walkCells(boxCells, boxEntries, queryRange, xCellCount, [&](const CellEntry<BBox>& entry) {
+            return circleAndBoxCollide(queryBCircle, entry.geometry) && resultFn(boxElements[entry.element].first, entry.geometry);
+        })) {
+        return;
+    }
+    // Look up other circles
+    walkCells(circleCells, circleEntries, queryRange, xCellCount, [&](const CellEntry<BCircle>& entry) {
+        return circlesCollide(queryBCircle, entry.geometry) &&
+               resultFn(circleElements[entry.element].first, convertToBox(entry.geometry));
+    });
+}
+
+template <class T>
+template <class Predicate>
+bool GridIndex<T>::hitTest(const BBox& queryBBox, Predicate&& predicate) const {
+    bool hit = false;
+    query(queryBBox, [&](const T& t, const BBox&) -> bool {
+        hit = predicate(t);
+        return hit;
+    });
+    return hit;
+}
+
+template <class T>
+template <class Predicate>
+bool GridIndex<T>::hitTest(const BCircle& queryBCircle, Predicate&& predicate) const {
+    bool hit = false;
+    query(queryBCircle, [&](const T& t, const BBox&) -> bool {
+        hit = predicate(t);
+        return hit;
+    });
+    return hit;
+}
+
 } // namespace mbgl
@@ -3,14 +3,26 @@
 #include <mbgl/test/map_adapter.hpp>
 
 #include <mbgl/annotation/annotation.hpp>
+#include <mbgl/annotation/annotation_manager.hpp>
+#include <mbgl/annotation/annotation_tile.hpp>
+#include <mbgl/annotation/shape_annotation_batch.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/image.hpp>
+#include <mbgl/style/layer.hpp>
+#include <mbgl/style/expression/dsl.hpp>
 #include <mbgl/map/map_options.hpp>
+#include <mbgl/map/transform_state.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
 #include <mbgl/util/color.hpp>
 #include <mbgl/renderer/renderer.hpp>
+#include <mbgl/renderer/image_manager.hpp>
+#include <mbgl/renderer/tile_parameters.hpp>
 #include <mbgl/gfx/headless_frontend.hpp>
+#include <mbgl/text/glyph_manager.hpp>
+
+#include <algorithm>
 
 using namespace mbgl;
 
@@ -38,6 +50,64 @@ public:
     }
 };
 
+// Holds every annotation tile of one zoom level, to check which of them get regenerated.
+class AnnotationTileTest {
+public:
+    util::RunLoop loop;
+    std::shared_ptr<FileSource> fileSource = std::make_shared<StubFileSource>();
+    TransformState transformState;
+    style::Style style { *fileSource, 1 };
+    AnnotationManager annotationManager { style };
+    ImageManager imageManager;
+    GlyphManager glyphManager;
+
+    TileParameters tileParameters {
+        1.0,
+        MapDebugOptions(),
+        transformState,
+        fileSource,
+        MapMode::Continuous,
+        annotationManager,
+        imageManager,
+        glyphManager,
+        0
+    };
+
+    std::vector<std::unique_ptr<AnnotationTile>> tiles;
+
+    AnnotationTileTest(uint8_t z) {
+        style.loadJSON(util::read_file("test/fixtures/api/empty.json"));
+        annotationManager.onStyleLoaded();
+        for (uint32_t x = 0; x < (1u << z); ++x) {
+            for (uint32_t y = 0; y < (1u << z); ++y) {
+                tiles.push_back(std::make_unique<AnnotationTile>(OverscaledTileID(z, x, y), tileParameters));
+                tiles.back()->setLayers({});
+            }
+        }
+        waitForTiles();
+    }
+
+    void waitForTiles() {
+        while (std::any_of(tiles.begin(), tiles.end(), [] (const auto& tile) { return !tile->isComplete(); })) {
+            loop.runOnce();
+        }
+    }
+
+    // Returns the tiles that updateData() handed new data to.
+    std::vector<CanonicalTileID> updateData() {
+        annotationManager.updateData();
+        std::vector<CanonicalTileID> updated;
+        for (const auto& tile : tiles) {
+            if (!tile->isComplete()) {
+                updated.push_back(tile->id.canonical);
+            }
+        }
+        waitForTiles();
+        std::sort(updated.begin(), updated.end());
+        return updated;
+    }
+};
+
 } // end namespace
 
 TEST(Annotations, SymbolAnnotation) {
@@ -310,6 +380,122 @@ TEST(Annotations, RemoveShape) {
     test.checkRendering("remove_shape");
 }
 
+TEST(Annotations, BatchedShapeAnnotations) {
+    AnnotationTest test;
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+
+    const auto shapeLayerCount = [&] {
+        const auto layers = test.map.getStyle().getLayers();
+        return std::count_if(layers.begin(), layers.end(), [] (const auto* layer) {
+            return layer->getID().compare(0, AnnotationManager::ShapeLayerID.size(), AnnotationManager::ShapeLayerID) == 0;
+        });
+    };
+
+    // Consecutive shapes of the same kind with constant properties share a layer.
+    std::vector<AnnotationID> lines;
+    for (int i = 0; i < 10; ++i) {
+        LineAnnotation line { LineString<double> {{ { double(i), 0 }, { double(i), 45 } }} };
+        line.color = i % 2 ? Color::red() : Color::blue();
+        line.width = { float(i + 1) };
+        lines.push_back(test.map.addAnnotation(line));
+    }
+    EXPECT_EQ(1, shapeLayerCount());
+
+    Polygon<double> triangle = {{ { 0, 0 }, { 45, 0 }, { 0, 45 } }};
+    FillAnnotation fill { triangle };
+    fill.color = Color::red();
+    AnnotationID fillID = test.map.addAnnotation(fill);
+    EXPECT_EQ(2, shapeLayerCount());
+
+    // Shapes with data-driven properties keep a layer of their own.
+    LineAnnotation styled { LineString<double> {{ { 0, 0 }, { 45, 45 } }} };
+    styled.width = style::PropertyExpression<float>(style::expression::dsl::literal(2.0));
+    test.map.addAnnotation(styled);
+    EXPECT_EQ(3, shapeLayerCount());
+
+    test.map.removeAnnotation(fillID);
+    EXPECT_EQ(2, shapeLayerCount());
+
+    for (AnnotationID id : lines) {
+        test.map.removeAnnotation(id);
+    }
+    EXPECT_EQ(1, shapeLayerCount());
+
+    test.frontend.render(test.map);
+}
+
+TEST(Annotations, BatchedShapeAnnotationsLimit) {
+    AnnotationTest test;
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+
+    for (std::size_t i = 0; i <= ShapeAnnotationBatch::maxSize; ++i) {
+        LineAnnotation line { LineString<double> {{ { double(i) / 10, 0 }, { double(i) / 10, 45 } }} };
+        line.color = Color::red();
+        test.map.addAnnotation(line);
+    }
+
+    // A full batch isn't grown any further.
+    const auto layers = test.map.getStyle().getLayers();
+    EXPECT_EQ(2, std::count_if(layers.begin(), layers.end(), [] (const auto* layer) {
+        return layer->getID().compare(0, AnnotationManager::ShapeLayerID.size(), AnnotationManager::ShapeLayerID) == 0;
+    }));
+}
+
+TEST(Annotations, UpdateBatchedShapeAnnotationDrawOrder) {
+    AnnotationTest test;
+
+    test.map.getStyle().loadJSON(util::read_file("test/fixtures/api/empty.json"));
+
+    const auto shapeLayerIDs = [&] {
+        std::vector<std::string> ids;
+        for (const auto* layer : test.map.getStyle().getLayers()) {
+            if (layer->getID().compare(0, AnnotationManager::ShapeLayerID.size(), AnnotationManager::ShapeLayerID) == 0) {
+                ids.push_back(layer->getID());
+            }
+        }
+        return ids;
+    };
+
+    const auto line = [] (double x) {
+        LineAnnotation annotation { LineString<double> {{ { x, 0 }, { x, 45 } }} };
+        annotation.color = Color::red();
+        return annotation;
+    };
+
+    test.map.addAnnotation(line(0));
+    AnnotationID middle = test.map.addAnnotation(line(10));
+    test.map.addAnnotation(line(20));
+    const std::vector<std::string> batched = shapeLayerIDs();
+    ASSERT_EQ(1u, batched.size());
+
+    // A shape that can't be batched any more is drawn by a layer of its own, between the shapes
+    // that were drawn below and above it.
+    LineAnnotation styled = line(10);
+    styled.width = style::PropertyExpression<float>(style::expression::dsl::literal(2.0));
+    test.map.updateAnnotation(middle, styled);
+    const std::vector<std::string> split = shapeLayerIDs();
+    ASSERT_EQ(3u, split.size());
+    EXPECT_EQ(batched[0], split[0]);
+    EXPECT_EQ(AnnotationManager::ShapeLayerID + util::toString(middle), split[1]);
+
+    // Shapes added later are drawn above it, in the batch above it.
+    test.map.addAnnotation(line(30));
+    EXPECT_EQ(split, shapeLayerIDs());
+
+    // It keeps its layer, and thus its place, once it could be batched again.
+    test.map.updateAnnotation(middle, line(15));
+    EXPECT_EQ(split, shapeLayerIDs());
+
+    // Also when it becomes a shape of another kind.
+    Polygon<double> triangle = {{ { 0, 0 }, { 45, 0 }, { 0, 45 } }};
+    test.map.updateAnnotation(middle, FillAnnotation { triangle });
+    EXPECT_EQ(split, shapeLayerIDs());
+
+    test.frontend.render(test.map);
+}
+
 TEST(Annotations, ImmediateRemoveShape) {
     AnnotationTest test;
 
@@ -552,3 +738,53 @@ TEST(Annotations, ChangeMaxZoom) {
     test.checkRendering("line_annotation_max_zoom");
 }
 
+
+TEST(Annotations, RegenerateAffectedTiles) {
+    AnnotationTileTest test(2);
+
+    test.annotationManager.addAnnotation(SymbolAnnotation { Point<double>(10, 10), "default_marker" });
+    EXPECT_EQ(std::vector<CanonicalTileID>({ { 2, 2, 1 } }), test.updateData());
+
+    // Nothing changed since the last update.
+    EXPECT_EQ(std::vector<CanonicalTileID>(), test.updateData());
+
+    // Shapes are tiled with a buffer, so tiles next to a changed annotation are regenerated too.
+    LineString<double> line = {{ { 80, 10 }, { 89.9, 10 } }};
+    test.annotationManager.addAnnotation(LineAnnotation { line });
+    EXPECT_EQ(std::vector<CanonicalTileID>({ { 2, 2, 1 }, { 2, 3, 1 } }), test.updateData());
+}
+
+TEST(Annotations, RegenerateAffectedTilesAcrossAntimeridian) {
+    AnnotationTileTest test(2);
+
+    LineString<double> east = {{ { 170, 10 }, { 190, 10 } }};
+    test.annotationManager.addAnnotation(LineAnnotation { east });
+    EXPECT_EQ(std::vector<CanonicalTileID>({ { 2, 0, 1 }, { 2, 3, 1 } }), test.updateData());
+
+    LineString<double> west = {{ { -190, -10 }, { -170, -10 } }};
+    test.annotationManager.addAnnotation(LineAnnotation { west });
+    EXPECT_EQ(std::vector<CanonicalTileID>({ { 2, 0, 2 }, { 2, 3, 2 } }), test.updateData());
+}
+
+TEST(Annotations, RegenerateTilesOfUpdatedAndRemovedAnnotations) {
+    AnnotationTileTest test(2);
+
+    AnnotationID point = test.annotationManager.addAnnotation(SymbolAnnotation { Point<double>(10, 10), "default_marker" });
+    LineString<double> line = {{ { 10, 10 }, { 20, 10 } }};
+    AnnotationID shape = test.annotationManager.addAnnotation(LineAnnotation { line });
+    test.updateData();
+
+    // Both the tiles an annotation left and the tiles it moved to are regenerated.
+    test.annotationManager.updateAnnotation(point, SymbolAnnotation { Point<double>(-100, -10), "default_marker" });
+    EXPECT_EQ(std::vector<CanonicalTileID>({ { 2, 0, 2 }, { 2, 2, 1 } }), test.updateData());
+
+    LineString<double> moved = {{ { 100, -10 }, { 110, -10 } }};
+    test.annotationManager.updateAnnotation(shape, LineAnnotation { moved });
+    EXPECT_EQ(std::vector<CanonicalTileID>({ { 2, 2, 1 }, { 2, 3, 2 } }), test.updateData());
+
+    test.annotationManager.removeAnnotation(point);
+    EXPECT_EQ(std::vector<CanonicalTileID>({ { 2, 0, 2 } }), test.updateData());
+
+    test.annotationManager.removeAnnotation(shape);
+    EXPECT_EQ(std::vector<CanonicalTileID>({ { 2, 3, 2 } }), test.updateData());
+}
@@ -63,6 +63,27 @@ TEST(Buckets, CircleBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 }
 
+TEST(Buckets, CircleBucketAddFeatures) {
+    CircleBucket single { { {0, 0, 0}, MapMode::Static, 1.0, nullptr }, {} };
+    CircleBucket batched { { {0, 0, 0}, MapMode::Static, 1.0, nullptr }, {} };
+
+    GeometryCollection point { { { 0, 0 } } };
+    GeometryCollection points { { { 10, 10 }, { 20, 20 } } };
+    StubGeometryTileFeature pointFeature { {}, FeatureType::Point, point, properties };
+    StubGeometryTileFeature pointsFeature { {}, FeatureType::Point, points, properties };
+
+    single.addFeature(pointFeature, point, {}, PatternLayerMap());
+    single.addFeature(pointsFeature, points, {}, PatternLayerMap());
+
+    const PatternLayerMap patterns;
+    batched.addFeatures({ { pointFeature, point, patterns }, { pointsFeature, points, patterns } }, {});
+
+    ASSERT_TRUE(batched.hasData());
+    EXPECT_EQ(single.vertices.elements(), batched.vertices.elements());
+    EXPECT_EQ(single.triangles.elements(), batched.triangles.elements());
+    EXPECT_EQ(single.segments.size(), batched.segments.size());
+}
+
 TEST(Buckets, FillBucket) {
     gl::HeadlessBackend backend({ 512, 256 });
     gfx::BackendScope scope { backend };
@@ -110,6 +131,29 @@ TEST(Buckets, LineBucket) {
     ASSERT_FALSE(bucket.needsUpload());
 }
 
+TEST(Buckets, MergeSegments) {
+    gfx::IndexVector<gfx::Triangles> indices;
+    SegmentVector<FillAttributes> segments;
+
+    // Indices are relative to the vertices of their segment.
+    segments.emplace_back(0, 0, 3, 3);
+    indices.emplace_back(0, 1, 2);
+    segments.emplace_back(3, 3, 4, 6);
+    indices.emplace_back(0, 1, 2);
+    indices.emplace_back(1, 2, 3);
+    segments.emplace_back(7, 9, 3, 3, 1.0f);
+    indices.emplace_back(0, 1, 2);
+
+    const auto merged = mergeSegments(segments, indices);
+
+    // Segments with a different sort key are kept apart.
+    SegmentVector<FillAttributes> expectedSegments;
+    expectedSegments.emplace_back(0, 0, 7, 9);
+    expectedSegments.emplace_back(7, 9, 3, 3);
+    EXPECT_EQ(expectedSegments, segments);
+    EXPECT_EQ((std::vector<uint32_t>{ 0, 1, 2, 3, 4, 5, 4, 5, 6, 0, 1, 2 }), merged.vector());
+}
+
 TEST(Buckets, SymbolBucket) {
     gl::HeadlessBackend backend({ 512, 256 });
     gfx::BackendScope scope { backend };
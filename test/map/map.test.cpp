@@ -415,7 +415,12 @@ TEST(Map, StyleFresh) {
     response.data = std::make_shared<std::string>(util::read_file("test/fixtures/api/empty.json"));
     response.expires = Timestamp::max();
 
+    // Styles loaded from a URL are parsed on a background thread.
+    test.observer.didFinishLoadingStyleCallback = [&]() {
+        test.runLoop.stop();
+    };
     test.fileSource->respond(Resource::Style, response);
+    test.runLoop.run();
     EXPECT_EQ(1u, test.fileSource->requests.size());
 }
 
@@ -433,7 +438,11 @@ TEST(Map, StyleExpired) {
     response.data = std::make_shared<std::string>(util::read_file("test/fixtures/api/empty.json"));
     response.expires = util::now() - 1h;
 
+    test.observer.didFinishLoadingStyleCallback = [&]() {
+        test.runLoop.stop();
+    };
     test.fileSource->respond(Resource::Style, response);
+    test.runLoop.run();
     EXPECT_EQ(1u, test.fileSource->requests.size());
 
     // Mutate layer. From now on, sending a response to the style won't overwrite it anymore, but
@@ -469,7 +478,11 @@ TEST(Map, StyleExpiredWithAnnotations) {
     response.data = std::make_shared<std::string>(util::read_file("test/fixtures/api/empty.json"));
     response.expires = util::now() - 1h;
 
+    test.observer.didFinishLoadingStyleCallback = [&]() {
+        test.runLoop.stop();
+    };
     test.fileSource->respond(Resource::Style, response);
+    test.runLoop.run();
     EXPECT_EQ(1u, test.fileSource->requests.size());
 
     test.map.addAnnotation(LineAnnotation { LineString<double> {{ { 0, 0 }, { 10, 10 } }} });
@@ -493,7 +506,11 @@ TEST(Map, StyleExpiredWithRender) {
     response.data = std::make_shared<std::string>(util::read_file("test/fixtures/api/empty.json"));
     response.expires = util::now() - 1h;
 
+    test.observer.didFinishLoadingStyleCallback = [&]() {
+        test.runLoop.stop();
+    };
     test.fileSource->respond(Resource::Style, response);
+    test.runLoop.run();
     EXPECT_EQ(1u, test.fileSource->requests.size());
 
     test.frontend.render(test.map);
@@ -513,7 +530,11 @@ TEST(Map, StyleEarlyMutation) {
 
     Response response;
     response.data = std::make_shared<std::string>(util::read_file("test/fixtures/api/water.json"));
+    test.observer.didFinishLoadingStyleCallback = [&]() {
+        test.runLoop.stop();
+    };
     test.fileSource->respond(Resource::Style, response);
+    test.runLoop.run();
 
     EXPECT_EQ(1u, test.fileSource->requests.size());
     EXPECT_NE(nullptr, test.map.getStyle().getLayer("water"));
@@ -3,6 +3,11 @@
 #include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/storage/resource_transform.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <climits>
+#include <set>
+#include <unistd.h>
 
 using namespace mbgl;
 
@@ -584,6 +589,34 @@ TEST(DefaultFileSource, SetResourceCachePath) {
     loop.run();
 }
 
+TEST(DefaultFileSource, MBTiles) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+    fs.setMBTilesMmapSize(1024 * 1024);
+
+    char cwd[PATH_MAX + 1];
+    ASSERT_TRUE(getcwd(cwd, PATH_MAX + 1));
+    const std::string url = "mbtiles://" + std::string(cwd) + "/test/fixtures/storage/mbtiles/test.mbtiles";
+
+    std::unique_ptr<AsyncRequest> req = fs.request({ Resource::Source, url }, [&](Response res) {
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_NE(std::string::npos, res.data->find("\"tiles\":[\"" + url + "?z={z}&x={x}&y={y}\"]"));
+
+        // Changing the mmap size applies to the file that is already open.
+        fs.setMBTilesMmapSize(0);
+        req = fs.request(Resource::tile(url + "?z={z}&x={x}&y={y}", 1.0, 0, 0, 0, Tileset::Scheme::TMS), [&](Response tileRes) {
+            req.reset();
+            EXPECT_EQ(nullptr, tileRes.error);
+            ASSERT_TRUE(tileRes.data.get());
+            EXPECT_EQ("plain tile", *tileRes.data);
+            loop.stop();
+        });
+    });
+
+    loop.run();
+}
+
 // Test that a stale cache file that has must-revalidate set will trigger a response.
 TEST(DefaultFileSource, TEST_REQUIRES_SERVER(RespondToStaleMustRevalidate)) {
     util::RunLoop loop;
@@ -661,3 +694,39 @@ TEST(DefaultFileSource, TEST_REQUIRES_SERVER(RespondToStaleMustRevalidate)) {
 
     loop.run();
 }
+
+// Only the cURL backend applies connection options; the platform HTTP stacks manage their own connections.
+#if !defined(__APPLE__) && !defined(__ANDROID__) && !defined(__QT__)
+TEST(DefaultFileSource, TEST_REQUIRES_SERVER(SetConnectionOptions)) {
+    util::RunLoop loop;
+    DefaultFileSource fs(":memory:", ".");
+
+    HTTPConnectionOptions options;
+    options.maxConnectionsPerHost = 1;
+    fs.setConnectionOptions(options);
+
+    const int concurrency = 4;
+    int remaining = concurrency;
+    std::set<std::string> ports;
+
+    std::unique_ptr<AsyncRequest> reqs[concurrency];
+    for (int i = 0; i < concurrency; i++) {
+        const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/connection?" + util::toString(i) };
+        reqs[i] = fs.request(resource, [&, i](Response res) {
+            reqs[i].reset();
+            EXPECT_EQ(nullptr, res.error);
+            ASSERT_TRUE(res.data.get());
+            ports.insert(*res.data);
+
+            if (--remaining == 0) {
+                loop.stop();
+            }
+        });
+    }
+
+    loop.run();
+
+    // The options reached the HTTP file source, so all requests shared one connection.
+    EXPECT_EQ(1u, ports.size());
+}
+#endif
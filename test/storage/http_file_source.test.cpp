@@ -5,6 +5,8 @@
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <set>
+
 using namespace mbgl;
 
 TEST(HTTPFileSource, TEST_REQUIRES_SERVER(Cancel)) {
@@ -203,3 +205,43 @@ TEST(HTTPFileSource, TEST_REQUIRES_SERVER(Load)) {
 
     loop.run();
 }
+
+// Only the cURL backend applies connection options; the platform HTTP stacks manage their own connections.
+#if !defined(__APPLE__) && !defined(__ANDROID__) && !defined(__QT__)
+TEST(HTTPFileSource, TEST_REQUIRES_SERVER(ConnectionOptions)) {
+    util::RunLoop loop;
+    HTTPFileSource fs;
+
+    HTTPConnectionOptions options;
+    options.maxConnectionsPerHost = 2;
+    options.maxStreamsPerConnection = 8;
+    options.keepAliveIdle = Seconds(10);
+    options.dnsCacheTimeout = Seconds(0);
+    fs.setConnectionOptions(options);
+
+    const int concurrency = 8;
+    int remaining = concurrency;
+    std::set<std::string> ports;
+
+    // The server delays its responses, so all requests are in flight at the same time.
+    std::unique_ptr<AsyncRequest> reqs[concurrency];
+    for (int i = 0; i < concurrency; i++) {
+        reqs[i] = fs.request({ Resource::Unknown, "http://127.0.0.1:3000/connection" }, [&, i](Response res) {
+            reqs[i].reset();
+            EXPECT_EQ(nullptr, res.error);
+            ASSERT_TRUE(res.data.get());
+            ports.insert(*res.data);
+
+            if (--remaining == 0) {
+                loop.stop();
+            }
+        });
+    }
+
+    loop.run();
+
+    // Requests queue for one of the two connections to the host rather than opening new ones.
+    EXPECT_LE(ports.size(), 2u);
+    EXPECT_GE(ports.size(), 1u);
+}
+#endif
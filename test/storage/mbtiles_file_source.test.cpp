@@ -0,0 +1,129 @@
+#include <mbgl/storage/mbtiles_file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/util/rapidjson.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <unistd.h>
+#include <climits>
+#include <gtest/gtest.h>
+
+namespace {
+
+std::string toAbsoluteURL(const std::string& fileName) {
+    char buff[PATH_MAX + 1];
+    char* cwd = getcwd( buff, PATH_MAX + 1 );
+    std::string url = { "mbtiles://" + std::string(cwd) + "/test/fixtures/storage/mbtiles/" + fileName };
+    assert(url.size() <= PATH_MAX);
+    return url;
+}
+
+} // namespace
+
+using namespace mbgl;
+
+TEST(MBTilesFileSource, AcceptsURL) {
+    EXPECT_TRUE(MBTilesFileSource::acceptsURL("mbtiles://empty"));
+    EXPECT_TRUE(MBTilesFileSource::acceptsURL("mbtiles:///test.mbtiles"));
+    EXPECT_FALSE(MBTilesFileSource::acceptsURL("mbtile://foo"));
+    EXPECT_FALSE(MBTilesFileSource::acceptsURL("mbtiles:"));
+    EXPECT_FALSE(MBTilesFileSource::acceptsURL("file:///test.mbtiles"));
+    EXPECT_FALSE(MBTilesFileSource::acceptsURL(""));
+}
+
+TEST(MBTilesFileSource, TileJSON) {
+    util::RunLoop loop;
+
+    MBTilesFileSource fs;
+
+    const std::string url = toAbsoluteURL("test.mbtiles");
+    std::unique_ptr<AsyncRequest> req = fs.request({ Resource::Source, url }, [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+
+        JSDocument doc;
+        doc.Parse<0>(res.data->c_str());
+        ASSERT_TRUE(doc.IsObject());
+        EXPECT_EQ("Test", std::string(doc["name"].GetString()));
+        EXPECT_EQ("tms", std::string(doc["scheme"].GetString()));
+        EXPECT_EQ(0, doc["minzoom"].GetDouble());
+        EXPECT_EQ(1, doc["maxzoom"].GetDouble());
+        ASSERT_TRUE(doc["bounds"].IsArray());
+        EXPECT_EQ(4u, doc["bounds"].Size());
+        ASSERT_TRUE(doc["vector_layers"].IsArray());
+        EXPECT_EQ("water", std::string(doc["vector_layers"][0]["id"].GetString()));
+        ASSERT_TRUE(doc["tiles"].IsArray());
+        EXPECT_EQ(url + "?z={z}&x={x}&y={y}", std::string(doc["tiles"][0].GetString()));
+        loop.stop();
+    });
+
+    loop.run();
+}
+
+TEST(MBTilesFileSource, Tile) {
+    util::RunLoop loop;
+
+    MBTilesFileSource fs;
+
+    const std::string urlTemplate = toAbsoluteURL("test.mbtiles") + "?z={z}&x={x}&y={y}";
+    std::unique_ptr<AsyncRequest> req = fs.request(Resource::tile(urlTemplate, 1.0, 0, 0, 0, Tileset::Scheme::TMS), [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("plain tile", *res.data);
+        loop.stop();
+    });
+
+    loop.run();
+}
+
+TEST(MBTilesFileSource, GzippedTile) {
+    util::RunLoop loop;
+
+    MBTilesFileSource fs;
+
+    // The fixture stores this tile in TMS row 1, i.e. XYZ row 0.
+    const std::string urlTemplate = toAbsoluteURL("test.mbtiles") + "?z={z}&x={x}&y={y}";
+    std::unique_ptr<AsyncRequest> req = fs.request(Resource::tile(urlTemplate, 1.0, 0, 0, 1, Tileset::Scheme::TMS), [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        ASSERT_TRUE(res.data.get());
+        EXPECT_EQ("gzipped tile", *res.data);
+        loop.stop();
+    });
+
+    loop.run();
+}
+
+TEST(MBTilesFileSource, MissingTile) {
+    util::RunLoop loop;
+
+    MBTilesFileSource fs(1, 1024 * 1024);
+
+    const std::string urlTemplate = toAbsoluteURL("test.mbtiles") + "?z={z}&x={x}&y={y}";
+    std::unique_ptr<AsyncRequest> req = fs.request(Resource::tile(urlTemplate, 1.0, 1, 1, 1, Tileset::Scheme::TMS), [&](Response res) {
+        req.reset();
+        EXPECT_EQ(nullptr, res.error);
+        EXPECT_TRUE(res.noContent);
+        EXPECT_FALSE(res.data.get());
+        loop.stop();
+    });
+
+    loop.run();
+}
+
+TEST(MBTilesFileSource, NonExistentFile) {
+    util::RunLoop loop;
+
+    MBTilesFileSource fs;
+
+    std::unique_ptr<AsyncRequest> req = fs.request({ Resource::Source, toAbsoluteURL("does_not_exist.mbtiles") }, [&](Response res) {
+        req.reset();
+        ASSERT_NE(nullptr, res.error);
+        EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason);
+        ASSERT_FALSE(res.data.get());
+        loop.stop();
+    });
+
+    loop.run();
+}
@@ -92,6 +92,15 @@ static std::vector<std::string> databaseTableColumns(const std::string& path, co
     return columns;
 }
 
+static int64_t databaseRowCount(const std::string& path, const std::string& name) {
+    mapbox::sqlite::Database db = mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly);
+    const auto sql = std::string("SELECT COUNT(*) FROM ") + name;
+    mapbox::sqlite::Statement stmt{ db, sql.c_str() };
+    mapbox::sqlite::Query query{ stmt };
+    query.run();
+    return query.get<int64_t>(0);
+}
+
 namespace fixture {
 
 const Resource resource{ Resource::Style, "mapbox://test" };
@@ -219,7 +228,7 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(SchemaVersion)) {
         OfflineDatabase db(filename);
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(9, databaseUserVersion(filename));
 
     OfflineDatabase db(filename);
     // Now try inserting and reading back to make sure we have a valid database.
@@ -1083,6 +1092,106 @@ TEST(OfflineDatabase, GetRegionCompletedStatus) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+TEST(OfflineDatabase, RegionStatsFollowUpdates) {
+    FixtureLog log;
+    OfflineDatabase db(":memory:");
+    OfflineTilePyramidRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0, false };
+    auto region1 = db.createRegion(definition, OfflineRegionMetadata());
+    ASSERT_TRUE(region1);
+    auto region2 = db.createRegion(definition, OfflineRegionMetadata());
+    ASSERT_TRUE(region2);
+
+    const Resource style = Resource::style("http://example.com/style");
+    const Resource tile = Resource::tile("http://example.com/", 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+
+    Response response;
+    response.data = std::make_shared<std::string>("data");
+    db.putRegionResource(region1->getID(), style, response);
+    db.putRegionResource(region1->getID(), tile, response);
+    db.putRegionResource(region2->getID(), tile, response);
+
+    db.setRegionRequiredResourceCount(region1->getID(), 10, { style.url });
+    auto status1 = db.getRegionCompletedStatus(region1->getID());
+    ASSERT_TRUE(status1);
+    EXPECT_EQ(2u, status1->completedResourceCount);
+    EXPECT_EQ(8u, status1->completedResourceSize);
+    EXPECT_EQ(1u, status1->completedTileCount);
+    EXPECT_EQ(4u, status1->completedTileSize);
+    EXPECT_EQ(10u, status1->requiredResourceCount);
+    EXPECT_TRUE(status1->requiredResourceCountIsPrecise);
+
+    // Updating a shared tile updates the size of every region using it.
+    Response bigger;
+    bigger.data = std::make_shared<std::string>("more data");
+    db.put(tile, bigger);
+    EXPECT_EQ(9u, db.getRegionCompletedStatus(region1->getID())->completedTileSize);
+    EXPECT_EQ(9u, db.getRegionCompletedStatus(region2->getID())->completedTileSize);
+    EXPECT_EQ(1u, db.getRegionCompletedStatus(region2->getID())->completedTileCount);
+
+    // A changed style forgets the required resource count, which it may have changed.
+    db.put(style, bigger);
+    auto status2 = db.getRegionCompletedStatus(region1->getID());
+    ASSERT_TRUE(status2);
+    EXPECT_EQ(18u, status2->completedResourceSize);
+    EXPECT_EQ(0u, status2->requiredResourceCount);
+    EXPECT_FALSE(status2->requiredResourceCountIsPrecise);
+
+    // A count computed from a style that doesn't belong to the region wouldn't be cleared when
+    // the style changes, and isn't stored.
+    db.setRegionRequiredResourceCount(region2->getID(), 10, { style.url });
+    EXPECT_FALSE(db.getRegionCompletedStatus(region2->getID())->requiredResourceCountIsPrecise);
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(TileDeduplication)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    {
+        OfflineDatabase db(filename);
+        OfflineTilePyramidRegionDefinition definition { "http://example.com/style", LatLngBounds::hull({1, 2}, {3, 4}), 5, 6, 2.0, false };
+        auto region = db.createRegion(definition, OfflineRegionMetadata());
+        ASSERT_TRUE(region);
+
+        Response ocean;
+        ocean.data = std::make_shared<std::string>("ocean");
+        Response land;
+        land.data = std::make_shared<std::string>("land");
+
+        // Identical region tiles share one blob.
+        db.putRegionResource(region->getID(), Resource::tile("http://example.com/", 1.0, 0, 0, 1, Tileset::Scheme::XYZ), ocean);
+        db.putRegionResource(region->getID(), Resource::tile("http://example.com/", 1.0, 0, 1, 1, Tileset::Scheme::XYZ), ocean);
+        db.putRegionResource(region->getID(), Resource::tile("http://example.com/", 1.0, 1, 0, 1, Tileset::Scheme::XYZ), land);
+        EXPECT_EQ(2, databaseRowCount(filename, "tile_blobs"));
+
+        auto response = db.get(Resource::tile("http://example.com/", 1.0, 0, 1, 1, Tileset::Scheme::XYZ));
+        ASSERT_TRUE(response && response->data);
+        EXPECT_EQ("ocean", *response->data);
+        EXPECT_EQ(5, *db.hasRegionResource(region->getID(), Resource::tile("http://example.com/", 1.0, 0, 0, 1, Tileset::Scheme::XYZ)));
+        EXPECT_EQ(14u, db.getRegionCompletedStatus(region->getID())->completedTileSize);
+
+        // Ambient tiles, and region tiles with deduplication disabled, keep their own copy.
+        db.put(Resource::tile("http://example.com/", 1.0, 1, 1, 1, Tileset::Scheme::XYZ), ocean);
+        db.setTileDeduplication(false);
+        db.putRegionResource(region->getID(), Resource::tile("http://example.com/", 1.0, 0, 0, 2, Tileset::Scheme::XYZ), land);
+        db.setTileDeduplication(true);
+        EXPECT_EQ(2, databaseRowCount(filename, "tile_blobs"));
+
+        // A blob goes away with the last tile referencing it.
+        db.putRegionResource(region->getID(), Resource::tile("http://example.com/", 1.0, 1, 0, 1, Tileset::Scheme::XYZ), ocean);
+        EXPECT_EQ(1, databaseRowCount(filename, "tile_blobs"));
+        EXPECT_EQ(19u, db.getRegionCompletedStatus(region->getID())->completedTileSize);
+
+        db.deleteRegion(std::move(*region));
+        EXPECT_EQ(1, databaseRowCount(filename, "tile_blobs"));
+        db.clearAmbientCache();
+        EXPECT_EQ(0, databaseRowCount(filename, "tile_blobs"));
+    }
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, HasRegionResource) {
     FixtureLog log;
     OfflineDatabase db(":memory:");
@@ -1145,6 +1254,94 @@ TEST(OfflineDatabase, HasRegionResourceTile) {
 
 }
 
+TEST(OfflineDatabase, HasRegionResources) {
+    FixtureLog log;
+    OfflineDatabase db(":memory:");
+
+    OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0, false };
+    auto region = db.createRegion(definition, OfflineRegionMetadata());
+    ASSERT_TRUE(region);
+    auto anotherRegion = db.createRegion(definition, OfflineRegionMetadata());
+    ASSERT_TRUE(anotherRegion);
+
+    Response response;
+    response.data = std::make_shared<std::string>("first");
+
+    for (int32_t x = 0; x < 4; x++) {
+        for (int32_t y = 0; y < 4; y++) {
+            db.putRegionResource(region->getID(), Resource::tile("http://example.com/{z}/{x}/{y}", 1.0, x, y, 3, Tileset::Scheme::XYZ), response);
+        }
+    }
+    db.putRegionResource(region->getID(), Resource::style("http://example.com/style"), response);
+
+    std::vector<Resource> resources {
+        Resource::tile("http://example.com/{z}/{x}/{y}", 1.0, 0, 0, 3, Tileset::Scheme::XYZ),
+        Resource::tile("http://example.com/{z}/{x}/{y}", 1.0, 7, 7, 3, Tileset::Scheme::XYZ),
+        Resource::tile("http://example.com/{z}/{x}/{y}", 1.0, 3, 2, 3, Tileset::Scheme::XYZ),
+        Resource::tile("http://example.com/{z}/{x}/{y}", 2.0, 1, 1, 3, Tileset::Scheme::XYZ),
+        Resource::tile("http://example.com/{z}/{x}/{y}", 1.0, 1, 1, 4, Tileset::Scheme::XYZ),
+        Resource::style("http://example.com/style"),
+        Resource::style("http://example.com/missing"),
+    };
+
+    auto sizes = db.hasRegionResources(anotherRegion->getID(), resources);
+    ASSERT_EQ(resources.size(), sizes.size());
+    EXPECT_EQ(5, *sizes[0]);
+    EXPECT_FALSE(bool(sizes[1]));
+    EXPECT_EQ(5, *sizes[2]);
+    EXPECT_FALSE(bool(sizes[3]));
+    EXPECT_FALSE(bool(sizes[4]));
+    EXPECT_EQ(5, *sizes[5]);
+    EXPECT_FALSE(bool(sizes[6]));
+
+    // Only the tiles that were asked for are marked as used by the region, not the other tiles
+    // of the pyramid.
+    auto status = db.getRegionCompletedStatus(anotherRegion->getID());
+    ASSERT_TRUE(status);
+    EXPECT_EQ(2u, status->completedTileCount);
+    EXPECT_EQ(3u, status->completedResourceCount);
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, HasRegionResourcesInSeveralQueries) {
+    FixtureLog log;
+    OfflineDatabase db(":memory:");
+
+    OfflineTilePyramidRegionDefinition definition { "", LatLngBounds::world(), 0, INFINITY, 1.0, false };
+    auto region = db.createRegion(definition, OfflineRegionMetadata());
+    ASSERT_TRUE(region);
+    auto anotherRegion = db.createRegion(definition, OfflineRegionMetadata());
+    ASSERT_TRUE(anotherRegion);
+
+    Response response;
+    response.data = std::make_shared<std::string>("first");
+
+    // More tiles than are looked up by a single query, every other one of them stored.
+    std::vector<Resource> resources;
+    for (int32_t y = 0; y < 20; y++) {
+        for (int32_t x = 0; x < 30; x++) {
+            resources.push_back(Resource::tile("http://example.com/{z}/{x}/{y}", 1.0, x, y, 5, Tileset::Scheme::XYZ));
+            if ((x + y) % 2 == 0) {
+                db.putRegionResource(region->getID(), resources.back(), response);
+            }
+        }
+    }
+
+    auto sizes = db.hasRegionResources(anotherRegion->getID(), resources);
+    ASSERT_EQ(resources.size(), sizes.size());
+    for (std::size_t i = 0; i < resources.size(); i++) {
+        const Resource::TileData& tile = *resources[i].tileData;
+        EXPECT_EQ((tile.x + tile.y) % 2 == 0, bool(sizes[i])) << tile.x << "/" << tile.y;
+    }
+
+    auto status = db.getRegionCompletedStatus(anotherRegion->getID());
+    ASSERT_TRUE(status);
+    EXPECT_EQ(300u, status->completedTileCount);
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, OfflineMapboxTileCount) {
     FixtureLog log;
     OfflineDatabase db(":memory:");
@@ -1285,7 +1482,7 @@ TEST(OfflineDatabase, MigrateFromV2Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(9, databaseUserVersion(filename));
     EXPECT_LT(databasePageCount(filename),
               databasePageCount("test/fixtures/offline_database/v2.db"));
 
@@ -1308,7 +1505,7 @@ TEST(OfflineDatabase, MigrateFromV3Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(9, databaseUserVersion(filename));
 
     EXPECT_EQ(0u, log.uncheckedCount());
 }
@@ -1329,7 +1526,7 @@ TEST(OfflineDatabase, MigrateFromV4Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(9, databaseUserVersion(filename));
 
     // Journal mode should be DELETE after migration to v5.
     EXPECT_EQ("delete", databaseJournalMode(filename));
@@ -1357,11 +1554,11 @@ TEST(OfflineDatabase, MigrateFromV5Schema) {
         }
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(9, databaseUserVersion(filename));
 
-    EXPECT_EQ((std::vector<std::string>{ "id", "url_template", "pixel_ratio", "z", "x", "y",
+    EXPECT_EQ((std::vector<std::string>{ "id", "template_id", "pixel_ratio", "tile_key",
                                          "expires", "modified", "etag", "data", "compressed",
-                                         "accessed", "must_revalidate" }),
+                                         "accessed", "must_revalidate", "blob_id" }),
               databaseTableColumns(filename, "tiles"));
     EXPECT_EQ((std::vector<std::string>{ "id", "url", "kind", "expires", "modified", "etag", "data",
                                          "compressed", "accessed", "must_revalidate" }),
@@ -1370,6 +1567,54 @@ TEST(OfflineDatabase, MigrateFromV5Schema) {
     EXPECT_EQ(0u, log.uncheckedCount());
 }
 
+TEST(OfflineDatabase, MigrateFromV6Schema) {
+    // satellite_test.db is a v6 database containing a single offline region with one tile.
+    FixtureLog log;
+    deleteDatabaseFiles();
+    util::copyFile(filename, "test/fixtures/offline_database/satellite_test.db");
+
+    {
+        OfflineDatabase db(filename);
+
+        auto regions = db.listRegions().value();
+        ASSERT_EQ(1u, regions.size());
+
+        // The tile is still found and still belongs to the region.
+        auto status = db.getRegionCompletedStatus(regions[0].getID());
+        ASSERT_TRUE(status);
+        EXPECT_EQ(1u, status->completedTileCount);
+        EXPECT_EQ(1u, db.getOfflineMapboxTileCount());
+
+        const Resource tile = Resource::tile("mapbox://tiles/mapbox.satellite/{z}/{x}/{y}{ratio}.webp", 1, 0, 0, 1, Tileset::Scheme::XYZ);
+        EXPECT_EQ(9516, *db.hasRegionResource(regions[0].getID(), tile));
+        auto response = db.get(tile);
+        ASSERT_TRUE(response);
+        EXPECT_TRUE(response->data);
+
+        // New tiles of the same source share the migrated template.
+        Response newResponse;
+        newResponse.data = std::make_shared<std::string>("data");
+        const Resource newTile = Resource::tile("mapbox://tiles/mapbox.satellite/{z}/{x}/{y}{ratio}.webp", 1, 1, 1, 1, Tileset::Scheme::XYZ);
+        db.putRegionResource(regions[0].getID(), newTile, newResponse);
+        EXPECT_EQ(2u, db.getRegionCompletedStatus(regions[0].getID())->completedTileCount);
+    }
+
+    EXPECT_EQ(9, databaseUserVersion(filename));
+    EXPECT_EQ((std::vector<std::string>{ "id", "url_template" }),
+              databaseTableColumns(filename, "tile_templates"));
+    EXPECT_EQ((std::vector<std::string>{ "region_id", "completed_resource_count", "completed_resource_size",
+                                         "completed_tile_count", "completed_tile_size", "required_resource_count" }),
+              databaseTableColumns(filename, "region_stats"));
+    EXPECT_EQ((std::vector<std::string>{ "id", "hash", "data" }),
+              databaseTableColumns(filename, "tile_blobs"));
+    EXPECT_EQ((std::vector<std::string>{ "id", "template_id", "pixel_ratio", "tile_key",
+                                         "expires", "modified", "etag", "data", "compressed",
+                                         "accessed", "must_revalidate", "blob_id" }),
+              databaseTableColumns(filename, "tiles"));
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
 TEST(OfflineDatabase, DowngradeSchema) {
     // v999.db is a v999 database, it should be deleted
     // and recreated with the current schema.
@@ -1382,11 +1627,11 @@ TEST(OfflineDatabase, DowngradeSchema) {
         db.setMaximumAmbientCacheSize(0);
     }
 
-    EXPECT_EQ(6, databaseUserVersion(filename));
+    EXPECT_EQ(9, databaseUserVersion(filename));
 
-    EXPECT_EQ((std::vector<std::string>{ "id", "url_template", "pixel_ratio", "z", "x", "y",
+    EXPECT_EQ((std::vector<std::string>{ "id", "template_id", "pixel_ratio", "tile_key",
                                          "expires", "modified", "etag", "data", "compressed",
-                                         "accessed", "must_revalidate" }),
+                                         "accessed", "must_revalidate", "blob_id" }),
               databaseTableColumns(filename, "tiles"));
     EXPECT_EQ((std::vector<std::string>{ "id", "url", "kind", "expires", "modified", "etag", "data",
                                          "compressed", "accessed", "must_revalidate" }),
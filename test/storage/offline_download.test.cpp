@@ -15,6 +15,8 @@
 #include <mbgl/storage/sqlite3.hpp>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <set>
+#include <tuple>
 
 using namespace mbgl;
 using namespace std::literals::string_literals;
@@ -377,6 +379,46 @@ TEST(OfflineDownload, DoesNotFloodTheFileSourceWithRequests) {
     EXPECT_EQ(fileSource.getMaximumConcurrentRequests(), fileSource.requests.size());
 }
 
+TEST(OfflineDownload, LargeRegion) {
+    OfflineTest test;
+    auto region = test.createRegion();
+    ASSERT_TRUE(region);
+    // 5461 tiles on zoom levels 0 through 6.
+    OfflineDownload download(
+        region->getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 6.0, 1.0, false),
+        test.db, test.fileSource);
+
+    test.fileSource.styleResponse = [&] (const Resource&) {
+        return test.response("inline_source.style.json");
+    };
+
+    const Response tileResponse = test.response("0-0-0.vector.pbf");
+    std::set<std::tuple<int8_t, int32_t, int32_t>> requestedTiles;
+    test.fileSource.tileResponse = [&] (const Resource& resource) {
+        const Resource::TileData& tile = *resource.tileData;
+        EXPECT_TRUE(requestedTiles.emplace(tile.z, tile.x, tile.y).second);
+        return tileResponse;
+    };
+
+    auto observer = std::make_unique<MockObserver>();
+
+    observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+        if (status.complete()) {
+            EXPECT_EQ(5462u, status.requiredResourceCount);
+            EXPECT_EQ(5461u, status.completedTileCount);
+            EXPECT_EQ(5461u, requestedTiles.size());
+            EXPECT_TRUE(status.requiredResourceCountIsPrecise);
+            test.loop.stop();
+        }
+    };
+
+    download.setObserver(std::move(observer));
+    download.setState(OfflineRegionDownloadState::Active);
+
+    test.loop.run();
+}
+
 TEST(OfflineDownload, GetStatusNoResources) {
     OfflineTest test;
     auto region = test.createRegion();
@@ -443,6 +485,31 @@ TEST(OfflineDownload, GetStatusStyleAndSourceComplete) {
     EXPECT_EQ(264u, status.requiredResourceCount);
     EXPECT_TRUE(status.requiredResourceCountIsPrecise);
     EXPECT_FALSE(status.complete());
+    EXPECT_TRUE(test.db.getRegionCompletedStatus(region->getID())->requiredResourceCountIsPrecise);
+}
+
+TEST(OfflineDownload, GetStatusAmbientSource) {
+    OfflineTest test;
+    auto region = test.createRegion();
+    ASSERT_TRUE(region);
+    OfflineDownload download(
+        region->getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 0.0, 1.0, true),
+        test.db, test.fileSource);
+
+    test.db.putRegionResource(1,
+        Resource::style("http://127.0.0.1:3000/style.json"),
+        test.response("style.json"));
+
+    // Cached, but not part of the region.
+    test.db.put(Resource::source("http://127.0.0.1:3000/streets.json"), test.response("streets.json"));
+
+    OfflineRegionStatus status = download.getStatus();
+    EXPECT_EQ(264u, status.requiredResourceCount);
+    EXPECT_TRUE(status.requiredResourceCountIsPrecise);
+
+    // The count isn't stored, since changes to the source wouldn't clear it.
+    EXPECT_FALSE(test.db.getRegionCompletedStatus(region->getID())->requiredResourceCountIsPrecise);
 }
 
 TEST(OfflineDownload, RequestError) {
@@ -739,6 +806,46 @@ TEST(OfflineDownload, Deactivate) {
     test.loop.run();
 }
 
+TEST(OfflineDownload, DeactivateStoresFetchedResources) {
+    OfflineTest test;
+    auto region = test.createRegion();
+    ASSERT_TRUE(region);
+    OfflineDownload download(
+        region->getID(),
+        OfflineTilePyramidRegionDefinition("http://127.0.0.1:3000/style.json", LatLngBounds::world(), 0.0, 0.0, 1.0, true),
+        test.db, test.fileSource);
+
+    test.fileSource.styleResponse = [&] (const Resource&) {
+        return test.response("inline_source.style.json");
+    };
+
+    // Stop while the tile is requested; the style is still waiting to be written.
+    test.fileSource.tileResponse = [&] (const Resource&) -> optional<Response> {
+        download.setState(OfflineRegionDownloadState::Inactive);
+        return {};
+    };
+
+    auto observer = std::make_unique<MockObserver>();
+
+    observer->statusChangedFn = [&] (OfflineRegionStatus status) {
+        if (status.downloadState == OfflineRegionDownloadState::Inactive) {
+            EXPECT_EQ(1u, status.completedResourceCount);
+            EXPECT_EQ(test.size, status.completedResourceSize);
+            test.loop.stop();
+        }
+    };
+
+    download.setObserver(std::move(observer));
+    download.setState(OfflineRegionDownloadState::Active);
+
+    test.loop.run();
+
+    auto stored = test.db.getRegionCompletedStatus(region->getID());
+    ASSERT_TRUE(stored);
+    EXPECT_EQ(1u, stored->completedResourceCount);
+    EXPECT_EQ(test.size, stored->completedResourceSize);
+}
+
 
 TEST(OfflineDownload, AllOfflineRequestsHaveLowPriorityAndOfflineUsage) {
     OfflineTest test;
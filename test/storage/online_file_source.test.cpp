@@ -520,6 +520,107 @@ TEST(OnlineFileSource, TEST_REQUIRES_SERVER(LowHighPriorityRequestsMany)) {
     loop.run();
 }
 
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(RankedRequests)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+    std::vector<int> order;
+
+    fs.setMaximumConcurrentRequests(1);
+
+    // Occupies the only active slot while the ranked requests are queued.
+    std::unique_ptr<AsyncRequest> blocker = fs.request({ Resource::Unknown, "http://127.0.0.1:3000/delayed" }, [&](Response) {
+        blocker.reset();
+    });
+
+    std::vector<std::unique_ptr<AsyncRequest>> collector;
+    std::vector<Resource> resources;
+    for (int i = 0; i < 4; i++) {
+        Resource resource = { Resource::Unknown, "http://127.0.0.1:3000/load/" + util::toString(i) };
+        resource.setRank(10 - i);
+        resources.push_back(resource);
+        collector.push_back(fs.request(resource, [&, i](Response) {
+            order.push_back(i);
+            if (order.size() == 4) {
+                loop.stop();
+            }
+        }));
+    }
+
+    // Ranks may still change while the requests are pending.
+    resources[1].setRank(1);
+
+    loop.run();
+
+    EXPECT_EQ((std::vector<int>{ 1, 3, 2, 0 }), order);
+}
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(PreemptStaleRequest)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+
+    fs.setMaximumConcurrentRequests(1);
+
+    // Never responds, so it keeps occupying the only active slot.
+    Resource stale = { Resource::Unknown, "http://127.0.0.1:3000/stale/1" };
+    stale.setRank(0);
+    std::unique_ptr<AsyncRequest> req1 = fs.request(stale, [&](Response) {
+        ADD_FAILURE() << "Preempted request should not complete";
+    });
+
+    std::unique_ptr<AsyncRequest> req2;
+    util::Timer timer;
+    timer.start(Milliseconds(50), Duration::zero(), [&] {
+        // Once its rank grew, a request with a better rank takes over its slot.
+        stale.setRank(10);
+
+        Resource fresh = { Resource::Unknown, "http://127.0.0.1:3000/load/1" };
+        fresh.setRank(1);
+        req2 = fs.request(fresh, [&](Response res) {
+            EXPECT_EQ(nullptr, res.error);
+            ASSERT_TRUE(res.data.get());
+            EXPECT_EQ("Request 1", *res.data);
+            loop.stop();
+        });
+    });
+
+    loop.run();
+}
+
+TEST(OnlineFileSource, TEST_REQUIRES_SERVER(RevalidationsYieldToRequests)) {
+    util::RunLoop loop;
+    OnlineFileSource fs;
+    std::vector<std::string> order;
+
+    ASSERT_EQ(fs.getMaximumConcurrentRevalidations(), 2u);
+
+    fs.setMaximumConcurrentRequests(1);
+
+    std::unique_ptr<AsyncRequest> blocker = fs.request({ Resource::Unknown, "http://127.0.0.1:3000/delayed" }, [&](Response) {
+        order.push_back("blocker");
+        blocker.reset();
+    });
+
+    // Requested first, but the requester already has a usable copy, so it waits until no
+    // regular request needs the connection anymore.
+    Resource revalidation = { Resource::Unknown, "http://127.0.0.1:3000/load/1" };
+    revalidation.priorEtag = std::string("snowfall");
+    revalidation.priorUsable = true;
+    std::unique_ptr<AsyncRequest> req1 = fs.request(revalidation, [&](Response) {
+        order.push_back("revalidation");
+        req1.reset();
+        loop.stop();
+    });
+
+    std::unique_ptr<AsyncRequest> req2 = fs.request({ Resource::Unknown, "http://127.0.0.1:3000/load/2" }, [&](Response) {
+        order.push_back("missing");
+        req2.reset();
+    });
+
+    loop.run();
+
+    EXPECT_EQ((std::vector<std::string>{ "blocker", "missing", "revalidation" }), order);
+}
+
 TEST(OnlineFileSource, TEST_REQUIRES_SERVER(MaximumConcurrentRequests)) {
     util::RunLoop loop;
     OnlineFileSource fs;
@@ -169,6 +169,13 @@ app.get('/load/:number(\\d+)', function(req, res) {
     res.send('Request ' + req.params.number);
 });
 
+// Responds with the client port, so that tests can tell which requests shared a connection.
+app.get('/connection', function(req, res) {
+    setTimeout(function() {
+        res.status(200).send(String(req.socket.remotePort));
+    }, 50);
+});
+
 var server = app.listen(3000, function () {
     // Tell parent that we're now listening.
     process.stdout.write("OK");
@@ -0,0 +1,131 @@
+#include <mbgl/test/util.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/style/expression/compiled_expression.hpp>
+#include <mbgl/style/expression/parsing_context.hpp>
+#include <mbgl/style/conversion_impl.hpp>
+#include <mbgl/style/rapidjson_conversion.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+#include <cmath>
+
+using namespace mbgl;
+using namespace mbgl::style;
+using namespace mbgl::style::expression;
+
+namespace {
+
+std::shared_ptr<const Expression> parse(const std::string& json, type::Type expected) {
+    JSDocument document;
+    document.Parse<0>(json.c_str());
+    EXPECT_FALSE(document.HasParseError()) << json;
+    const JSValue* value = &document;
+    ParsingContext ctx(expected);
+    ParseResult parsed = ctx.parseExpression(conversion::Convertible(value));
+    EXPECT_TRUE(bool(parsed)) << json;
+    return parsed ? std::shared_ptr<const Expression>(std::move(*parsed)) : nullptr;
+}
+
+// Evaluates the compiled expression in each context and expects the same result as the
+// expression tree, including evaluation errors.
+void expectSameResults(const std::string& json, type::Type expected, const std::vector<EvaluationContext>& contexts) {
+    const auto expression = parse(json, expected);
+    ASSERT_TRUE(expression);
+    const auto compiled = CompiledExpression::compile(expression);
+    ASSERT_TRUE(compiled) << json;
+
+    for (const auto& context : contexts) {
+        const EvaluationResult result = expression->evaluate(context);
+        if (expected == type::Number) {
+            const optional<double> actual = compiled->evaluateNumber(context);
+            ASSERT_EQ(bool(result), bool(actual)) << json;
+            if (actual) {
+                const double value = result->get<double>();
+                if (std::isnan(value)) {
+                    EXPECT_TRUE(std::isnan(*actual)) << json;
+                } else {
+                    EXPECT_EQ(value, *actual) << json;
+                }
+            }
+        } else {
+            const optional<bool> actual = compiled->evaluateBoolean(context);
+            ASSERT_EQ(bool(result), bool(actual)) << json;
+            if (actual) {
+                EXPECT_EQ(result->get<bool>(), *actual) << json;
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST(CompiledExpression, Numbers) {
+    const StubGeometryTileFeature a(PropertyMap {
+        { "x", 5.5 }, { "y", int64_t(-3) }, { "s", std::string("12") }, { "b", true } });
+    const StubGeometryTileFeature b(PropertyMap {
+        { "x", uint64_t(20) }, { "s", std::string("foo") }, { "b", false } });
+    const StubGeometryTileFeature empty(PropertyMap {});
+
+    const std::vector<EvaluationContext> contexts {
+        EvaluationContext(0.0f, &a), EvaluationContext(7.5f, &a), EvaluationContext(21.0f, &b),
+        EvaluationContext(3.0f, &empty), EvaluationContext(&a), EvaluationContext(12.25f),
+    };
+
+    for (const char* json : {
+        R"(["+", ["number", ["get", "x"]], 1, ["zoom"]])",
+        R"(["-", ["*", 2, ["number", ["get", "y"]]], ["/", ["zoom"], 3]])",
+        R"(["-", ["to-number", ["get", "s"]]])",
+        R"(["max", ["%", ["to-number", ["get", "x"]], 3], ["^", 2, ["ln2"]], ["sqrt", ["zoom"]]])",
+        R"(["min", ["abs", ["to-number", ["get", "y"]]], ["floor", 2.5], ["round", ["zoom"]]])",
+        R"(["interpolate", ["linear"], ["zoom"], 0, 1, 10, ["number", ["get", "x"]], 20, 100])",
+        R"(["interpolate", ["exponential", 2], ["number", ["get", "x"]], 1, 1, 10, 10, 30, 5])",
+        R"(["interpolate", ["cubic-bezier", 0.4, 0, 0.6, 1], ["zoom"], 5, 0, 15, ["+", 1, ["zoom"]]])",
+        R"(["step", ["zoom"], 1, 5, 2, 10, ["number", ["get", "x"]]])",
+        R"(["case", ["has", "x"], ["number", ["get", "x"]], ["boolean", ["get", "b"]], 2, 3])",
+        R"(["coalesce", ["number", ["get", "x"]], 7])",
+        R"(["*", ["let", "v", ["number", ["get", "x"]], ["+", ["var", "v"], 1]], 2])",
+    }) {
+        expectSameResults(json, type::Number, contexts);
+    }
+}
+
+TEST(CompiledExpression, Booleans) {
+    const StubGeometryTileFeature a(PropertyMap {
+        { "class", std::string("street") }, { "rank", int64_t(3) }, { "oneway", true } });
+    const StubGeometryTileFeature b(PropertyMap {
+        { "class", std::string("path") }, { "rank", 12.0 }, { "oneway", false } });
+    const StubGeometryTileFeature empty(PropertyMap {});
+
+    const std::vector<EvaluationContext> contexts {
+        EvaluationContext(0.0f, &a), EvaluationContext(14.0f, &b), EvaluationContext(3.0f, &empty),
+        EvaluationContext(&b),
+    };
+
+    for (const char* json : {
+        R"(["==", ["get", "class"], "street"])",
+        R"(["!=", "path", ["get", "class"]])",
+        R"(["<", ["get", "rank"], 5])",
+        R"([">=", 5, ["get", "rank"]])",
+        R"(["<", ["get", "class"], "q"])",
+        R"(["==", ["get", "missing"], null])",
+        R"(["all", ["has", "class"], [">", ["number", ["get", "rank"]], ["zoom"]]])",
+        R"(["any", ["!", ["boolean", ["get", "oneway"]]], ["==", ["zoom"], 14]])",
+        R"(["step", ["zoom"], false, 10, true])",
+        R"(["filter-==", "class", "street"])",
+        R"(["filter-in", "rank", 3, 12])",
+        R"(["filter-has", "oneway"])",
+    }) {
+        expectSameResults(json, type::Boolean, contexts);
+    }
+}
+
+TEST(CompiledExpression, Folding) {
+    // Parts that depend on neither zoom nor feature are folded into constants.
+    const auto compiled = CompiledExpression::compile(parse(R"(["+", ["*", ["pi"], 2], ["sqrt", 16]])", type::Number));
+    ASSERT_TRUE(compiled);
+    EXPECT_DOUBLE_EQ(3.141592653589793 * 2 + 4, *compiled->evaluateNumber(EvaluationContext()));
+
+    // Expressions that would only be evaluated by the expression tree aren't compiled.
+    EXPECT_FALSE(CompiledExpression::compile(parse(R"(["length", ["to-string", ["get", "s"]]])", type::Number)));
+    EXPECT_FALSE(CompiledExpression::compile(parse(R"(["to-string", ["get", "s"]])", type::String)));
+}
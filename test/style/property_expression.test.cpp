@@ -110,6 +110,28 @@ TEST(PropertyExpression, ZoomInterpolation) {
     .evaluate(0.0f, oneInteger, -1.0f)) << "Should interpolate TO the first stop";
 }
 
+TEST(PropertyExpression, Columns) {
+    StubGeometryTileFeature two { PropertyMap {{ "property", 2.0 }} };
+    StubGeometryTileFeature empty { PropertyMap {} };
+    const std::vector<const GeometryTileFeature*> features { &oneInteger, &two, &oneString, &two, &empty, &oneDouble };
+
+    const auto expectSameAsEach = [&](const PropertyExpression<float>& expression, optional<float> zoom) {
+        const std::vector<float> column = expression.evaluate(zoom, features, -1.0f);
+        ASSERT_EQ(features.size(), column.size());
+        for (std::size_t i = 0; i < features.size(); ++i) {
+            EXPECT_EQ(expression.evaluate(EvaluationContext(zoom, features[i], nullopt), -1.0f), column[i]);
+        }
+    };
+
+    expectSameAsEach(PropertyExpression<float>(
+        interpolate(linear(), number(get("property")), 0.0, literal(10.0), 1.5, literal(20.0), 3.0, literal(40.0))), {});
+    expectSameAsEach(PropertyExpression<float>(
+        step(number(get("property")), literal(1.0), 2.0, literal(2.0))), {});
+    expectSameAsEach(PropertyExpression<float>(
+        interpolate(exponential(2.0), zoom(), 0.0, number(get("property")), 10.0, literal(100.0))), 3.0f);
+    expectSameAsEach(PropertyExpression<float>(number(get("property")), 5.0f), {});
+}
+
 TEST(PropertyExpression, Issue8460) {
     PropertyExpression<float> fn1(
         interpolate(linear(), zoom(),
@@ -6,6 +6,7 @@
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/sources/vector_source.hpp>
 #include <mbgl/style/layer.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
 #include <mbgl/style/layers/line_layer.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/run_loop.hpp>
@@ -103,3 +104,61 @@ TEST(Style, RemoveSourceInUse) {
 
     EXPECT_EQ(log->count(logMessage), 1u);
 }
+
+TEST(Style, LoadVariant) {
+    util::RunLoop loop;
+
+    StubFileSource fileSource;
+    Style::Impl style { fileSource, 1.0 };
+
+    const auto json = [](const std::string& url, const std::string& color) {
+        return R"({"version": 8, "sources": {"vector": {"type": "vector", "url": ")" + url + R"("}}, "layers": [)"
+               R"({"id": "water", "type": "fill", "source": "vector", "source-layer": "water", "paint": {"fill-color": ")" + color + R"("}},)"
+               R"({"id": "roads", "type": "line", "source": "vector", "source-layer": "roads", "paint": {"line-width": 2}}]})";
+    };
+
+    style.loadJSON(json("mapbox://mapbox.streets", "blue"));
+    const Source* source = style.getSource("vector");
+    const Immutable<Layer::Impl> roads = style.getLayer("roads")->baseImpl;
+
+    // Unchanged sources are kept, and unchanged layers keep their implementation.
+    style.loadJSON(json("mapbox://mapbox.streets", "red"));
+    EXPECT_EQ(source, style.getSource("vector"));
+    EXPECT_TRUE(roads == style.getLayer("roads")->baseImpl);
+    EXPECT_EQ(Color::red(), static_cast<FillLayer*>(style.getLayer("water"))->getFillColor().asConstant());
+
+    style.loadJSON(json("mapbox://mapbox.satellite", "red"));
+    EXPECT_EQ(std::string("mapbox://mapbox.satellite"), *static_cast<VectorSource*>(style.getSource("vector"))->getURL());
+    EXPECT_EQ(2u, style.getLayers().size());
+}
+
+TEST(Style, LoadVariantImages) {
+    util::RunLoop loop;
+
+    StubFileSource fileSource;
+    fileSource.spriteJSONResponse = [] (const Resource& resource) {
+        Response response;
+        response.data = std::make_unique<std::string>(util::read_file(resource.url));
+        return response;
+    };
+    fileSource.spriteImageResponse = fileSource.spriteJSONResponse;
+
+    Style::Impl style { fileSource, 1.0 };
+
+    const auto json = [](const std::string& color) {
+        return R"({"version": 8, "sprite": "test/fixtures/resources/sprite", "sources": {}, "layers": [)"
+               R"({"id": "background", "type": "background", "paint": {"background-color": ")" + color + R"("}}]})";
+    };
+
+    style.loadJSON(json("blue"));
+    while (!style.spriteLoaded) {
+        loop.runOnce();
+    }
+    style.addImage(std::make_unique<Image>("annotation", PremultipliedImage({ 1, 1 }), 1.0));
+
+    // The sprite is kept, while images added for the previous style are dropped.
+    style.loadJSON(json("red"));
+    EXPECT_TRUE(style.spriteLoaded);
+    EXPECT_NE(nullptr, style.getImage("pedestrian-polygon"));
+    EXPECT_EQ(nullptr, style.getImage("annotation"));
+}
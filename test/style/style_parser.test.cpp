@@ -203,3 +203,34 @@ TEST(StyleParser, FontStacksGetExpression) {
     auto result = parser.fontStacks();
     ASSERT_EQ(0u, result.size());
 }
+
+TEST(StyleParser, Cache) {
+    const auto style = [](const std::string& color) {
+        return R"({"version": 8, "sources": {"vector": {"type": "vector", "url": "mapbox://mapbox.streets"}}, "layers": [)"
+               R"({"id": "water", "type": "fill", "source": "vector", "source-layer": "water", "paint": {"fill-color": ")" + color + R"("}},)"
+               R"({"id": "roads", "type": "line", "source": "vector", "source-layer": "roads",)"
+               R"( "paint": {"line-width": ["interpolate", ["linear"], ["zoom"], 5, 1, 15, 4]}}]})";
+    };
+
+    style::Parser first;
+    ASSERT_FALSE(first.parse(style("blue")));
+    style::Parser second;
+    ASSERT_FALSE(second.parse(style("blue")));
+
+    // Parsing a style again yields new layers sharing the implementation of the previous ones, and new sources.
+    ASSERT_EQ(2u, second.layers.size());
+    EXPECT_TRUE(first.layers[0]->baseImpl == second.layers[0]->baseImpl);
+    EXPECT_TRUE(first.layers[1]->baseImpl == second.layers[1]->baseImpl);
+    EXPECT_NE(first.layers[0].get(), second.layers[0].get());
+    ASSERT_EQ(1u, second.sources.size());
+    EXPECT_EQ("vector", second.sources[0]->getID());
+    EXPECT_NE(first.sources[0].get(), second.sources[0].get());
+    EXPECT_EQ(first.sourceDefinitions, second.sourceDefinitions);
+
+    // A variant of the style shares the layers it has in common with it.
+    style::Parser variant;
+    ASSERT_FALSE(variant.parse(style("red")));
+    ASSERT_EQ(2u, variant.layers.size());
+    EXPECT_FALSE(first.layers[0]->baseImpl == variant.layers[0]->baseImpl);
+    EXPECT_TRUE(first.layers[1]->baseImpl == variant.layers[1]->baseImpl);
+}
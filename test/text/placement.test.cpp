@@ -0,0 +1,272 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/map/transform.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/renderer/render_tile.hpp>
+#include <mbgl/renderer/tile_render_data.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/style/layers/symbol_layer_impl.hpp>
+#include <mbgl/style/layers/symbol_layer_properties.hpp>
+#include <mbgl/text/placement.hpp>
+#include <mbgl/tile/tile.hpp>
+#include <mbgl/util/mat4.hpp>
+
+#include <algorithm>
+#include <memory>
+
+using namespace mbgl;
+
+namespace {
+
+class StubTile : public Tile {
+public:
+    StubTile(const OverscaledTileID& id_) : Tile(Kind::Geometry, id_) {}
+
+    std::unique_ptr<TileRenderData> createRenderData() override { return nullptr; }
+    bool layerPropertiesUpdated(const Immutable<style::LayerProperties>&) override { return false; }
+};
+
+// Records the order in which buckets are placed.
+class StubBucket : public Bucket {
+public:
+    StubBucket(std::vector<const Bucket*>& placed_) : placed(placed_) {}
+
+    void upload(gfx::UploadPass&) override {}
+    bool hasData() const override { return true; }
+    void place(Placement&, const BucketPlacementParameters&, std::set<uint32_t>&) override {
+        placed.push_back(this);
+    }
+
+    std::vector<const Bucket*>& placed;
+};
+
+class StubRenderLayer : public RenderLayer {
+public:
+    StubRenderLayer(const std::string& id)
+        : RenderLayer(makeMutable<style::SymbolLayerProperties>(
+              staticImmutableCast<style::SymbolLayer::Impl>(style::SymbolLayer(id, "source").baseImpl))) {
+    }
+
+    void transition(const TransitionParameters&) override {}
+    void evaluate(const PropertyEvaluationParameters&) override {}
+    bool hasTransition() const override { return false; }
+    bool hasCrossfade() const override { return false; }
+    void render(PaintParameters&) override {}
+
+    void setBuckets(const std::vector<std::pair<Bucket*, const RenderTile*>>& buckets) {
+        placementData.clear();
+        for (const auto& bucket : buckets) {
+            placementData.push_back({ *bucket.first, *bucket.second, nullptr });
+        }
+    }
+};
+
+class PlacementTest {
+public:
+    PlacementTest() {
+        transform.resize({ 512, 512 });
+        transform.jumpTo(CameraOptions().withCenter(LatLng {}).withZoom(1.0));
+        matrix::identity(projMatrix);
+        for (const OverscaledTileID& id : { OverscaledTileID(1, 0, 0), OverscaledTileID(1, 1, 0), OverscaledTileID(1, 0, 1) }) {
+            tiles.push_back(std::make_unique<StubTile>(id));
+            renderTiles.push_back(std::make_unique<RenderTile>(id.toUnwrapped(), *tiles.back()));
+        }
+        for (std::size_t i = 0; i < 6; ++i) {
+            buckets.push_back(std::make_unique<StubBucket>(placed));
+        }
+        bottom.setBuckets({ bucket(0, 0), bucket(1, 1), bucket(2, 2) });
+        top.setBuckets({ bucket(3, 0), bucket(4, 1), bucket(5, 2) });
+    }
+
+    std::pair<Bucket*, const RenderTile*> bucket(std::size_t bucketIndex, std::size_t tileIndex) const {
+        return { buckets[bucketIndex].get(), renderTiles[tileIndex].get() };
+    }
+
+    std::unique_ptr<PauseablePlacement> startPlacement() {
+        return std::make_unique<PauseablePlacement>(
+            transform.getState(), MapMode::Continuous, transitionOptions, crossSourceCollisions,
+            std::make_shared<Placement>(TransformState {}, MapMode::Continuous, transitionOptions, crossSourceCollisions),
+            layers, projMatrix, false);
+    }
+
+    std::shared_ptr<Placement> place() {
+        auto placement = startPlacement();
+        placement->continuePlacement(layers, nullopt);
+        return placement->commit(Clock::now());
+    }
+
+    bool canContinue(const PauseablePlacement& placement, bool showCollisionBoxes = false) const {
+        return placement.canContinue(transitionOptions, crossSourceCollisions, layers, showCollisionBoxes);
+    }
+
+    bool canBeReused(const Placement& placement) const {
+        return placement.canBeReused(transform.getState(), transitionOptions, crossSourceCollisions, layers, false);
+    }
+
+    // Placement pauses after every bucket once the deadline has passed.
+    static optional<TimePoint> pastDeadline() {
+        return Clock::now() - Seconds(1);
+    }
+
+    Transform transform;
+    style::TransitionOptions transitionOptions;
+    bool crossSourceCollisions = true;
+    mat4 projMatrix;
+    std::vector<const Bucket*> placed;
+    std::vector<std::unique_ptr<StubTile>> tiles;
+    std::vector<std::unique_ptr<RenderTile>> renderTiles;
+    std::vector<std::unique_ptr<StubBucket>> buckets;
+    StubRenderLayer bottom { "bottom" };
+    StubRenderLayer top { "top" };
+    const PauseablePlacement::Layers layers { bottom, top };
+};
+
+} // namespace
+
+TEST(PauseablePlacement, SpreadOverFrames) {
+    PlacementTest test;
+    auto placement = test.startPlacement();
+
+    for (std::size_t frame = 1; frame <= 6; ++frame) {
+        ASSERT_FALSE(placement->isDone());
+        EXPECT_TRUE(test.canContinue(*placement));
+        placement->continuePlacement(test.layers, PlacementTest::pastDeadline());
+        EXPECT_EQ(frame, test.placed.size());
+    }
+    EXPECT_TRUE(placement->isDone());
+
+    // The top-most layer is placed first.
+    const std::vector<const Bucket*> expected { test.buckets[3].get(), test.buckets[4].get(), test.buckets[5].get(),
+                                                test.buckets[0].get(), test.buckets[1].get(), test.buckets[2].get() };
+    EXPECT_EQ(expected, test.placed);
+}
+
+TEST(PauseablePlacement, ResumeWithReorderedBuckets) {
+    PlacementTest test;
+    auto placement = test.startPlacement();
+
+    placement->continuePlacement(test.layers, PlacementTest::pastDeadline());
+    placement->continuePlacement(test.layers, PlacementTest::pastDeadline());
+    ASSERT_EQ(2u, test.placed.size());
+
+    // Placement data is collected anew for every frame, possibly in another order.
+    test.top.setBuckets({ test.bucket(5, 2), test.bucket(4, 1), test.bucket(3, 0) });
+    EXPECT_TRUE(test.canContinue(*placement));
+
+    placement->continuePlacement(test.layers, nullopt);
+    EXPECT_TRUE(placement->isDone());
+
+    // Every bucket is placed exactly once.
+    ASSERT_EQ(6u, test.placed.size());
+    for (const auto& bucket : test.buckets) {
+        EXPECT_EQ(1, std::count(test.placed.begin(), test.placed.end(), bucket.get()));
+    }
+}
+
+TEST(PauseablePlacement, TileChange) {
+    PlacementTest test;
+    auto placement = test.startPlacement();
+    placement->continuePlacement(test.layers, PlacementTest::pastDeadline());
+    ASSERT_EQ(1u, test.placed.size());
+
+    // Both a placed tile and a tile not placed yet were reloaded, a tile was unloaded, and
+    // another one was loaded.
+    StubBucket replaced(test.placed);
+    StubBucket reloaded(test.placed);
+    StubBucket loaded(test.placed);
+    StubTile tile(OverscaledTileID(1, 1, 1));
+    RenderTile renderTile(tile.id.toUnwrapped(), tile);
+    test.top.setBuckets({ { &replaced, test.renderTiles[0].get() }, { &reloaded, test.renderTiles[1].get() },
+                          { &loaded, &renderTile } });
+    EXPECT_TRUE(test.canContinue(*placement));
+
+    // Placement goes on with the buckets of the tiles not placed yet.
+    placement->continuePlacement(test.layers, nullopt);
+    EXPECT_TRUE(placement->isDone());
+    const std::vector<const Bucket*> expected { test.buckets[3].get(), &reloaded, &loaded,
+                                                test.buckets[0].get(), test.buckets[1].get(), test.buckets[2].get() };
+    EXPECT_EQ(expected, test.placed);
+}
+
+TEST(PauseablePlacement, LayerChange) {
+    PlacementTest test;
+    auto placement = test.startPlacement();
+    placement->continuePlacement(test.layers, PlacementTest::pastDeadline());
+
+    const PauseablePlacement::Layers reordered { test.top, test.bottom };
+    EXPECT_FALSE(placement->canContinue(test.transitionOptions, test.crossSourceCollisions, reordered, false));
+
+    const PauseablePlacement::Layers removed { test.bottom };
+    EXPECT_FALSE(placement->canContinue(test.transitionOptions, test.crossSourceCollisions, removed, false));
+}
+
+TEST(PauseablePlacement, CameraChange) {
+    PlacementTest test;
+    const LatLng center = test.transform.getLatLng();
+    auto placement = test.startPlacement();
+    placement->continuePlacement(test.layers, PlacementTest::pastDeadline());
+
+    // Collision boxes were turned on.
+    EXPECT_FALSE(test.canContinue(*placement, true));
+
+    // Placement goes on for the view it was started for, and the next one catches up.
+    test.transform.moveBy({ 10, 0 });
+    EXPECT_TRUE(test.canContinue(*placement));
+    placement->continuePlacement(test.layers, nullopt);
+    const auto committed = placement->commit(Clock::now());
+    EXPECT_EQ(center, committed->getCollisionIndex().getTransformState().getLatLng());
+    EXPECT_FALSE(test.canBeReused(*committed));
+}
+
+TEST(PauseablePlacement, OptionsChange) {
+    PlacementTest test;
+    auto placement = test.startPlacement();
+    placement->continuePlacement(test.layers, PlacementTest::pastDeadline());
+
+    test.crossSourceCollisions = false;
+    EXPECT_FALSE(test.canContinue(*placement));
+
+    test.crossSourceCollisions = true;
+    test.transitionOptions.enablePlacementTransitions = false;
+    EXPECT_FALSE(test.canContinue(*placement));
+}
+
+TEST(Placement, ReuseAfterSubPixelPan) {
+    PlacementTest test;
+    const auto placement = test.place();
+    EXPECT_TRUE(test.canBeReused(*placement));
+
+    // Placing symbols again would yield the same result.
+    test.transform.moveBy({ 0.3, 0 });
+    EXPECT_TRUE(test.canBeReused(*placement));
+
+    // Symbols moved by more than half a pixel since they were placed.
+    test.transform.moveBy({ 0.3, 0 });
+    EXPECT_FALSE(test.canBeReused(*placement));
+}
+
+TEST(Placement, ReuseAfterResize) {
+    PlacementTest test;
+    const auto placement = test.place();
+
+    test.transform.resize({ 512, 256 });
+    EXPECT_FALSE(test.canBeReused(*placement));
+}
+
+TEST(Placement, ReuseAfterOptionsChange) {
+    PlacementTest test;
+    const auto placement = test.place();
+
+    test.crossSourceCollisions = false;
+    EXPECT_FALSE(test.canBeReused(*placement));
+    test.crossSourceCollisions = true;
+
+    test.transitionOptions.duration = Duration(Milliseconds(100));
+    EXPECT_FALSE(test.canBeReused(*placement));
+
+    // Placement doesn't depend on the delay of transitions.
+    test.transitionOptions.duration = nullopt;
+    test.transitionOptions.delay = Duration(Milliseconds(100));
+    EXPECT_TRUE(test.canBeReused(*placement));
+}
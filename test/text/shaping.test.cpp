@@ -92,4 +92,17 @@ TEST(Shaping, ZWSP) {
         ASSERT_EQ(shaping.right, 0);
         ASSERT_EQ(shaping.writingMode, WritingModeType::Horizontal);
     }
+
+    // 6 lines of 5 ideographs each: every ideograph is a break opportunity, and the lines are
+    // balanced across the whole text.
+    {
+        TaggedString string(std::u16string(30, u'中'), sectionOptions);
+        auto shaping = testGetShaping(string, 5);
+        ASSERT_EQ(shaping.lineCount, 6);
+        ASSERT_EQ(shaping.top, -72);
+        ASSERT_EQ(shaping.bottom, 72);
+        ASSERT_EQ(shaping.left, -52.5);
+        ASSERT_EQ(shaping.right, 52.5);
+        ASSERT_EQ(shaping.writingMode, WritingModeType::Horizontal);
+    }
 }
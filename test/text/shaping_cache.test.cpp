@@ -0,0 +1,75 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/bidi.hpp>
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/util/constants.hpp>
+
+using namespace mbgl;
+using namespace util;
+
+namespace {
+
+GlyphMap glyphMap(const FontStack& fontStack, const std::u16string& characters, uint32_t advance) {
+    Glyphs glyphs;
+    for (char16_t character : characters) {
+        Glyph glyph;
+        glyph.id = character;
+        glyph.metrics.width = advance;
+        glyph.metrics.height = 18;
+        glyph.metrics.advance = advance;
+        glyphs.emplace(character, Immutable<Glyph>(makeMutable<Glyph>(std::move(glyph))));
+    }
+    return {{ FontStackHasher()(fontStack), std::move(glyphs) }};
+}
+
+} // namespace
+
+TEST(ShapingCache, Reuse) {
+    BiDi bidi;
+    ShapingCache cache(2);
+    const FontStack fontStack {{ "font-stack" }};
+    const GlyphMap glyphs = glyphMap(fontStack, u"abc ", 10);
+
+    const auto shape = [&](const TaggedString& string, float maxWidth, const GlyphMap& map) {
+        return cache.getShaping(string, maxWidth, ONE_EM, style::SymbolAnchorType::Center, style::TextJustifyType::Center,
+                                0, { 0.0f, 0.0f }, WritingModeType::Horizontal, bidi, map);
+    };
+    const auto expectSameAsUncached = [&](const Shaping& shaping, const TaggedString& string, float maxWidth, const GlyphMap& map) {
+        const Shaping expected = getShaping(string, maxWidth, ONE_EM, style::SymbolAnchorType::Center, style::TextJustifyType::Center,
+                                            0, { 0.0f, 0.0f }, WritingModeType::Horizontal, bidi, map);
+        EXPECT_EQ(expected.lineCount, shaping.lineCount);
+        EXPECT_EQ(expected.left, shaping.left);
+        EXPECT_EQ(expected.right, shaping.right);
+        EXPECT_EQ(expected.top, shaping.top);
+        EXPECT_EQ(expected.bottom, shaping.bottom);
+        ASSERT_EQ(expected.positionedGlyphs.size(), shaping.positionedGlyphs.size());
+        for (std::size_t i = 0; i < expected.positionedGlyphs.size(); ++i) {
+            EXPECT_EQ(expected.positionedGlyphs[i].glyph, shaping.positionedGlyphs[i].glyph);
+            EXPECT_EQ(expected.positionedGlyphs[i].x, shaping.positionedGlyphs[i].x);
+            EXPECT_EQ(expected.positionedGlyphs[i].y, shaping.positionedGlyphs[i].y);
+        }
+    };
+
+    const TaggedString text(u"abc abc", SectionOptions(1.0, fontStack));
+    expectSameAsUncached(shape(text, 10 * ONE_EM, glyphs), text, 10 * ONE_EM, glyphs);
+    EXPECT_EQ(1u, cache.size());
+    expectSameAsUncached(shape(text, 10 * ONE_EM, glyphs), text, 10 * ONE_EM, glyphs);
+    EXPECT_EQ(1u, cache.size());
+
+    // Other shaping parameters yield another shaping.
+    expectSameAsUncached(shape(text, 1 * ONE_EM, glyphs), text, 1 * ONE_EM, glyphs);
+    EXPECT_EQ(2u, cache.size());
+
+    // Cached shapings aren't reused with different glyphs.
+    const GlyphMap wider = glyphMap(fontStack, u"abc ", 20);
+    expectSameAsUncached(shape(text, 10 * ONE_EM, wider), text, 10 * ONE_EM, wider);
+    EXPECT_EQ(2u, cache.size());
+
+    // The least recently used shaping is evicted.
+    const TaggedString other(u"cab", SectionOptions(1.0, fontStack));
+    expectSameAsUncached(shape(other, 10 * ONE_EM, glyphs), other, 10 * ONE_EM, glyphs);
+    EXPECT_EQ(2u, cache.size());
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.size());
+}
@@ -51,3 +51,29 @@ TEST(GridIndex, CircleBox) {
     EXPECT_EQ(grid.query({{0, 80}, {20, 100}}), (std::vector<int16_t>{2}));
 }
 
+
+TEST(GridIndex, ElementsSpanningManyCells) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    grid.insert(0, {{-50, -50}, {55, 55}});
+    grid.insert(1, {{50, 50}, 30});
+    grid.insert(2, {{95, 5}, {150, 95}});
+
+    // Every element is reported once, even though it is registered in many of the queried cells.
+    EXPECT_EQ(grid.query({{1, 1}, {99, 99}}), (std::vector<int16_t>{0, 1, 2}));
+    EXPECT_EQ(grid.query({{40, 40}, {60, 60}}), (std::vector<int16_t>{0, 1}));
+    EXPECT_EQ(grid.query({{90, 0}, {99, 10}}), (std::vector<int16_t>{2}));
+    EXPECT_TRUE(grid.hitTest({{70, 30}, 5}));
+    EXPECT_FALSE(grid.hitTest({{20, 90}, 5}));
+}
+
+TEST(GridIndex, Predicate) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    grid.insert(0, {{10, 10}, {20, 20}});
+    grid.insert(1, {{50, 50}, 10});
+
+    const auto isOne = [](int16_t key) { return key == 1; };
+    EXPECT_FALSE(grid.hitTest(GridIndex<int16_t>::BBox {{15, 15}, {16, 16}}, isOne));
+    EXPECT_TRUE(grid.hitTest(GridIndex<int16_t>::BBox {{45, 45}, {46, 46}}, isOne));
+    EXPECT_FALSE(grid.hitTest(GridIndex<int16_t>::BCircle {{15, 15}, 2}, isOne));
+    EXPECT_TRUE(grid.hitTest(GridIndex<int16_t>::BCircle {{55, 55}, 2}, isOne));
+}